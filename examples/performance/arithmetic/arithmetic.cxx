@@ -6,12 +6,14 @@
 #include <bout/physicsmodel.hxx>
 
 #include <bout/expr.hxx>
+#include <bout/field_expr.hxx>
 
 #include <chrono>
 
 using SteadyClock = std::chrono::time_point<std::chrono::steady_clock>;
 using Duration = std::chrono::duration<double>;
 using namespace std::chrono;
+using bout::expr::lazy;
 
 #define TIMEIT(elapsed, ...)                                                             \
   {                                                                                      \
@@ -41,14 +43,14 @@ protected:
     Field3D b = 2.0;
     Field3D c = 3.0;
 
-    Field3D result1, result2, result3, result4;
+    Field3D result1, result2, result3, result4, result5;
 
     // Using Field methods (classic operator overloading)
 
     result1 = 2. * a + b * c;
 #define dur_init {Duration::min(), Duration::max(), Duration::zero(), 0}
     Durations elapsed1 = dur_init, elapsed2 = dur_init, elapsed3 = dur_init,
-              elapsed4 = dur_init;
+              elapsed4 = dur_init, elapsed5 = dur_init;
 
     for (int ik = 0; ik < 1e2; ++ik) {
       TIMEIT(elapsed1, result1 = 2. * a + b * c;);
@@ -72,6 +74,9 @@ protected:
       // Template expressions
       TIMEIT(elapsed3, result3 = eval3D(add(mul(2, a), mul(b, c))););
 
+      // Lazy field expressions
+      TIMEIT(elapsed5, result5 = 2. * lazy(a) + lazy(b) * c;);
+
       // Range iterator
       result4.allocate();
       TIMEIT(elapsed4, for (auto i : result4) result4[i] = 2. * a[i] + b[i] * c[i];);
@@ -88,6 +93,7 @@ protected:
     PRINT("C loop:    ", elapsed2);
     PRINT("Templates: ", elapsed3);
     PRINT("Range For: ", elapsed4);
+    PRINT("Lazy:      ", elapsed5);
     output.disable();
     SOLVE_FOR(n);
     return 0;
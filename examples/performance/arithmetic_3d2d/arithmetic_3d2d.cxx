@@ -6,6 +6,7 @@
 #include <bout/physicsmodel.hxx>
 
 #include <bout/expr.hxx>
+#include <bout/field_expr.hxx>
 
 #include <chrono>
 #include <iomanip>
@@ -13,6 +14,7 @@
 using SteadyClock = std::chrono::time_point<std::chrono::steady_clock>;
 using Duration = std::chrono::duration<double>;
 using namespace std::chrono;
+using bout::expr::lazy;
 
 #define TIMEIT(NAME, ...)                                                             \
   {                                                                                      \
@@ -44,7 +46,7 @@ protected:
     Field3D b = 2.0;
     Field2D c = 3.0;
 
-    Field3D result1, result2, result3, result4;
+    Field3D result1, result2, result3, result4, result5;
 
     // Using Field methods (classic operator overloading)
     result1 = 2. * a + b * c;
@@ -75,6 +77,10 @@ protected:
       result3.allocate();
       TIMEIT("Templates", result3 = eval3D(add(mul(2, a), mul(b, c))););
 
+      // Lazy field expressions
+      result5.allocate();
+      TIMEIT("Lazy", result5 = 2. * lazy(a) + lazy(b) * c;);
+
       // Range iterator
       result4.allocate();
       TIMEIT("Range For", for (auto i : result4) result4[i] = 2. * a[i] + b[i] * c[i];);
@@ -66,6 +66,17 @@ int main(int argc, char **argv) {
     blocksize *= 2;
   }
 
+  // Time a stencil in x, visiting y in tiles of different sizes
+  const auto& noBndry = mesh->getRegion3D("RGN_NOBNDRY");
+  ITERATOR_TEST_BLOCK("x stencil, not tiled",
+                      BOUT_FOR(i, noBndry) { result[i] = a[i.xp()] - a[i.xm()]; });
+  for (int tiley = 1; tiley <= mesh->LocalNy; tiley *= 2) {
+    std::string name = "x stencil, tile y : " + std::to_string(tiley);
+    auto region = noBndry.asTiled(tiley);
+
+    ITERATOR_TEST_BLOCK(name, BOUT_FOR(i, region) { result[i] = a[i.xp()] - a[i.xm()]; });
+  }
+
   // Report
   int width = 0;
   for (const auto i : names) {
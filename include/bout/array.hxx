@@ -8,6 +8,12 @@
  * arrays are released they are put into a store. Rather
  * than allocating memory, objects are retrieved from the
  * store. This minimises new and delete operations.
+ *
+ * The store is kept per OpenMP thread, so needs no locks. Blocks
+ * released on one thread can be handed back to the master thread by
+ * an Array::Scope, which is used around each call to the physics
+ * model's RHS. Counters of allocations and memory use are available
+ * from Array::getStats.
  * 
  * 
  * Ben Dudson, University of York, 2015
@@ -26,6 +32,8 @@
 #define __ARRAY_H__
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <map>
 #include <vector>
 #include <memory>
@@ -44,22 +52,59 @@ template <typename T>
 using const_iterator = const T*;
 }
 
+/// Counters of the blocks of memory used by all Arrays of one type
+struct ArrayStats {
+  std::size_t requests{0};    ///< Number of blocks requested, from the store or not
+  std::size_t allocations{0}; ///< Number of blocks newly allocated
+  std::size_t bytes{0};       ///< Bytes allocated and not yet freed, whether in use or in the store
+  std::size_t scopes{0};      ///< Number of (outermost) Array::Scopes completed
+  std::size_t scope_requests{0};    ///< Requests made inside Scopes
+  std::size_t scope_allocations{0}; ///< Allocations made inside Scopes
+};
+
 /*!
  * ArrayData holds the actual data
  * Handles the allocation and deletion of data
  */
 template <typename T>
 struct ArrayData {
-  ArrayData(int size) : len(size) { data = new T[len]; }
-  ~ArrayData() { delete[] data; }
+  ArrayData(int size) : len(size) {
+    data = new T[len];
+#ifdef _OPENMP
+    // Memory pages are placed close to the thread which first writes
+    // to them, so initialise large blocks with the same static
+    // schedule BOUT_FOR uses by default. This is only done for new
+    // blocks, which are then reused through the store
+    if (static_cast<std::size_t>(len) * sizeof(T) >= first_touch_bytes
+        and omp_get_max_threads() > 1 and omp_in_parallel() == 0) {
+      BOUT_OMP(parallel for schedule(static))
+      for (int i = 0; i < len; ++i) {
+        data[i] = T{};
+      }
+    }
+#endif
+  }
+  /// Use existing memory at \p external, which is not deleted
+  ArrayData(T* external, int size) : len(size), data(external), owner(false) {}
+  ~ArrayData() {
+    if (owner) {
+      delete[] data;
+    }
+  }
   iterator<T> begin() const { return data; }
   iterator<T> end() const { return data + len; }
   int size() const { return len; }
   void operator=(ArrayData<T>& in) { std::copy(std::begin(in), std::end(in), begin()); }
   T& operator[](int ind) { return data[ind]; };
+  /// Was the data allocated by this object?
+  bool isOwner() const { return owner; }
 private:
   int len; ///< Size of the array
   T* data; ///< Array of data  
+  bool owner{true}; ///< Delete data when destroyed?
+
+  /// Smallest block which is initialised in parallel
+  static constexpr std::size_t first_touch_bytes = 64 * 1024;
 };
 
 /*!
@@ -145,6 +190,18 @@ public:
     swap(*this, other);
   }
 
+  /*!
+   * Create an Array which uses the \p len elements of existing memory
+   * starting at \p data, rather than allocating its own. The memory
+   * is not deleted, so must outlive this Array and any copies of it.
+   * Views are never put into the store
+   */
+  static Array view(T* data, size_type len) {
+    Array result;
+    result.ptr = std::make_shared<dataBlock>(data, len);
+    return result;
+  }
+
   /*!
    * Reallocate the array with size = \p new_size
    *
@@ -195,6 +252,86 @@ public:
     useStore(false);
   }
 
+  /*!
+   * Counters of the memory used by all Arrays of this type, summed
+   * over threads. Should be called outside of OpenMP parallel regions
+   */
+  static ArrayStats getStats() {
+    ArrayStats result = scopeStats();
+    std::size_t freed = 0;
+    for (const auto& thread : arena()) {
+      result.requests += thread.stats.requests;
+      result.allocations += thread.stats.allocations;
+      result.bytes += thread.stats.bytes;
+      freed += thread.freed_bytes;
+    }
+    // Blocks allocated before a cleanup() may be freed after it
+    result.bytes = result.bytes > freed ? result.bytes - freed : 0;
+    return result;
+  }
+
+  /*!
+   * Marks a section of code which creates and releases many
+   * temporary Arrays, such as one evaluation of the RHS function.
+   * The requests and allocations made inside the outermost Scope are
+   * counted separately in getStats, to see how many temporaries
+   * each section makes.
+   *
+   * Blocks released inside parallel regions go to the store of the
+   * thread which released them, and would otherwise only be reused
+   * by that thread. When a Scope starts, the master thread takes
+   * blocks from the other threads' stores for the sizes it has had
+   * to allocate since the last Scope.
+   *
+   * Scopes do nothing if created inside a parallel region
+   */
+  class Scope {
+  public:
+    Scope() : active(isOutermost()) {
+      if (not active) {
+        return;
+      }
+      ++depth();
+      gatherStores();
+      const auto stats = getStats();
+      start_requests = stats.requests;
+      start_allocations = stats.allocations;
+    }
+    ~Scope() {
+      if (not active) {
+        return;
+      }
+      --depth();
+      const auto stats = getStats();
+      auto& totals = scopeStats();
+      ++totals.scopes;
+      totals.scope_requests += stats.requests - start_requests;
+      totals.scope_allocations += stats.allocations - start_allocations;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const bool active;
+    std::size_t start_requests{0};
+    std::size_t start_allocations{0};
+
+    static bool isOutermost() {
+#ifdef _OPENMP
+      if (omp_in_parallel() != 0) {
+        return false;
+      }
+#endif
+      return depth() == 0;
+    }
+
+    static int& depth() {
+      static int value = 0;
+      return value;
+    }
+  };
+
   /*!
    * Returns true if the Array is empty
    */
@@ -295,10 +432,87 @@ private:
   dataPtrType ptr;
 
   using storeType = std::map<size_type, std::vector<dataPtrType>>;
-  using arenaType = std::vector<storeType>;
+  using bucketType = std::vector<dataPtrType>;
+
+  /// Number of recently used sizes remembered by each thread
+  static constexpr int n_recent = 4;
+
+  /// The store and counters for one thread
+  struct threadStore {
+    storeType blocks;
+    /// The most recently used entries of blocks, most recent first,
+    /// to avoid searching the map for the few sizes used by fields.
+    /// Elements of a std::map are never moved, so these stay valid
+    /// until the store is cleaned up
+    std::array<std::pair<size_type, bucketType*>, n_recent> recent{};
+    /// Number of blocks of each size allocated since the last Scope
+    /// started. Only used for the master thread
+    std::map<size_type, std::size_t> misses;
+    ArrayStats stats;
+    /// Bytes freed by this thread when not using the store. Kept
+    /// apart from stats.bytes, as a block may be freed by a
+    /// different thread to the one which allocated it
+    std::size_t freed_bytes{0};
+  };
+  using arenaType = std::vector<threadStore>;
+
+  static arenaType& arena() {
+#ifdef _OPENMP
+    static arenaType value(omp_get_max_threads());
+#else
+    static arenaType value(1);
+#endif
+    return value;
+  }
+
+  /// Counters for Scopes, which are only changed outside of parallel regions
+  static ArrayStats& scopeStats() {
+    static ArrayStats value;
+    return value;
+  }
+
+  /// The store of blocks of size \p len for \p thread
+  static bucketType& bucket(threadStore& thread, size_type len) {
+    for (auto& recent : thread.recent) {
+      if (recent.second != nullptr and recent.first == len) {
+        return *recent.second;
+      }
+    }
+    auto& result = thread.blocks[len];
+    std::copy_backward(thread.recent.begin(), thread.recent.end() - 1,
+                       thread.recent.end());
+    thread.recent.front() = {len, &result};
+    return result;
+  }
+
+  /// Move blocks from the stores of the other threads into the master
+  /// thread's store, up to the number the master has had to allocate
+  static void gatherStores() {
+    auto& threads = arena();
+    auto& master = threads.front();
+    for (const auto& missed : master.misses) {
+      auto wanted = missed.second;
+      auto& to = bucket(master, missed.first);
+      for (auto other = threads.begin() + 1; other != threads.end() and wanted > 0;
+           ++other) {
+        const auto found = other->blocks.find(missed.first);
+        if (found == other->blocks.end()) {
+          continue;
+        }
+        auto& from = found->second;
+        while (not from.empty() and wanted > 0) {
+          to.push_back(std::move(from.back()));
+          from.pop_back();
+          --wanted;
+        }
+      }
+    }
+    master.misses.clear();
+  }
 
   /*!
-   * This maps from array size (size_type) to vectors of pointers to dataBlock objects
+   * The store of the current thread. This maps from array size
+   * (size_type) to vectors of pointers to dataBlock objects
    *
    * By putting the static store inside a function it is initialised on first use,
    * and doesn't need to be separately declared for each type T
@@ -308,43 +522,30 @@ private:
    *
    * @param[in] cleanup   If set to true, deletes all dataBlock and clears the store
    */
-  static storeType& store(bool cleanup=false) {
-#ifdef _OPENMP    
-    static arenaType arena(omp_get_max_threads());
-#else
-    static arenaType arena(1);
-#endif
-    
+  static threadStore& store(bool cleanup=false) {
+    auto& threads = arena();
+
     if (!cleanup) {
 #ifdef _OPENMP 
-      return arena[omp_get_thread_num()];
+      return threads[omp_get_thread_num()];
 #else
-      return arena[0];
+      return threads[0];
 #endif
     }
 
-    // Clean by deleting all data -- possible that just stores.clear() is
-    // sufficient rather than looping over each entry.
+    // Clean by deleting all data
     BOUT_OMP(single)
     {
-      for (auto &stores : arena) {
-        for (auto &p : stores) {
-          auto &v = p.second;
-          for (dataPtrType a : v) {
-            a.reset();
-          }
-          v.clear();
-        }
-        stores.clear();
-      }
-      // Here we ensure there is exactly one empty map still
+      // Here we ensure there is exactly one empty store still
       // left in the arena as we have to return one such item
-      arena.resize(1);
+      threads.clear();
+      threads.resize(1);
+      scopeStats() = ArrayStats{};
     }
 
     //Store should now be empty but we need to return something,
-    //so return an empty storeType from the arena.
-    return arena[0];
+    //so return an empty threadStore from the arena.
+    return threads[0];
   }
   
   /*!
@@ -358,10 +559,12 @@ private:
 
     dataPtrType p;
 
-    auto& st = store()[len];
+    auto& thread = store();
+    auto& st = bucket(thread, len);
+    ++thread.stats.requests;
     
     if (!st.empty()) {
-      p = st.back();
+      p = std::move(st.back());
       st.pop_back();
     } else {
       // Ensure that when we release the data block later we'll have
@@ -369,11 +572,37 @@ private:
       // noexcept
       st.reserve(1);
       p = std::make_shared<dataBlock>(len);
+      ++thread.stats.allocations;
+      thread.stats.bytes += static_cast<std::size_t>(len) * sizeof(T);
+      if (&thread == &arena().front()) {
+        ++thread.misses[len];
+      }
     }
 
     return p;
   }
 
+  /// Count \p bytes freed by the current thread. After cleanup() the
+  /// arena only has one thread's entry, so other threads don't count
+  static void countFreed(std::size_t bytes) noexcept {
+    auto& threads = arena();
+#ifdef _OPENMP
+    const auto thread = static_cast<std::size_t>(omp_get_thread_num());
+#else
+    const std::size_t thread = 0;
+#endif
+    if (thread < threads.size()) {
+      threads[thread].freed_bytes += bytes;
+    }
+  }
+
+  /// Can \p block be put into the store? False for views
+  static bool ownsData(const ArrayData<T>& block) noexcept { return block.isOwner(); }
+  template <typename B>
+  static bool ownsData(const B&) noexcept {
+    return true;
+  }
+
   /*!
    * Release an dataBlock object, reducing its reference count by one.
    * If no more references, then put back into the store.
@@ -391,11 +620,13 @@ private:
       return;
 
     // Reduce reference count, and if zero return to store
-    if (d.use_count() == 1) {
+    if (d.use_count() == 1 and ownsData(*d)) {
       if (useStore()) {
         // Put back into store
-        store()[d->size()].push_back(std::move(d));
+        bucket(store(), d->size()).push_back(std::move(d));
         // Could return here but seems to slow things down a lot
+      } else {
+        countFreed(static_cast<std::size_t>(d->size()) * sizeof(T));
       }
     }
 
@@ -0,0 +1,139 @@
+/**************************************************************************
+ * Run-time checks for non-finite (NaN or infinite) field data
+ *
+ * With CHECK > 0, checkData(field) is called on the inputs and results
+ * of field operators. Whether it also scans the data for non-finite
+ * values is chosen at run-time by the [check] finite option:
+ *
+ *   none    Never scan (default for CHECK <= 2)
+ *   all     Scan on every checkData call (default for CHECK > 2)
+ *   sample  Scan on one in every sample_interval calls to checkData
+ *   rhs     Only scan the evolving variables and their time derivatives,
+ *           before and after each call to the physics model RHS. This
+ *           works at any CHECK level
+ *
+ * The scan is a parallel, vectorisable count over the contiguous blocks
+ * of the region. Only if something is found is the region searched
+ * again to find the first bad index for the error message.
+ *
+ **************************************************************************
+ * Copyright 2020 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __CHECK_DATA_H__
+#define __CHECK_DATA_H__
+
+#include "bout/bout_enum_class.hxx"
+#include "bout/openmpwrap.hxx"
+#include "bout/region.hxx"
+#include "bout_types.hxx"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+class Options;
+class Field2D;
+class Field3D;
+class FieldPerp;
+
+BOUT_ENUM_CLASS(CHECK_FINITE, none, all, sample, rhs);
+
+namespace bout {
+namespace checks {
+
+/// Read the settings from the [check] section of the input
+void init(Options& options);
+
+/// Change the mode, e.g. in tests. Resets the sampling counter
+void setFiniteMode(CHECK_FINITE mode, int sample_interval = 1);
+CHECK_FINITE getFiniteMode();
+
+/// Should this call to checkData scan the data for non-finite values?
+bool checkDataFinite();
+
+/// Should the solver scan the evolving variables around the RHS?
+bool checkRHSFinite();
+
+/// True if \p x is NaN or infinite. Only tests the exponent bits, so
+/// unlike std::isfinite this is not affected by -ffast-math, and the
+/// loop in findNonFinite can be vectorised
+inline bool isNonFinite(BoutReal x) {
+  static_assert(sizeof(BoutReal) == sizeof(std::uint64_t),
+                "isNonFinite assumes BoutReal is a 64-bit double");
+  constexpr std::uint64_t exponent_mask = 0x7ff0000000000000;
+  std::uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return (bits & exponent_mask) == exponent_mask;
+}
+
+/// Search \p region of \p data for non-finite values
+///
+/// @param[in] data    Start of the field data, indexed by T::ind
+/// @param[in] region  The region to search
+/// @param[out] first  The first non-finite index, if any
+///
+/// @returns true if a non-finite value was found
+template <typename T>
+bool findNonFinite(const BoutReal* data, const Region<T>& region, T& first) {
+  const auto& blocks = region.getBlocks();
+  const int nblocks = static_cast<int>(blocks.size());
+
+  int count = 0;
+  BOUT_OMP(parallel for reduction(+:count) schedule(OPENMP_SCHEDULE))
+  for (int b = 0; b < nblocks; ++b) {
+    const int start = blocks[b].first.ind;
+    const int end = blocks[b].second.ind;
+    // Branch-free so that the compiler can vectorise it
+    int block_count = 0;
+    for (int i = start; i < end; ++i) {
+      block_count += isNonFinite(data[i]) ? 1 : 0;
+    }
+    count += block_count;
+  }
+
+  if (count == 0) {
+    return false;
+  }
+
+  // Something is wrong, so the cost of finding where no longer matters
+  BOUT_FOR_SERIAL(i, region) {
+    if (isNonFinite(data[i.ind])) {
+      first = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Throw a BoutException if \p f has a non-finite value in \p region.
+/// \p name is used in the message, if not empty
+void checkFinite(const Field2D& f, const std::string& name,
+                 const std::string& region = "RGN_NOBNDRY");
+void checkFinite(const Field3D& f, const std::string& name,
+                 const std::string& region = "RGN_NOBNDRY");
+void checkFinite(const FieldPerp& f, const std::string& name,
+                 const std::string& region = "RGN_NOX");
+
+} // namespace checks
+} // namespace bout
+
+#endif // __CHECK_DATA_H__
@@ -120,6 +120,10 @@ public:
   int calcContravariant(const std::string& region = "RGN_ALL");
   int jacobian(); ///< Calculate J and Bxy
 
+  /// Incremented by each call to geometry(), so that quantities
+  /// calculated from the metric can tell when to recalculate
+  int getGeneration() const { return generation; }
+
 
   ///////////////////////////////////////////////////////////
   // Parallel transforms
@@ -251,6 +255,31 @@ public:
   // Full Laplacian operator on scalar field
   Field2D Laplace(const Field2D &f, CELL_LOC outloc=CELL_DEFAULT);
   Field3D Laplace(const Field3D &f, CELL_LOC outloc=CELL_DEFAULT);
+
+  /// Combinations of metric factors used by the finite volume operators
+  /// in bout/fv_ops.hxx, so they are not recalculated at every cell face
+  /// on every call. Each is only set where that operator uses it
+  struct FVFactors {
+    /// Div_par: multiply the flux through the upper (y+1/2) face of a
+    /// cell to give its contribution to this cell (c) and the one above
+    /// (p), and the flux through the lower face for this cell (c) and the
+    /// one below (m)
+    Field2D par_upper_c, par_upper_p, par_lower_c, par_lower_m;
+
+    /// Div_par_K_Grad_par: J/g_22 times d/dy across the upper and lower
+    /// faces, divided by the cell volume dy*J
+    Field2D grad_par_upper, grad_par_lower;
+
+    /// Div_a_Laplace_perp: J*g11 across the x+1/2 face divided by the
+    /// distance between cell centres, and 1 / (dx*J)
+    Field2D perp_x_flux, perp_x_inv_vol;
+    /// Div_a_Laplace_perp: J*g23 and 1/dy across the upper and lower y
+    /// faces, coefficients of the df/dy terms, and 1 / (dy*J)
+    Field2D perp_y_upper_g, perp_y_upper_dy, perp_y_lower_g, perp_y_lower_dy;
+    Field2D perp_y_coef, perp_z_coef, perp_y_inv_vol;
+  };
+  /// Calculated on first use, and cleared by geometry()
+  const FVFactors& getFVFactors();
   
 private:
   int nz; // Size of mesh in Z. This is mesh->ngz-1
@@ -263,6 +292,17 @@ private:
   /// Set the parallel (y) transform from the options file.
   /// Used in the constructor to create the transform object.
   void setParallelTransform(Options* options);
+
+  /// Tridiagonal coefficients used by the FFT Delp2, indexed by
+  /// ((x * LocalNy) + y) * (nz / 2 + 1) + kz. Only set for x and y
+  /// in the domain interior. Calculated on first use and cleared by
+  /// geometry()
+  Array<dcomplex> delp2_a, delp2_b, delp2_c;
+  void calcDelp2Coefs();
+
+  std::unique_ptr<FVFactors> fv_factors{nullptr};
+
+  int generation{0}; ///< Number of calls to geometry()
 };
 
 /*
@@ -29,17 +29,20 @@
 #ifndef __DERIV_STORE_HXX__
 #define __DERIV_STORE_HXX__
 
+#include <array>
 #include <functional>
 #include <map>
 #include <set>
 #include <unordered_map>
 
+#include <bout/assert.hxx>
 #include <bout/scorepwrapper.hxx>
 
 #include <bout_types.hxx>
 #include <boutexception.hxx>
 #include <msg_stack.hxx>
 #include <options.hxx>
+#include <stencils.hxx>
 
 /// Here we have a templated singleton that is used to store DerivativeFunctions
 /// for all types of derivatives. It is templated on the FieldType (2D or 3D) as
@@ -56,6 +59,21 @@ struct DerivativeStore {
   using upwindFunc = flowFunc;
   using fluxFunc = flowFunc;
 
+  /// The point-wise part of a stencil-based method: given the stencil
+  /// around a point (and, for upwinding, the velocity at the point)
+  /// return the index-space derivative there. Registering these
+  /// allows several derivatives to share one pass over a field, see
+  /// bout::derivatives::index::multiple
+  struct stencilKernel {
+    /// Kernel for the Standard, StandardSecond and StandardFourth
+    /// types, nullptr otherwise
+    BoutReal (*standard)(const stencil&);
+    /// Kernel for the Upwind type, nullptr otherwise
+    BoutReal (*upwind)(BoutReal, const stencil&);
+    /// Number of guard cells used by the stencil
+    int nGuards;
+  };
+
 #ifdef USE_ORDERED_MAP_FOR_DERIVATIVE_STORE
   template <typename K, typename V>
   using storageType = std::map<K, V>;
@@ -174,6 +192,7 @@ struct DerivativeStore {
     registeredMethods[getKey(direction, stagger, toString(derivType))].insert(
         methodName);
 
+    updateDefaultCache(derivType, direction, stagger);
   };
 
   /// Register a function with upwindFunc/fluxFunc interface. Which map is used
@@ -211,6 +230,8 @@ struct DerivativeStore {
     // Register this method name in lookup of known methods
     registeredMethods[getKey(direction, stagger, toString(derivType))].insert(
         methodName);
+
+    updateDefaultCache(derivType, direction, stagger);
   };
 
   /// Templated versions of the above registration routines.
@@ -234,11 +255,22 @@ struct DerivativeStore {
   /// have different return types. As such we choose to use a
   /// different name for each of the method-classes so everything is
   /// consistently treated
-  standardFunc getStandardDerivative(std::string name, DIRECTION direction,
-                                     STAGGER stagger = STAGGER::None,
-                                     DERIV derivType = DERIV::Standard) const {
+  ///
+  /// When \p name is DIFF_DEFAULT, the method is taken from a cache
+  /// filled in when methods are registered or the defaults change, so
+  /// the common case needs no string hashing or map lookups
+  const standardFunc& getStandardDerivative(const std::string& name, DIRECTION direction,
+                                            STAGGER stagger = STAGGER::None,
+                                            DERIV derivType = DERIV::Standard) const {
 
     AUTO_TRACE();
+    if (name == defaultName() and isStandardType(derivType)) {
+      const auto* cached = defaultStandard[standardCacheIndex(direction, stagger, derivType)];
+      if (cached != nullptr) {
+        return *cached;
+      }
+    }
+
     const auto realName = nameLookup(
         name, defaultMethods.at(getKey(direction, stagger, toString(derivType))));
     const auto key = getKey(direction, stagger, realName);
@@ -267,22 +299,31 @@ struct DerivativeStore {
         toString(derivType).c_str());
   };
 
-  standardFunc getStandard2ndDerivative(std::string name, DIRECTION direction,
-                                        STAGGER stagger = STAGGER::None) const {
+  const standardFunc& getStandard2ndDerivative(const std::string& name,
+                                               DIRECTION direction,
+                                               STAGGER stagger = STAGGER::None) const {
     AUTO_TRACE();
     return getStandardDerivative(name, direction, stagger, DERIV::StandardSecond);
   };
 
-  standardFunc getStandard4thDerivative(std::string name, DIRECTION direction,
-                                        STAGGER stagger = STAGGER::None) const {
+  const standardFunc& getStandard4thDerivative(const std::string& name,
+                                               DIRECTION direction,
+                                               STAGGER stagger = STAGGER::None) const {
     AUTO_TRACE();
     return getStandardDerivative(name, direction, stagger, DERIV::StandardFourth);
   };
 
-  flowFunc getFlowDerivative(std::string name, DIRECTION direction,
-                             STAGGER stagger = STAGGER::None,
-                             DERIV derivType = DERIV::Upwind) const {
+  const flowFunc& getFlowDerivative(const std::string& name, DIRECTION direction,
+                                    STAGGER stagger = STAGGER::None,
+                                    DERIV derivType = DERIV::Upwind) const {
     AUTO_TRACE();
+    if (name == defaultName() and isFlowType(derivType)) {
+      const auto* cached = defaultFlow[flowCacheIndex(direction, stagger, derivType)];
+      if (cached != nullptr) {
+        return *cached;
+      }
+    }
+
     const auto realName = nameLookup(
         name, defaultMethods.at(getKey(direction, stagger, toString(derivType))));
     const auto key = getKey(direction, stagger, realName);
@@ -309,18 +350,60 @@ struct DerivativeStore {
         toString(derivType).c_str());
   }
 
-  upwindFunc getUpwindDerivative(std::string name, DIRECTION direction,
-                                 STAGGER stagger = STAGGER::None) const {
+  const upwindFunc& getUpwindDerivative(const std::string& name, DIRECTION direction,
+                                        STAGGER stagger = STAGGER::None) const {
     AUTO_TRACE();
     return getFlowDerivative(name, direction, stagger, DERIV::Upwind);
   };
 
-  fluxFunc getFluxDerivative(std::string name, DIRECTION direction,
-                             STAGGER stagger = STAGGER::None) const {
+  const fluxFunc& getFluxDerivative(const std::string& name, DIRECTION direction,
+                                    STAGGER stagger = STAGGER::None) const {
     AUTO_TRACE();
     return getFlowDerivative(name, direction, stagger, DERIV::Flux);
   };
 
+  /// Register the point-wise kernel of a stencil-based method. This
+  /// is in addition to registering the method itself with
+  /// registerDerivative
+  void registerKernel(stencilKernel kernel, DERIV derivType, DIRECTION direction,
+                      STAGGER stagger, const std::string& methodName) {
+    AUTO_TRACE();
+    if (isStandardType(derivType)) {
+      ASSERT1(kernel.standard != nullptr);
+    } else if (derivType == DERIV::Upwind) {
+      ASSERT1(kernel.upwind != nullptr);
+    } else {
+      throw BoutException("Can't register a stencil kernel for derivative type %s",
+                          toString(derivType).c_str());
+    }
+
+    auto& theMap = kernels[derivType];
+    const auto key = getKey(direction, stagger, methodName);
+    if (theMap.count(key) != 0) {
+      throw BoutException("Trying to override %s stencil kernel : "
+                          "direction %s, stagger %s, key %s",
+                          toString(derivType).c_str(), toString(direction).c_str(),
+                          toString(stagger).c_str(), methodName.c_str());
+    }
+    theMap[key] = kernel;
+  }
+
+  /// Return the point-wise kernel for a method, or nullptr if the
+  /// method doesn't have one (for example, it isn't stencil based)
+  const stencilKernel* getKernel(const std::string& name, DIRECTION direction,
+                                 STAGGER stagger = STAGGER::None,
+                                 DERIV derivType = DERIV::Standard) const {
+    AUTO_TRACE();
+    const auto theMap = kernels.find(derivType);
+    if (theMap == kernels.end()) {
+      return nullptr;
+    }
+    const auto realName = nameLookup(
+        name, defaultMethods.at(getKey(direction, stagger, toString(derivType))));
+    const auto found = theMap->second.find(getKey(direction, stagger, realName));
+    return (found == theMap->second.end()) ? nullptr : &(found->second);
+  }
+
   void initialise(Options* options) {
     AUTO_TRACE();
 
@@ -403,6 +486,8 @@ struct DerivativeStore {
                        << toString(theDirection) << " is " << theDefault << "\n";
       }
     }
+
+    updateDefaultCache();
   }
 
   /// Provide a method to override/force a specific default method
@@ -410,6 +495,7 @@ struct DerivativeStore {
                           STAGGER stagger = STAGGER::None) {
     const auto key = getKey(direction, stagger, toString(deriv));
     defaultMethods[key] = uppercase(methodName);
+    updateDefaultCache(deriv, direction, stagger);
   }
 
   /// Empty all member storage
@@ -421,6 +507,9 @@ struct DerivativeStore {
     upwind.clear();
     flux.clear();
     registeredMethods.clear();
+    kernels.clear();
+    defaultStandard.fill(nullptr);
+    defaultFlow.fill(nullptr);
   }
 
   /// Reset to initial state
@@ -434,6 +523,9 @@ private:
   // Make empty constructor private so we can't make instances outside
   // of the struct
   DerivativeStore() {
+    defaultStandard.fill(nullptr);
+    defaultFlow.fill(nullptr);
+
     // Ensure the default methods are set on construction
     // This populates the defaultMethods map
     setDefaults();
@@ -447,6 +539,10 @@ private:
 
   storageType<std::size_t, std::set<std::string>> registeredMethods;
 
+  /// Point-wise kernels of the stencil-based methods, for each
+  /// derivative type
+  std::map<DERIV, storageType<std::size_t, stencilKernel>> kernels;
+
   /// The following stores what actual method to use when DIFF_DEFAULT
   /// is passed. The key is determined using the getKey routine here,
   /// where the name we pass is determined by the type of method (standard,
@@ -455,6 +551,94 @@ private:
   /// it might be useful to relax this assumption!
   storageType<std::size_t, std::string> defaultMethods;
 
+  /// Number of values of the DIRECTION and STAGGER enums, used to size
+  /// the caches of default methods below
+  static constexpr int nDirections = 5;
+  static constexpr int nStaggers = 3;
+
+  /// Cache of the functions used for DIFF_DEFAULT, for each
+  /// combination of direction, stagger and derivative type. These
+  /// point into the maps above, or are nullptr if the default method
+  /// isn't registered (in which case the full lookup is done, which
+  /// gives a useful error). Elements of the maps are never moved, so
+  /// these stay valid until the maps are cleared
+  std::array<const standardFunc*, nDirections * nStaggers * 3> defaultStandard;
+  std::array<const flowFunc*, nDirections * nStaggers * 2> defaultFlow;
+
+  static bool isStandardType(DERIV derivType) {
+    return derivType == DERIV::Standard || derivType == DERIV::StandardSecond
+           || derivType == DERIV::StandardFourth;
+  }
+  static bool isFlowType(DERIV derivType) {
+    return derivType == DERIV::Upwind || derivType == DERIV::Flux;
+  }
+
+  static std::size_t standardCacheIndex(DIRECTION direction, STAGGER stagger,
+                                        DERIV derivType) {
+    return (static_cast<std::size_t>(direction) * nStaggers
+            + static_cast<std::size_t>(stagger))
+               * 3
+           + static_cast<std::size_t>(derivType)
+           - static_cast<std::size_t>(DERIV::Standard);
+  }
+  static std::size_t flowCacheIndex(DIRECTION direction, STAGGER stagger,
+                                    DERIV derivType) {
+    return (static_cast<std::size_t>(direction) * nStaggers
+            + static_cast<std::size_t>(stagger))
+               * 2
+           + static_cast<std::size_t>(derivType) - static_cast<std::size_t>(DERIV::Upwind);
+  }
+
+  /// Name used to ask for the default method
+  static const std::string& defaultName() {
+    static const std::string name{toString(DIFF_DEFAULT)};
+    return name;
+  }
+
+  /// Find the default method for this combination of derivative
+  /// type, direction and stagger, and store it in the cache
+  void updateDefaultCache(DERIV derivType, DIRECTION direction, STAGGER stagger) {
+    if (isStandardType(derivType)) {
+      defaultStandard[standardCacheIndex(direction, stagger, derivType)] =
+          findDefault(derivType == DERIV::Standard
+                          ? standard
+                          : derivType == DERIV::StandardSecond ? standardSecond
+                                                               : standardFourth,
+                      derivType, direction, stagger);
+    } else if (isFlowType(derivType)) {
+      defaultFlow[flowCacheIndex(direction, stagger, derivType)] =
+          findDefault(derivType == DERIV::Upwind ? upwind : flux, derivType, direction,
+                      stagger);
+    }
+  }
+
+  /// Find the default method in \p theMap, or nullptr if it isn't there
+  template <typename Func>
+  const Func* findDefault(const storageType<std::size_t, Func>& theMap, DERIV derivType,
+                          DIRECTION direction, STAGGER stagger) const {
+    const auto defaultMethod =
+        defaultMethods.find(getKey(direction, stagger, toString(derivType)));
+    if (defaultMethod == defaultMethods.end()) {
+      return nullptr;
+    }
+    const auto found = theMap.find(getKey(direction, stagger, defaultMethod->second));
+    return (found == theMap.end()) ? nullptr : &(found->second);
+  }
+
+  /// Update the cache for every combination
+  void updateDefaultCache() {
+    for (const auto direction : {DIRECTION::X, DIRECTION::Y, DIRECTION::Z,
+                                 DIRECTION::YAligned, DIRECTION::YOrthogonal}) {
+      for (const auto stagger : {STAGGER::None, STAGGER::C2L, STAGGER::L2C}) {
+        for (const auto derivType :
+             {DERIV::Standard, DERIV::StandardSecond, DERIV::StandardFourth,
+              DERIV::Upwind, DERIV::Flux}) {
+          updateDefaultCache(derivType, direction, stagger);
+        }
+      }
+    }
+  }
+
   void setDefaults() {
     std::map<DERIV, std::string> initialDefaultMethods = {{DERIV::Standard, "C2"},
                                                           {DERIV::StandardSecond, "C2"},
@@ -492,6 +676,8 @@ private:
             theDefault;
       }
     }
+
+    updateDefaultCache();
   };
 
   std::string getMethodName(std::string name, DIRECTION direction,
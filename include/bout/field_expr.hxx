@@ -0,0 +1,330 @@
+/// \file field_expr.hxx
+///
+/// Lazy evaluation of arithmetic on fields, using expression templates
+///
+/// The usual field operators (see gen_fieldops.py) each allocate a
+/// new field and make a pass over all of its points, so an
+/// expression like `a*b + c/d - e` makes four temporaries and five
+/// passes through memory. Wrapping one operand of each operation in
+/// `bout::expr::lazy` instead builds up a description of the whole
+/// expression, which is evaluated in a single loop when it is
+/// assigned to a field:
+///
+///     using bout::expr::lazy;
+///     ddt(n) = lazy(a) * b + lazy(c) / d - e;
+///
+/// Note that an operation is only lazy if at least one of its
+/// operands is already lazy: `lazy(a) * b + c / d` still calculates
+/// `c / d` on its own.
+///
+/// Field3D, Field2D and FieldPerp can be mixed, following the same
+/// rules as the usual operators: the result is a FieldPerp if any
+/// operand is, otherwise a Field3D if any operand is, otherwise a
+/// Field2D. The result takes its location and mesh from the first
+/// operand of that type.
+///
+/// Expressions hold references to their operands, so should be
+/// evaluated in the statement that creates them, rather than stored
+/// (e.g. with `auto`) for later
+
+#ifndef BOUT_FIELD_EXPR_H
+#define BOUT_FIELD_EXPR_H
+
+#include "bout/assert.hxx"
+#include "bout/mesh.hxx"
+#include "bout/region.hxx"
+#include "bout/traits.hxx"
+#include "field2d.hxx"
+#include "field3d.hxx"
+#include "fieldperp.hxx"
+#include "unused.hxx"
+
+#include <type_traits>
+
+namespace bout {
+namespace expr {
+
+/// Indices of a point in the data of each type of field
+struct Point {
+  int ind3D;   ///< Index into Field3D data
+  int ind2D;   ///< Index into Field2D data
+  int indPerp; ///< Index into FieldPerp data
+};
+
+/// Base class of all expression nodes, used to recognise them
+struct Expression {};
+
+template <typename T>
+using is_expression = std::is_base_of<Expression, T>;
+
+/// Type of the result of combining \p L and \p R. BoutReal is used
+/// for scalars
+template <typename L, typename R>
+struct Promote {
+  template <typename T>
+  using either = std::integral_constant<bool, std::is_same<L, T>::value
+                                                  or std::is_same<R, T>::value>;
+
+  using type = typename std::conditional<
+      either<FieldPerp>::value, FieldPerp,
+      typename std::conditional<
+          either<Field3D>::value, Field3D,
+          typename std::conditional<either<Field2D>::value, Field2D,
+                                    BoutReal>::type>::type>::type;
+};
+
+namespace detail {
+inline const BoutReal* dataPointer(const Field3D& f) { return &f(0, 0, 0); }
+inline const BoutReal* dataPointer(const Field2D& f) { return &f(0, 0); }
+inline const BoutReal* dataPointer(const FieldPerp& f) { return &f(0, 0); }
+
+inline int pointIndex(const Field3D*, const Point& p) { return p.ind3D; }
+inline int pointIndex(const Field2D*, const Point& p) { return p.ind2D; }
+inline int pointIndex(const FieldPerp*, const Point& p) { return p.indPerp; }
+} // namespace detail
+
+template <typename E>
+typename E::result_type evaluate(const E& expr);
+
+/// A field in an expression
+template <typename F>
+class Leaf : public Expression {
+public:
+  using result_type = F;
+
+  explicit Leaf(const F& f)
+      : field(f), data(f.isAllocated() ? detail::dataPointer(f) : nullptr) {}
+
+  BoutReal operator()(const Point& p) const {
+    return data[detail::pointIndex(&field, p)];
+  }
+
+  /// Check this operand is usable in an expression with result like \p reference
+  template <typename R>
+  void check(const R& reference) const {
+    ASSERT1(field.isAllocated());
+    ASSERT1(areFieldsCompatible(reference, field));
+    checkData(field);
+  }
+
+  /// Set \p reference to the first operand of type F, if not already set
+  void reference(const F*& ref) const {
+    if (ref == nullptr) {
+      ref = &field;
+    }
+  }
+  template <typename R>
+  void reference(const R*& UNUSED(ref)) const {}
+
+  operator result_type() const { return evaluate(*this); }
+
+private:
+  const F& field;
+  const BoutReal* data;
+};
+
+/// A constant in an expression
+class Scalar : public Expression {
+public:
+  using result_type = BoutReal;
+
+  explicit Scalar(BoutReal value) : value(value) {}
+
+  BoutReal operator()(const Point& UNUSED(p)) const { return value; }
+
+  template <typename R>
+  void check(const R& UNUSED(reference)) const {}
+
+  template <typename R>
+  void reference(const R*& UNUSED(ref)) const {}
+
+private:
+  const BoutReal value;
+};
+
+/// An arithmetic operation \p Op on the expressions \p L and \p R
+template <typename L, typename R, typename Op>
+class Binary : public Expression {
+public:
+  using result_type =
+      typename Promote<typename L::result_type, typename R::result_type>::type;
+
+  Binary(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+
+  BoutReal operator()(const Point& p) const { return Op::apply(lhs(p), rhs(p)); }
+
+  template <typename Ref>
+  void check(const Ref& reference) const {
+    lhs.check(reference);
+    rhs.check(reference);
+  }
+
+  template <typename Ref>
+  void reference(const Ref*& ref) const {
+    lhs.reference(ref);
+    rhs.reference(ref);
+  }
+
+  operator result_type() const { return evaluate(*this); }
+
+private:
+  const L lhs;
+  const R rhs;
+};
+
+/// The negative of the expression \p E
+template <typename E>
+class Negate : public Expression {
+public:
+  using result_type = typename E::result_type;
+
+  explicit Negate(const E& expr) : expr(expr) {}
+
+  BoutReal operator()(const Point& p) const { return -expr(p); }
+
+  template <typename Ref>
+  void check(const Ref& reference) const {
+    expr.check(reference);
+  }
+
+  template <typename Ref>
+  void reference(const Ref*& ref) const {
+    expr.reference(ref);
+  }
+
+  operator result_type() const { return evaluate(*this); }
+
+private:
+  const E expr;
+};
+
+/// Start a lazy expression with the field \p f
+inline Leaf<Field3D> lazy(const Field3D& f) { return Leaf<Field3D>{f}; }
+inline Leaf<Field2D> lazy(const Field2D& f) { return Leaf<Field2D>{f}; }
+inline Leaf<FieldPerp> lazy(const FieldPerp& f) { return Leaf<FieldPerp>{f}; }
+
+/// Convert operands of the operators below into expressions
+template <typename T, typename Enable = void>
+struct ToExpression {};
+
+template <typename T>
+struct ToExpression<T, typename std::enable_if<is_expression<T>::value>::type> {
+  using type = T;
+  static const T& get(const T& expr) { return expr; }
+};
+
+template <typename T>
+struct ToExpression<
+    T, typename std::enable_if<bout::utils::is_Field3D<T>::value
+                               or bout::utils::is_Field2D<T>::value
+                               or bout::utils::is_FieldPerp<T>::value>::type> {
+  using type = Leaf<T>;
+  static type get(const T& f) { return type{f}; }
+};
+
+template <typename T>
+struct ToExpression<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  using type = Scalar;
+  static type get(T value) { return type{static_cast<BoutReal>(value)}; }
+};
+
+/// The result of combining \p L and \p R with \p Op, if at least one
+/// of them is an expression
+template <typename L, typename R, typename Op>
+using BinaryResult = typename std::enable_if<
+    is_expression<L>::value or is_expression<R>::value,
+    Binary<typename ToExpression<L>::type, typename ToExpression<R>::type, Op>>::type;
+
+#define BOUT_EXPR_BINARY_OP(name, op)                                            \
+  struct name {                                                                  \
+    static BoutReal apply(BoutReal lhs, BoutReal rhs) { return lhs op rhs; }     \
+  };                                                                             \
+  template <typename L, typename R>                                              \
+  BinaryResult<L, R, name> operator op(const L& lhs, const R& rhs) {             \
+    return {ToExpression<L>::get(lhs), ToExpression<R>::get(rhs)};               \
+  }
+
+BOUT_EXPR_BINARY_OP(Add, +)
+BOUT_EXPR_BINARY_OP(Subtract, -)
+BOUT_EXPR_BINARY_OP(Multiply, *)
+BOUT_EXPR_BINARY_OP(Divide, /)
+
+#undef BOUT_EXPR_BINARY_OP
+
+template <typename E, typename = typename std::enable_if<is_expression<E>::value>::type>
+Negate<E> operator-(const E& expr) {
+  return Negate<E>{expr};
+}
+
+namespace detail {
+/// Evaluate \p expr at every point of \p result, in a single loop
+template <typename E>
+void fill(const E& expr, Field3D& result) {
+  Mesh* localmesh = result.getMesh();
+  const int nz = localmesh->LocalNz;
+  BoutReal* data = &result(0, 0, 0);
+
+  // Loop over 2D indices, so that any Field2D operands are only
+  // read once for each z-line
+  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
+    const int base = index.ind * nz;
+    for (int jz = 0; jz < nz; ++jz) {
+      data[base + jz] = expr(Point{base + jz, index.ind, 0});
+    }
+  }
+}
+
+template <typename E>
+void fill(const E& expr, Field2D& result) {
+  BoutReal* data = &result(0, 0);
+
+  BOUT_FOR(index, result.getRegion("RGN_ALL")) {
+    data[index.ind] = expr(Point{0, index.ind, 0});
+  }
+}
+
+template <typename E>
+void fill(const E& expr, FieldPerp& result) {
+  Mesh* localmesh = result.getMesh();
+  const int ny = localmesh->LocalNy;
+  const int nz = localmesh->LocalNz;
+  const int yindex = result.getIndex();
+  BoutReal* data = &result(0, 0);
+
+  BOUT_FOR(index, result.getRegion("RGN_ALL")) {
+    const int ind2D = index.x() * ny + yindex;
+    data[index.ind] = expr(Point{ind2D * nz + index.z(), ind2D, index.ind});
+  }
+}
+} // namespace detail
+
+/// Evaluate \p expr, returning a new field. This is called when an
+/// expression is assigned to a field, so usually doesn't need to be
+/// called directly
+template <typename E>
+typename E::result_type evaluate(const E& expr) {
+  AUTO_TRACE();
+  using result_type = typename E::result_type;
+
+  static_assert(is_expression<E>::value, "evaluate only works on expressions");
+
+  // The result is like the first operand of the same type
+  const result_type* reference = nullptr;
+  expr.reference(reference);
+  ASSERT0(reference != nullptr);
+
+  // Check the operands are valid and compatible with each other
+  expr.check(*reference);
+
+  result_type result{emptyFrom(*reference)};
+
+  detail::fill(expr, result);
+
+  checkData(result);
+  return result;
+}
+
+} // namespace expr
+} // namespace bout
+
+#endif // BOUT_FIELD_EXPR_H
@@ -11,6 +11,7 @@
 
 #include "../utils.hxx"
 #include <bout/mesh.hxx>
+#include <bout/openmpwrap.hxx>
 
 namespace FV {
   /*!
@@ -187,8 +188,6 @@ namespace FV {
 
     Mesh* mesh = f_in.getMesh();
 
-    CellEdges cellboundary;
-    
     ASSERT2(f_in.getDirectionY() == v_in.getDirectionY());
     ASSERT2(f_in.getDirectionY() == wave_speed_in.getDirectionY());
     const bool are_unaligned
@@ -202,16 +201,17 @@ namespace FV {
                                        : wave_speed_in;
 
     Coordinates *coord = f_in.getCoordinates();
+    const auto& fv = coord->getFVFactors();
 
     Field3D result{zeroFrom(f)};
-    
-    // Only need one guard cell, so no need to communicate fluxes
-    // Instead calculate in guard cells to preserve fluxes
-    int ys = mesh->ystart-1;
-    int ye = mesh->yend+1;
 
-    for (int i = mesh->xstart; i <= mesh->xend; i++) {
+    const int nx = mesh->xend - mesh->xstart + 1;
+    const int ny = mesh->LocalNy;
+    const int nz = mesh->LocalNz;
 
+    // Only need one guard cell, so no need to communicate fluxes
+    // Instead calculate in guard cells to preserve fluxes
+    auto yrange = [mesh](int i, int& ys, int& ye) {
       if (!mesh->firstY(i) || mesh->periodicY(i)) {
         // Calculate in guard cell to get fluxes consistent between processors
         ys = mesh->ystart - 1;
@@ -228,25 +228,46 @@ namespace FV {
         // Not in boundary cells
         ye = mesh->yend;
       }
+    };
+
+    // Fluxes through the right (upper) and left (lower) face of each
+    // cell, as calculated from that cell. These are stored, then summed
+    // into the result in a second pass, so that each pass only writes
+    // to its own cell and the loops can be run in parallel
+    Array<BoutReal> flux_right(mesh->LocalNx * ny * nz);
+    Array<BoutReal> flux_left(mesh->LocalNx * ny * nz);
+
+    BOUT_OMP(parallel) {
+      CellEdges cellboundary;
+
+      BOUT_OMP(for schedule(OPENMP_SCHEDULE))
+      for (int ij = 0; ij < nx * (mesh->yend - mesh->ystart + 3); ij++) {
+        const int i = mesh->xstart + ij / (mesh->yend - mesh->ystart + 3);
+        const int j = mesh->ystart - 1 + ij % (mesh->yend - mesh->ystart + 3);
+
+        int ys, ye;
+        yrange(i, ys, ye);
+        if (j < ys || j > ye) {
+          continue;
+        }
 
-      for (int j = ys; j <= ye; j++) {
-        // Pre-calculate factors which multiply fluxes
-
-        // For right cell boundaries
-        BoutReal common_factor = (coord->J(i, j) + coord->J(i, j + 1)) /
-          (sqrt(coord->g_22(i, j)) + sqrt(coord->g_22(i, j + 1)));
-        
-        BoutReal flux_factor_rc = common_factor / (coord->dy(i, j) * coord->J(i, j));
-        BoutReal flux_factor_rp = common_factor / (coord->dy(i, j + 1) * coord->J(i, j + 1));
+        const bool last_point = mesh->lastY(i) && (j == mesh->yend) && !mesh->periodicY(i);
+        const bool first_point =
+            mesh->firstY(i) && (j == mesh->ystart) && !mesh->periodicY(i);
 
-        // For left cell boundaries
-        common_factor = (coord->J(i, j) + coord->J(i, j - 1)) /
-          (sqrt(coord->g_22(i, j)) + sqrt(coord->g_22(i, j - 1)));
+        const BoutReal* fc = &f(i, j, 0);
+        const BoutReal* fm = &f(i, j - 1, 0);
+        const BoutReal* fp = &f(i, j + 1, 0);
+        const BoutReal* vc = &v(i, j, 0);
+        const BoutReal* vm = &v(i, j - 1, 0);
+        const BoutReal* vp = &v(i, j + 1, 0);
+        const BoutReal* wc = &wave_speed(i, j, 0);
+        const BoutReal* wm = &wave_speed(i, j - 1, 0);
+        const BoutReal* wp = &wave_speed(i, j + 1, 0);
+        BoutReal* right = &flux_right[(i * ny + j) * nz];
+        BoutReal* left = &flux_left[(i * ny + j) * nz];
 
-        BoutReal flux_factor_lc = common_factor / (coord->dy(i, j) * coord->J(i, j));
-        BoutReal flux_factor_lm = common_factor / (coord->dy(i, j - 1) * coord->J(i, j - 1));
-        
-        for (int k = 0; k < mesh->LocalNz; k++) {
+        for (int k = 0; k < nz; k++) {
 
           ////////////////////////////////////////////
           // Reconstruct f at the cell faces
@@ -255,9 +276,9 @@ namespace FV {
           
           // Reconstruct f at the cell faces
           Stencil1D s;
-          s.c = f(i, j, k);
-          s.m = f(i, j - 1, k);
-          s.p = f(i, j + 1, k);
+          s.c = fc[k];
+          s.m = fm[k];
+          s.p = fp[k];
 
           cellboundary(s); // Calculate s.R and s.L
 
@@ -265,10 +286,10 @@ namespace FV {
           // Right boundary
 
           // Calculate velocity at right boundary (y+1/2)
-          BoutReal vpar = 0.5 * (v(i, j, k) + v(i, j + 1, k));
+          BoutReal vpar = 0.5 * (vc[k] + vp[k]);
           BoutReal flux;
 
-          if (mesh->lastY(i) && (j == mesh->yend) && !mesh->periodicY(i)) {
+          if (last_point) {
             // Last point in domain
 
             BoutReal bndryval = 0.5 * (s.c + s.p);
@@ -277,12 +298,12 @@ namespace FV {
               flux = bndryval * vpar;
             } else {
               // Add flux due to difference in boundary values
-              flux = s.R * vpar + wave_speed(i, j, k) * (s.R - bndryval);
+              flux = s.R * vpar + wc[k] * (s.R - bndryval);
             }
           } else {
             
             // Maximum wave speed in the two cells
-            BoutReal amax = BOUTMAX(wave_speed(i, j, k), wave_speed(i, j + 1, k));
+            BoutReal amax = BOUTMAX(wc[k], wp[k]);
 
             if (vpar > amax) {
               // Supersonic flow out of this cell
@@ -295,16 +316,15 @@ namespace FV {
               flux = s.R * 0.5 * (vpar + amax);
             }
           }
-          
-          result(i, j, k) += flux * flux_factor_rc;
-          result(i, j + 1, k) -= flux * flux_factor_rp;
+
+          right[k] = flux;
 
           ////////////////////////////////////////////
           // Calculate at left boundary
           
-          vpar = 0.5 * (v(i, j, k) + v(i, j - 1, k));
+          vpar = 0.5 * (vc[k] + vm[k]);
 
-          if (mesh->firstY(i) && (j == mesh->ystart) && !mesh->periodicY(i)) {
+          if (first_point) {
             // First point in domain
             BoutReal bndryval = 0.5 * (s.c + s.m);
             if (fixflux) {
@@ -312,12 +332,12 @@ namespace FV {
               flux = bndryval * vpar;
             } else {
               // Add flux due to difference in boundary values
-              flux = s.L * vpar - wave_speed(i, j, k) * (s.L - bndryval);
+              flux = s.L * vpar - wc[k] * (s.L - bndryval);
             }
           } else {
             
             // Maximum wave speed in the two cells
-            BoutReal amax = BOUTMAX(wave_speed(i, j, k), wave_speed(i, j - 1, k));
+            BoutReal amax = BOUTMAX(wc[k], wm[k]);
 
             if (vpar < -amax) {
               // Supersonic out of this cell
@@ -329,10 +349,51 @@ namespace FV {
               flux = s.L * 0.5 * (vpar - amax);
             }
           }
-          
-          result(i, j, k) -= flux * flux_factor_lc;
-          result(i, j - 1, k) += flux * flux_factor_lm;
-          
+
+          left[k] = flux;
+        }
+      }
+
+      // Sum the fluxes through both faces of each cell, including the
+      // guard cells next to the calculated range. Contributions are added
+      // in the same order as if each flux were added to both of its cells
+      // as it was calculated
+      BOUT_OMP(for schedule(OPENMP_SCHEDULE))
+      for (int ij = 0; ij < nx * (mesh->yend - mesh->ystart + 5); ij++) {
+        const int i = mesh->xstart + ij / (mesh->yend - mesh->ystart + 5);
+        const int j = mesh->ystart - 2 + ij % (mesh->yend - mesh->ystart + 5);
+
+        int ys, ye;
+        yrange(i, ys, ye);
+        if (j < ys - 1 || j > ye + 1) {
+          continue;
+        }
+
+        BoutReal* res = &result(i, j, 0);
+
+        if (j - 1 >= ys && j - 1 <= ye) {
+          const BoutReal* right = &flux_right[(i * ny + j - 1) * nz];
+          const BoutReal factor = fv.par_upper_p(i, j - 1);
+          for (int k = 0; k < nz; k++) {
+            res[k] -= right[k] * factor;
+          }
+        }
+        if (j >= ys && j <= ye) {
+          const BoutReal* right = &flux_right[(i * ny + j) * nz];
+          const BoutReal* left = &flux_left[(i * ny + j) * nz];
+          const BoutReal factor_right = fv.par_upper_c(i, j);
+          const BoutReal factor_left = fv.par_lower_c(i, j);
+          for (int k = 0; k < nz; k++) {
+            res[k] += right[k] * factor_right;
+            res[k] -= left[k] * factor_left;
+          }
+        }
+        if (j + 1 >= ys && j + 1 <= ye) {
+          const BoutReal* left = &flux_left[(i * ny + j + 1) * nz];
+          const BoutReal factor = fv.par_lower_m(i, j + 1);
+          for (int k = 0; k < nz; k++) {
+            res[k] += left[k] * factor;
+          }
         }
       }
     }
@@ -39,6 +39,8 @@
 #include <bout/region.hxx>
 #include <bout/scorepwrapper.hxx>
 #include <bout/template_combinations.hxx>
+#include <bout/traits.hxx>
+#include <bout/zpadded.hxx>
 
 #include <bout_types.hxx>
 #include <fft.hxx>
@@ -89,6 +91,11 @@ public:
             || meta.derivType == DERIV::StandardFourth)
     ASSERT2(var.getMesh()->getNguard(direction) >= nGuards);
 
+    if (direction == DIRECTION::Z && isWholeZLineRegion<T>(region)) {
+      standardZ<stagger, nGuards>(var, result, region);
+      return;
+    }
+
     BOUT_FOR(i, var.getRegion(region)) {
       result[i] = apply(populateStencil<direction, stagger, nGuards>(var, i));
     }
@@ -101,6 +108,11 @@ public:
     ASSERT2(meta.derivType == DERIV::Upwind || meta.derivType == DERIV::Flux)
     ASSERT2(var.getMesh()->getNguard(direction) >= nGuards);
 
+    if (direction == DIRECTION::Z && isWholeZLineRegion<T>(region)) {
+      upwindOrFluxZ<stagger, nGuards>(vel, var, result, region);
+      return;
+    }
+
     if (meta.derivType == DERIV::Flux || stagger != STAGGER::None) {
       BOUT_FOR(i, var.getRegion(region)) {
         result[i] = apply(populateStencil<direction, stagger, nGuards>(vel, i),
@@ -121,6 +133,69 @@ public:
 
   const FF func{};
   const metaData meta = func.meta;
+
+private:
+  /// Can z derivatives of \p T on \p region be done a whole z-line at a
+  /// time? These regions contain every z point of each (x, y) in the
+  /// corresponding Region<Ind2D>
+  template <typename T>
+  static bool isWholeZLineRegion(const std::string& region) {
+    return bout::utils::is_Field3D<T>::value
+           && (region == "RGN_ALL" || region == "RGN_NOBNDRY" || region == "RGN_NOX"
+               || region == "RGN_NOY");
+  }
+
+  /// Z derivative one z-line at a time. Each line is copied with
+  /// periodic guard cells, so the stencil is built from plain offsets
+  /// rather than the wrapping zp()/zm()
+  template <STAGGER stagger, int nGuards, typename T>
+  void standardZ(const T& var, T& result, const std::string& region) const {
+    auto* theMesh = var.getMesh();
+    const int ncz = theMesh->LocalNz;
+
+    BOUT_OMP(parallel) {
+      bout::ZPaddedLine line(ncz, nGuards);
+
+      BOUT_FOR_INNER(i, theMesh->getRegion2D(region)) {
+        const auto i3D = theMesh->ind2Dto3D(i);
+        const BoutReal* fz = line.load(&var[i3D]);
+        BoutReal* rz = &result[i3D];
+        for (int jz = 0; jz < ncz; ++jz) {
+          rz[jz] = apply(populateStencilZ<stagger, nGuards>(fz + jz));
+        }
+      }
+    }
+  }
+
+  template <STAGGER stagger, int nGuards, typename T>
+  void upwindOrFluxZ(const T& vel, const T& var, T& result,
+                     const std::string& region) const {
+    auto* theMesh = var.getMesh();
+    const int ncz = theMesh->LocalNz;
+    const bool stencil_vel = meta.derivType == DERIV::Flux || stagger != STAGGER::None;
+
+    BOUT_OMP(parallel) {
+      bout::ZPaddedLine vline(ncz, nGuards), fline(ncz, nGuards);
+
+      BOUT_FOR_INNER(i, theMesh->getRegion2D(region)) {
+        const auto i3D = theMesh->ind2Dto3D(i);
+        const BoutReal* fz = fline.load(&var[i3D]);
+        BoutReal* rz = &result[i3D];
+        if (stencil_vel) {
+          const BoutReal* vz = vline.load(&vel[i3D]);
+          for (int jz = 0; jz < ncz; ++jz) {
+            rz[jz] = apply(populateStencilZ<stagger, nGuards>(vz + jz),
+                           populateStencilZ<STAGGER::None, nGuards>(fz + jz));
+          }
+        } else {
+          const BoutReal* vz = &vel[i3D];
+          for (int jz = 0; jz < ncz; ++jz) {
+            rz[jz] = apply(vz[jz], populateStencilZ<STAGGER::None, nGuards>(fz + jz));
+          }
+        }
+      }
+    }
+  }
 };
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -128,12 +203,81 @@ public:
 /// template combinations, in conjunction with the template_combinations code.
 /////////////////////////////////////////////////////////////////////////////////
 
+/// Call the standard derivative of \p Method. This is a plain
+/// function rather than a std::bind of the member function, so the
+/// DerivativeStore holds just a function pointer and calling it does
+/// not go through a bound object
+template <typename Method, DIRECTION direction, STAGGER stagger, int nGuards,
+          typename FieldType>
+void callStandardDerivative(const FieldType& f, FieldType& result,
+                            const std::string& region) {
+  static const Method method{};
+  method.template standard<direction, stagger, nGuards, FieldType>(f, result, region);
+}
+
+/// Call the upwind or flux derivative of \p Method
+template <typename Method, DIRECTION direction, STAGGER stagger, int nGuards,
+          typename FieldType>
+void callFlowDerivative(const FieldType& vel, const FieldType& f, FieldType& result,
+                        const std::string& region) {
+  static const Method method{};
+  method.template upwindOrFlux<direction, stagger, nGuards, FieldType>(vel, f, result,
+                                                                        region);
+}
+
+/// The point-wise kernels of a stencil-based method \p FF, as plain
+/// functions which can be stored in the DerivativeStore
+template <typename FF>
+BoutReal applyStandardKernel(const stencil& f) {
+  return FF{}(f);
+}
+
+template <typename FF>
+BoutReal applyUpwindKernel(BoutReal vc, const stencil& f) {
+  return FF{}(vc, f);
+}
+
+/// Register the point-wise kernel of an unstaggered, stencil-based
+/// method, so that it can be combined with others in
+/// bout::derivatives::index::multiple. Staggered methods, flux
+/// methods (which need a stencil of the velocity) and methods which
+/// aren't stencil-based (e.g. FFT) don't have a kernel
+template <typename FieldType, typename FF>
+void registerStencilKernel(const DerivativeType<FF>& method, DIRECTION direction,
+                           STAGGER stagger) {
+  if (stagger != STAGGER::None) {
+    return;
+  }
+
+  using stencilKernel = typename DerivativeStore<FieldType>::stencilKernel;
+  stencilKernel kernel{nullptr, nullptr, method.meta.nGuards};
+
+  switch (method.meta.derivType) {
+  case (DERIV::Standard):
+  case (DERIV::StandardSecond):
+  case (DERIV::StandardFourth):
+    kernel.standard = &applyStandardKernel<FF>;
+    break;
+  case (DERIV::Upwind):
+    kernel.upwind = &applyUpwindKernel<FF>;
+    break;
+  default:
+    return;
+  }
+
+  DerivativeStore<FieldType>::getInstance().registerKernel(
+      kernel, method.meta.derivType, direction, stagger, method.meta.key);
+}
+
+template <typename FieldType, typename Method>
+void registerStencilKernel(const Method& UNUSED(method), DIRECTION UNUSED(direction),
+                           STAGGER UNUSED(stagger)) {}
+
 struct registerMethod {
   template <typename Direction, typename Stagger, typename FieldTypeContainer,
             typename Method>
   void operator()(Direction, Stagger, FieldTypeContainer, Method) {
     AUTO_TRACE();
-    using namespace std::placeholders;
 
     // Now we want to get the actual field type out of the TypeContainer
     // used to pass this around
@@ -149,60 +293,46 @@ struct registerMethod {
     const int nGuards = method.meta.nGuards;
 
     auto& derivativeRegister = DerivativeStore<FieldType>::getInstance();
+    using standardFunc = typename DerivativeStore<FieldType>::standardFunc;
+    using flowFunc = typename DerivativeStore<FieldType>::flowFunc;
 
     switch (method.meta.derivType) {
     case (DERIV::Standard):
     case (DERIV::StandardSecond):
     case (DERIV::StandardFourth): {
       if (nGuards == 1) {
-        const auto theFunc = std::bind(
-            // Method to store in function
-            &Method::template standard<Direction::value, Stagger::value, 1, FieldType>,
-            // Arguments -- first is hidden this of type-bound, others are placeholders
-            // for input field, output field, region
-            method, _1, _2, _3);
-        derivativeRegister.registerDerivative(theFunc, Direction{}, Stagger{}, method);
+        derivativeRegister.registerDerivative(
+            standardFunc{&callStandardDerivative<Method, Direction::value,
+                                                 Stagger::value, 1, FieldType>},
+            Direction{}, Stagger{}, method);
       } else {
-        const auto theFunc = std::bind(
-            // Method to store in function
-            &Method::template standard<Direction::value, Stagger::value, 2, FieldType>,
-            // Arguments -- first is hidden this of type-bound, others are placeholders
-            // for input field, output field, region
-            method, _1, _2, _3);
-        derivativeRegister.registerDerivative(theFunc, Direction{}, Stagger{}, method);
+        derivativeRegister.registerDerivative(
+            standardFunc{&callStandardDerivative<Method, Direction::value,
+                                                 Stagger::value, 2, FieldType>},
+            Direction{}, Stagger{}, method);
       }
       break;
     }
     case (DERIV::Upwind):
     case (DERIV::Flux): {
       if (nGuards == 1) {
-        const std::function<void(const FieldType&, const FieldType&, FieldType&,
-                                 const std::string&)>
-            theFunc = std::bind(
-            // Method to store in function
-            &Method::template upwindOrFlux<Direction::value, Stagger::value, 1,
-                                           FieldType>,
-            // Arguments -- first is hidden this of type-bound, others are placeholders
-            // for input field, output field, region
-            method, _1, _2, _3, _4);
-        derivativeRegister.registerDerivative(theFunc, Direction{}, Stagger{}, method);
+        derivativeRegister.registerDerivative(
+            flowFunc{&callFlowDerivative<Method, Direction::value, Stagger::value, 1,
+                                         FieldType>},
+            Direction{}, Stagger{}, method);
       } else {
-        const std::function<void(const FieldType&, const FieldType&, FieldType&,
-                                 const std::string&)>
-            theFunc = std::bind(
-            // Method to store in function
-            &Method::template upwindOrFlux<Direction::value, Stagger::value, 2,
-                                           FieldType>,
-            // Arguments -- first is hidden this of type-bound, others are placeholders
-            // for input field, output field, region
-            method, _1, _2, _3, _4);
-        derivativeRegister.registerDerivative(theFunc, Direction{}, Stagger{}, method);
+        derivativeRegister.registerDerivative(
+            flowFunc{&callFlowDerivative<Method, Direction::value, Stagger::value, 2,
+                                         FieldType>},
+            Direction{}, Stagger{}, method);
       }
       break;
     }
     default:
       throw BoutException("Unhandled derivative method in registerMethod.");
     };
+
+    registerStencilKernel<FieldType>(method, Direction::value, Stagger::value);
   }
 };
 
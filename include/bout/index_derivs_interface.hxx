@@ -30,10 +30,15 @@
 #define __INDEX_DERIVS_INTERFACE_HXX__
 
 #include <bout/deriv_store.hxx>
+#include <bout/region.hxx>
 #include <bout_types.hxx>
 #include <msg_stack.hxx>
+#include <stencils.hxx>
 #include "bout/traits.hxx"
 
+#include <algorithm>
+#include <vector>
+
 class Field3D;
 class Field2D;
 
@@ -41,6 +46,74 @@ namespace bout {
 namespace derivatives {
 namespace index {
 
+/// Calculate an upwind or flux derivative into an existing field
+/// \p result, only changing the points in \p region. The output
+/// location is the location of \p result.
+///
+/// This allows a result to be built up in pieces, for example
+/// calculating "RGN_INTERIOR" while the guard cells of \p f are being
+/// communicated (see Mesh::startCommunicate), then "RGN_SHELL" after
+template <typename T, DIRECTION direction, DERIV derivType>
+void flowDerivative(const T& vel, const T& f, T& result, const std::string& method,
+                    const std::string& region) {
+  AUTO_TRACE();
+
+  // Checks
+  static_assert(bout::utils::is_Field2D<T>::value || bout::utils::is_Field3D<T>::value,
+                "flowDerivative only works on Field2D or Field3D input");
+
+  static_assert(derivType == DERIV::Upwind || derivType == DERIV::Flux,
+                "flowDerivative only works for derivType in {Upwind, Flux}.");
+
+  auto* localmesh = f.getMesh();
+
+  // Check that the mesh is correct
+  ASSERT1(vel.getMesh() == localmesh);
+  ASSERT1(result.getMesh() == localmesh);
+  // Check that the input variable has data
+  ASSERT1(f.isAllocated());
+  ASSERT1(vel.isAllocated());
+
+  // Check the input data is valid
+  {
+    TRACE("Checking inputs");
+    checkData(f, region);
+    checkData(vel, region);
+  }
+
+  // Define properties of this approach
+  const CELL_LOC allowedStaggerLoc = localmesh->getAllowedStaggerLoc(direction);
+
+  // Handle the staggering
+  const CELL_LOC inloc = f.getLocation(); // Input locations
+  const CELL_LOC vloc = vel.getLocation();
+  const CELL_LOC outloc = result.getLocation();
+  const STAGGER stagger = localmesh->getStagger(vloc, inloc, outloc, allowedStaggerLoc);
+
+  result.allocate();
+
+  // Check for early exit
+  const int nPoint = localmesh->getNpoints(direction);
+
+  if (nPoint == 1) {
+    BOUT_FOR(i, result.getRegion(region)) { result[i] = 0.0; }
+    return;
+  }
+
+  // Lookup the method
+  const auto& derivativeMethod = DerivativeStore<T>::getInstance().getFlowDerivative(
+      method, direction, stagger, derivType);
+
+  // Apply method
+  derivativeMethod(vel, f, result, region);
+
+  // Check the result is valid
+  {
+    TRACE("Checking result");
+    checkData(result, region);
+  }
+}
+
 /// The main kernel used for all upwind and flux derivatives
 template <typename T, DIRECTION direction, DERIV derivType>
 T flowDerivative(const T& vel, const T& f, CELL_LOC outloc, const std::string& method,
@@ -88,7 +161,7 @@ T flowDerivative(const T& vel, const T& f, CELL_LOC outloc, const std::string& m
   }
 
   // Lookup the method
-  auto derivativeMethod = DerivativeStore<T>::getInstance().getFlowDerivative(
+  const auto& derivativeMethod = DerivativeStore<T>::getInstance().getFlowDerivative(
       method, direction, stagger, derivType);
 
   // Create the result field
@@ -106,6 +179,71 @@ T flowDerivative(const T& vel, const T& f, CELL_LOC outloc, const std::string& m
   return result;
 }
 
+/// Calculate a standard derivative into an existing field \p result,
+/// only changing the points in \p region. The output location is the
+/// location of \p result.
+///
+/// This allows a result to be built up in pieces, for example
+/// calculating "RGN_INTERIOR" while the guard cells of \p f are being
+/// communicated (see Mesh::startCommunicate), then "RGN_SHELL" after
+template <typename T, DIRECTION direction, DERIV derivType>
+void standardDerivative(const T& f, T& result, const std::string& method,
+                        const std::string& region) {
+  AUTO_TRACE();
+
+  // Checks
+  static_assert(bout::utils::is_Field2D<T>::value || bout::utils::is_Field3D<T>::value,
+                "standardDerivative only works on Field2D or Field3D input");
+
+  static_assert(derivType == DERIV::Standard || derivType == DERIV::StandardSecond
+                    || derivType == DERIV::StandardFourth,
+                "standardDerivative only works for derivType in {Standard, "
+                "StandardSecond, StandardFourth}");
+
+  auto* localmesh = f.getMesh();
+
+  ASSERT1(result.getMesh() == localmesh);
+  // Check that the input variable has data
+  ASSERT1(f.isAllocated());
+
+  // Check the input data is valid
+  {
+    TRACE("Checking input");
+    checkData(f, region);
+  }
+
+  // Define properties of this approach
+  const CELL_LOC allowedStaggerLoc = localmesh->getAllowedStaggerLoc(direction);
+
+  // Handle the staggering
+  const CELL_LOC inloc = f.getLocation(); // Input location
+  const CELL_LOC outloc = result.getLocation();
+  const STAGGER stagger = localmesh->getStagger(inloc, outloc, allowedStaggerLoc);
+
+  result.allocate();
+
+  // Check for early exit
+  const int nPoint = localmesh->getNpoints(direction);
+
+  if (nPoint == 1) {
+    BOUT_FOR(i, result.getRegion(region)) { result[i] = 0.0; }
+    return;
+  }
+
+  // Lookup the method
+  const auto& derivativeMethod = DerivativeStore<T>::getInstance().getStandardDerivative(
+      method, direction, stagger, derivType);
+
+  // Apply method
+  derivativeMethod(f, result, region);
+
+  // Check the result is valid
+  {
+    TRACE("Checking result");
+    checkData(result, region);
+  }
+}
+
 /// The main kernel used for all standard derivatives
 template <typename T, DIRECTION direction, DERIV derivType>
 T standardDerivative(const T& f, CELL_LOC outloc, const std::string& method,
@@ -150,7 +288,7 @@ T standardDerivative(const T& f, CELL_LOC outloc, const std::string& method,
   }
 
   // Lookup the method
-  auto derivativeMethod = DerivativeStore<T>::getInstance().getStandardDerivative(
+  const auto& derivativeMethod = DerivativeStore<T>::getInstance().getStandardDerivative(
       method, direction, stagger, derivType);
 
   // Create the result field
@@ -168,6 +306,250 @@ T standardDerivative(const T& f, CELL_LOC outloc, const std::string& method,
   return result;
 }
 
+namespace detail {
+/// Apply each of \p kernels to \p f, and to \p vel for upwind
+/// kernels, putting the results in \p results. This is a single pass
+/// over \p region, loading each stencil once
+template <DIRECTION direction, int nGuards, typename T>
+void applyKernels(
+    const T* vel, const T& f,
+    const std::vector<const typename DerivativeStore<T>::stencilKernel*>& kernels,
+    const std::vector<T*>& results, const std::string& region) {
+  const std::size_t nKernels = kernels.size();
+  BOUT_FOR(i, f.getRegion(region)) {
+    const stencil s = populateStencil<direction, STAGGER::None, nGuards>(f, i);
+    for (std::size_t k = 0; k < nKernels; ++k) {
+      (*results[k])[i] = (kernels[k]->standard != nullptr)
+                             ? kernels[k]->standard(s)
+                             : kernels[k]->upwind((*vel)[i], s);
+    }
+  }
+}
+
+/// Apply \p kernel to each of \p fields in a single pass over \p region
+template <DIRECTION direction, int nGuards, typename T>
+void applyKernel(const typename DerivativeStore<T>::stencilKernel& kernel,
+                 const std::vector<const T*>& fields, std::vector<T>& results,
+                 const std::string& region) {
+  const std::size_t nFields = fields.size();
+  BOUT_FOR(i, fields.front()->getRegion(region)) {
+    for (std::size_t k = 0; k < nFields; ++k) {
+      results[k][i] =
+          kernel.standard(populateStencil<direction, STAGGER::None, nGuards>(*fields[k], i));
+    }
+  }
+}
+
+/// Implementation of multiple: \p vel may be nullptr if there are no
+/// upwind derivatives
+template <typename T, DIRECTION direction>
+std::vector<T> multiple(const T* vel, const T& f, const std::vector<DERIV>& derivTypes,
+                        const std::string& method, const std::string& region) {
+  AUTO_TRACE();
+
+  static_assert(bout::utils::is_Field2D<T>::value || bout::utils::is_Field3D<T>::value,
+                "multiple only works on Field2D or Field3D input");
+
+  auto* localmesh = f.getMesh();
+
+  // Check that the input variables have data
+  ASSERT1(f.isAllocated());
+  if (vel != nullptr) {
+    ASSERT1(vel->getMesh() == localmesh);
+    ASSERT1(vel->isAllocated());
+    ASSERT1(vel->getLocation() == f.getLocation());
+  }
+
+  // Check the input data is valid
+  {
+    TRACE("Checking inputs");
+    checkData(f, region);
+    if (vel != nullptr) {
+      checkData(*vel, region);
+    }
+  }
+
+  for (const auto derivType : derivTypes) {
+    if (derivType == DERIV::Upwind) {
+      if (vel == nullptr) {
+        throw BoutException("multiple: Upwind derivatives need a velocity");
+      }
+    } else if (derivType != DERIV::Standard and derivType != DERIV::StandardSecond
+               and derivType != DERIV::StandardFourth) {
+      throw BoutException("multiple: Derivative type %s is not supported",
+                          toString(derivType).c_str());
+    }
+  }
+
+  // Check for early exit
+  if (localmesh->getNpoints(direction) == 1) {
+    std::vector<T> results;
+    for (std::size_t k = 0; k < derivTypes.size(); ++k) {
+      results.push_back(zeroFrom(f));
+    }
+    return results;
+  }
+
+  using stencilKernel = typename DerivativeStore<T>::stencilKernel;
+  const auto& store = DerivativeStore<T>::getInstance();
+
+  std::vector<T> results;
+  // Reserve so that the pointers into results stay valid
+  results.reserve(derivTypes.size());
+
+  // The stencil-based methods, which can be done in one pass
+  std::vector<const stencilKernel*> kernels;
+  std::vector<T*> kernelResults;
+  int nGuards = 1;
+
+  for (const auto derivType : derivTypes) {
+    results.push_back(emptyFrom(f));
+    auto& result = results.back();
+
+    const auto* kernel = store.getKernel(method, direction, STAGGER::None, derivType);
+    if (kernel == nullptr) {
+      // Not stencil-based, so calculate this one on its own
+      if (derivType == DERIV::Upwind) {
+        store.getFlowDerivative(method, direction, STAGGER::None, derivType)(*vel, f,
+                                                                             result, region);
+      } else {
+        store.getStandardDerivative(method, direction, STAGGER::None, derivType)(
+            f, result, region);
+      }
+      continue;
+    }
+
+    kernels.push_back(kernel);
+    kernelResults.push_back(&result);
+    nGuards = std::max(nGuards, kernel->nGuards);
+  }
+
+  if (not kernels.empty()) {
+    ASSERT2(localmesh->getNguard(direction) >= nGuards);
+    if (nGuards == 1) {
+      applyKernels<direction, 1>(vel, f, kernels, kernelResults, region);
+    } else {
+      applyKernels<direction, 2>(vel, f, kernels, kernelResults, region);
+    }
+  }
+
+  // Check the results are valid
+  {
+    TRACE("Checking results");
+    for (const auto& result : results) {
+      checkData(result, region);
+    }
+  }
+
+  return results;
+}
+} // namespace detail
+
+/// Calculate several derivatives of \p f in \p direction, in a
+/// single pass over \p region. The stencil around each point is
+/// loaded once and used for all of the derivatives, which saves
+/// memory traffic compared to calling e.g. DDX and D2DX2 separately.
+///
+/// Each of \p derivTypes must be one of Standard, StandardSecond or
+/// StandardFourth. The results are returned in the same order, at
+/// the location of \p f. \p method is used for every derivative
+/// type; "DEFAULT" picks the default for each type. Methods which
+/// are not stencil-based (e.g. FFT) are calculated separately.
+///
+/// Like standardDerivative, this does no transforms: Y derivatives
+/// need either field-aligned input, or DIRECTION::YOrthogonal and
+/// input with parallel slices
+template <typename T, DIRECTION direction>
+std::vector<T> multiple(const T& f, const std::vector<DERIV>& derivTypes,
+                        const std::string& method = "DEFAULT",
+                        const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  return detail::multiple<T, direction>(nullptr, f, derivTypes, method, region);
+}
+
+/// As above, but \p derivTypes may also include Upwind, which uses
+/// the velocity \p vel. This shares the stencil of \p f between
+/// e.g. a diffusion and an advection term
+template <typename T, DIRECTION direction>
+std::vector<T> multiple(const T& vel, const T& f, const std::vector<DERIV>& derivTypes,
+                        const std::string& method = "DEFAULT",
+                        const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  return detail::multiple<T, direction>(&vel, f, derivTypes, method, region);
+}
+
+/// Calculate the same standard derivative of each of \p fields in a
+/// single pass over \p region. The fields must be on the same mesh,
+/// and each result is at the location of its input
+template <typename T, DIRECTION direction, DERIV derivType>
+std::vector<T> multipleFields(const std::vector<const T*>& fields,
+                              const std::string& method = "DEFAULT",
+                              const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+
+  static_assert(bout::utils::is_Field2D<T>::value || bout::utils::is_Field3D<T>::value,
+                "multipleFields only works on Field2D or Field3D input");
+
+  static_assert(derivType == DERIV::Standard || derivType == DERIV::StandardSecond
+                    || derivType == DERIV::StandardFourth,
+                "multipleFields only works for derivType in {Standard, "
+                "StandardSecond, StandardFourth}");
+
+  if (fields.empty()) {
+    return {};
+  }
+
+  auto* localmesh = fields.front()->getMesh();
+
+  std::vector<T> results;
+  results.reserve(fields.size());
+  {
+    TRACE("Checking inputs");
+    for (const auto* f : fields) {
+      ASSERT1(f->getMesh() == localmesh);
+      ASSERT1(f->isAllocated());
+      checkData(*f, region);
+      results.push_back(emptyFrom(*f));
+    }
+  }
+
+  // Check for early exit
+  if (localmesh->getNpoints(direction) == 1) {
+    for (auto& result : results) {
+      result = 0.0;
+    }
+    return results;
+  }
+
+  const auto& store = DerivativeStore<T>::getInstance();
+  const auto* kernel = store.getKernel(method, direction, STAGGER::None, derivType);
+
+  if (kernel == nullptr) {
+    // Not stencil-based, so calculate each field on its own
+    const auto& derivativeMethod =
+        store.getStandardDerivative(method, direction, STAGGER::None, derivType);
+    for (std::size_t k = 0; k < fields.size(); ++k) {
+      derivativeMethod(*fields[k], results[k], region);
+    }
+  } else {
+    ASSERT2(localmesh->getNguard(direction) >= kernel->nGuards);
+    if (kernel->nGuards == 1) {
+      detail::applyKernel<direction, 1>(*kernel, fields, results, region);
+    } else {
+      detail::applyKernel<direction, 2>(*kernel, fields, results, region);
+    }
+  }
+
+  {
+    TRACE("Checking results");
+    for (const auto& result : results) {
+      checkData(result, region);
+    }
+  }
+
+  return results;
+}
+
 ////// STANDARD OPERATORS
 
 ////////////// X DERIVATIVE /////////////////
@@ -194,6 +576,34 @@ T D4DX4(const T& f, CELL_LOC outloc = CELL_DEFAULT, const std::string& method =
                                                                     region);
 }
 
+/// Versions of the X and Z derivatives which calculate into an
+/// existing field \p result, only on \p region. Used to overlap
+/// calculations with communications, see Mesh::startCommunicate.
+///
+/// There are no Y versions, as these may need parallel slices or
+/// field-aligned transforms, which need all the guard cells
+
+template <typename T>
+void DDX(const T& f, T& result, const std::string& method = "DEFAULT",
+         const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  standardDerivative<T, DIRECTION::X, DERIV::Standard>(f, result, method, region);
+}
+
+template <typename T>
+void D2DX2(const T& f, T& result, const std::string& method = "DEFAULT",
+           const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  standardDerivative<T, DIRECTION::X, DERIV::StandardSecond>(f, result, method, region);
+}
+
+template <typename T>
+void D4DX4(const T& f, T& result, const std::string& method = "DEFAULT",
+           const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  standardDerivative<T, DIRECTION::X, DERIV::StandardFourth>(f, result, method, region);
+}
+
 ////////////// Y DERIVATIVE /////////////////
 
 template <typename T>
@@ -271,6 +681,27 @@ T D4DZ4(const T& f, CELL_LOC outloc = CELL_DEFAULT, const std::string& method =
                                                                     region);
 }
 
+template <typename T>
+void DDZ(const T& f, T& result, const std::string& method = "DEFAULT",
+         const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  standardDerivative<T, DIRECTION::Z, DERIV::Standard>(f, result, method, region);
+}
+
+template <typename T>
+void D2DZ2(const T& f, T& result, const std::string& method = "DEFAULT",
+           const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  standardDerivative<T, DIRECTION::Z, DERIV::StandardSecond>(f, result, method, region);
+}
+
+template <typename T>
+void D4DZ4(const T& f, T& result, const std::string& method = "DEFAULT",
+           const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  standardDerivative<T, DIRECTION::Z, DERIV::StandardFourth>(f, result, method, region);
+}
+
 ////// ADVECTION AND FLUX OPERATORS
 
 /// Advection operator in index space in [] direction
@@ -302,6 +733,20 @@ T FDDX(const T& vel, const T& f, CELL_LOC outloc = CELL_DEFAULT,
   return flowDerivative<T, DIRECTION::X, DERIV::Flux>(vel, f, outloc, method, region);
 }
 
+template <typename T>
+void VDDX(const T& vel, const T& f, T& result, const std::string& method = "DEFAULT",
+          const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  flowDerivative<T, DIRECTION::X, DERIV::Upwind>(vel, f, result, method, region);
+}
+
+template <typename T>
+void FDDX(const T& vel, const T& f, T& result, const std::string& method = "DEFAULT",
+          const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  flowDerivative<T, DIRECTION::X, DERIV::Flux>(vel, f, result, method, region);
+}
+
 ////////////// Y DERIVATIVE /////////////////
 
 template <typename T>
@@ -397,6 +842,20 @@ T FDDZ(const T& vel, const T& f, CELL_LOC outloc = CELL_DEFAULT,
   return flowDerivative<T, DIRECTION::Z, DERIV::Flux>(vel, f, outloc, method, region);
 }
 
+template <typename T>
+void VDDZ(const T& vel, const T& f, T& result, const std::string& method = "DEFAULT",
+          const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  flowDerivative<T, DIRECTION::Z, DERIV::Upwind>(vel, f, result, method, region);
+}
+
+template <typename T>
+void FDDZ(const T& vel, const T& f, T& result, const std::string& method = "DEFAULT",
+          const std::string& region = "RGN_NOBNDRY") {
+  AUTO_TRACE();
+  flowDerivative<T, DIRECTION::Z, DERIV::Flux>(vel, f, result, method, region);
+}
+
 } // Namespace index
 } // Namespace derivatives
 } // Namespace bout
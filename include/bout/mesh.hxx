@@ -262,6 +262,32 @@ class Mesh {
    */
   void communicate(FieldPerp &f); 
 
+  /// Start communicating a group of fields, without waiting for the
+  /// guard cells to arrive. This allows calculations to be overlapped
+  /// with communications: points in the returned "RGN_INTERIOR"
+  /// region are far enough from the guard cells that stencils of up
+  /// to the guard cell width don't use them. The remaining points of
+  /// "RGN_NOBNDRY" are in "RGN_SHELL", and can be calculated after
+  /// finishCommunicate().
+  ///
+  /// Example
+  /// -------
+  ///
+  ///     comm_handle handle = mesh->startCommunicate(group);
+  ///     calculateOn(mesh->getRegion3D("RGN_INTERIOR"));
+  ///     mesh->finishCommunicate(group, handle);
+  ///     calculateOn(mesh->getRegion3D("RGN_SHELL"));
+  ///
+  /// @param[in] g  The group of fields to communicate. Must not be
+  ///               changed until finishCommunicate() is called
+  /// @returns handle to be passed to finishCommunicate()
+  comm_handle startCommunicate(FieldGroup &g);
+
+  /// Wait for communications started by startCommunicate() to
+  /// finish, and calculate the parallel slices if needed. After
+  /// this, \p g is in the same state as after communicate(g)
+  void finishCommunicate(FieldGroup &g, comm_handle handle);
+
   /*!
    * Send a list of FieldData objects
    * Packs arguments into a FieldGroup and passes
@@ -871,6 +897,9 @@ class Mesh {
   // Can be set in the input file and the global default is set by,
   // MAXREGIONBLOCKSIZE in include/bout/region.hxx
   int maxregionblocksize;
+
+  // The number of points in y in each tile of RGN_NOBNDRY_TILED
+  int regiontiley{8};
   
   /// Get the named region from the region_map for the data iterator
   ///
@@ -928,7 +957,11 @@ class Mesh {
   
   /// Create the default regions for the data iterator
   ///
-  /// Creates RGN_{ALL,NOBNDRY,NOX,NOY}
+  /// Creates RGN_{ALL,NOBNDRY,NOX,NOY,NOZ,GUARDS,XGUARDS,YGUARDS,ZGUARDS,NOCORNERS},
+  /// and RGN_{INTERIOR,SHELL} which split RGN_NOBNDRY into points
+  /// which do and don't need guard cells for stencils up to the guard cell width.
+  /// Also the 3D RGN_NOBNDRY_TILED, the points of RGN_NOBNDRY in tiles of
+  /// regiontiley points in y (see Region::asTiled)
   void createDefaultRegions();
     
 protected:
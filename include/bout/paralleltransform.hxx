@@ -10,6 +10,8 @@
 #include "field3d.hxx"
 #include "unused.hxx"
 
+#include <vector>
+
 class Mesh;
 
 /*!
@@ -28,6 +30,15 @@ public:
   /// Given a 3D field, calculate and set the Y up down fields
   virtual void calcParallelSlices(Field3D &f) = 0;
 
+  /// Calculate and set the Y up down fields of several 3D fields at
+  /// once. Transforms which can share work between fields should
+  /// override this; by default each field is done separately
+  virtual void calcParallelSlicesMany(const std::vector<Field3D*>& fields) {
+    for (auto* f : fields) {
+      calcParallelSlices(*f);
+    }
+  }
+
   [[deprecated("Please use ParallelTransform::calcParallelSlices instead")]]
   void calcYupYdown(Field3D& f) {
     calcParallelSlices(f);
@@ -162,7 +173,11 @@ protected:
 class ShiftedMetric : public ParallelTransform {
 public:
   ShiftedMetric() = delete;
-  ShiftedMetric(Mesh& mesh, CELL_LOC location, Field2D zShift, BoutReal zlength_in);
+  /// If \p compact_phases is true, only the shift angle of each
+  /// parallel slice is stored, and the phases are computed as they
+  /// are needed, rather than storing every phase for every point
+  ShiftedMetric(Mesh& mesh, CELL_LOC location, Field2D zShift, BoutReal zlength_in,
+                bool compact_phases = false);
 
   /*!
    * Calculates the yup() and ydown() fields of f
@@ -170,6 +185,13 @@ public:
    */
   void calcParallelSlices(Field3D& f) override;
 
+  /*!
+   * Calculates the yup() and ydown() fields of several fields. Each
+   * Z line is transformed once, all the parallel slice phases are
+   * applied to it, and the inverse transforms are batched.
+   */
+  void calcParallelSlicesMany(const std::vector<Field3D*>& fields) override;
+
   /*!
    * Uses FFTs and a phase shift to align the grid points
    * with the y coordinate (along magnetic field usually).
@@ -220,6 +242,10 @@ private:
 
   int nmodes;
 
+  /// Store only the shift angle of the parallel slices, rather than
+  /// the phase for every mode
+  bool compact_phases{false};
+
   Tensor<dcomplex> toAlignedPhs;   ///< Cache of phase shifts for transforming from X-Z
                                    /// orthogonal coordinates to field-aligned coordinates
   Tensor<dcomplex> fromAlignedPhs; ///< Cache of phase shifts for transforming from
@@ -228,7 +254,11 @@ private:
 
   /// Helper POD for parallel slice phase shifts
   struct ParallelSlicePhase {
+    /// Phase for each mode at each (x, y). Not allocated if
+    /// compact_phases is true
     Tensor<dcomplex> phase_shift;
+    /// Shift in z angle at each (x, y), used if compact_phases is true
+    Matrix<BoutReal> shift_angle;
     int y_offset;
   };
 
@@ -312,6 +342,12 @@ private:
   /// the parallel slices using zShift
   void cachePhases();
 
+  /// Apply the phase shift of parallel slice \p phase at (\p ix, \p iy)
+  /// to the Fourier modes \p in, putting the result in \p out. The
+  /// zeroth mode is copied unchanged
+  void shiftSliceModes(const ParallelSlicePhase& phase, int ix, int iy,
+                       const dcomplex* in, dcomplex* out) const;
+
   /// Shift a 3D field \p f in Z to all the parallel slices in \p phases
   ///
   /// @param[in] f      The field to shift
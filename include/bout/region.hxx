@@ -43,6 +43,7 @@
 #define __REGION_H__
 
 #include <algorithm>
+#include <mutex>
 #include <ostream>
 #include <type_traits>
 #include <utility>
@@ -424,6 +425,11 @@ inline std::ostream &operator<<(std::ostream &out, const RegionStats &stats){
 /// be more efficient, although it requires a bit more set up. The
 /// helper macro BOUT_FOR is provided to simplify things.
 ///
+/// Only the blocks are stored. The flattened vector of indices is
+/// built from them the first time it is needed, by begin(), end() or
+/// getIndices(), so a Region only used through BOUT_FOR takes memory
+/// proportional to the number of blocks rather than of points.
+///
 /// Example
 /// -------
 ///
@@ -527,16 +533,16 @@ public:
     }
 #endif
     
-    indices = createRegionIndices(xstart, xend, ystart, yend, zstart, zend, ny, nz);
-    blocks = getContiguousBlocks(maxregionblocksize);
+    setBlocks(createRegionBlocks(xstart, xend, ystart, yend, zstart, zend, ny, nz,
+                                 maxregionblocksize));
   };
 
-  Region<T>(RegionIndices &indices, int maxregionblocksize = MAXREGIONBLOCKSIZE) : indices(indices) {
-    blocks = getContiguousBlocks(maxregionblocksize);
+  Region<T>(RegionIndices &indices, int maxregionblocksize = MAXREGIONBLOCKSIZE) {
+    setIndices(indices, maxregionblocksize);
   };
 
-  Region<T>(ContiguousBlocks &blocks) : blocks(blocks) {
-    indices = getRegionIndices();
+  Region<T>(ContiguousBlocks &blocks) {
+    setBlocks(blocks);
   };
 
   /// Destructor
@@ -547,32 +553,37 @@ public:
   ///
   /// Note that if the indices are altered using these iterators, the
   /// blocks may become out of sync and will need to manually updated
-  typename RegionIndices::iterator begin() { return std::begin(indices); };
-  typename RegionIndices::const_iterator begin() const { return std::begin(indices); };
-  typename RegionIndices::const_iterator cbegin() const { return indices.cbegin(); };
-  typename RegionIndices::iterator end() { return std::end(indices); };
-  typename RegionIndices::const_iterator end() const { return std::end(indices); };
-  typename RegionIndices::const_iterator cend() const { return indices.cend(); };
+  typename RegionIndices::iterator begin() { return std::begin(buildIndices()); };
+  typename RegionIndices::const_iterator begin() const { return std::begin(buildIndices()); };
+  typename RegionIndices::const_iterator cbegin() const { return buildIndices().cbegin(); };
+  typename RegionIndices::iterator end() { return std::end(buildIndices()); };
+  typename RegionIndices::const_iterator end() const { return std::end(buildIndices()); };
+  typename RegionIndices::const_iterator cend() const { return buildIndices().cend(); };
 
   const ContiguousBlocks &getBlocks() const { return blocks; };
-  const RegionIndices &getIndices() const { return indices; };
+  const RegionIndices &getIndices() const { return buildIndices(); };
 
   /// Set the indices and ensure blocks updated
-  void setIndices (RegionIndices &indicesIn, int maxregionblocksize = MAXREGIONBLOCKSIZE) {
-    indices = indicesIn;
-    blocks = getContiguousBlocks(maxregionblocksize);
+  void setIndices (const RegionIndices &indicesIn, int maxregionblocksize = MAXREGIONBLOCKSIZE) {
+    setBlocks(getContiguousBlocks(indicesIn, maxregionblocksize));
   };
 
   /// Set the blocks and ensure indices updated
-  void setBlocks (ContiguousBlocks &blocksIn) {
+  void setBlocks (const ContiguousBlocks &blocksIn) {
     blocks = blocksIn;
-    indices = getRegionIndices();
+    npoints = 0;
+    for (const auto& block : blocks) {
+      npoints += block.second.ind - block.first.ind;
+    }
+    indices.clear();
+    indices.shrink_to_fit();
+    have_indices = false;
   };
 
   /// Return a new Region that has the same indices as this one but
   /// ensures the indices are sorted.
   Region<T> asSorted(){
-    auto sortedIndices = getIndices();
+    auto sortedIndices = copyIndices();
     std::sort(std::begin(sortedIndices), std::end(sortedIndices));
     return Region<T>(sortedIndices);
   };
@@ -590,7 +601,7 @@ public:
     // As we don't really expect a lot of duplicates this approach should be
     // OK. An alternative is to make a std::set from the indices and then
     // convert back to a vector, but this is typically more expensive.
-    auto sortedIndices = getIndices();
+    auto sortedIndices = copyIndices();
     std::sort(std::begin(sortedIndices), std::end(sortedIndices));
     // Get iterator pointing at the end of the unique points
     auto newEnd = std::unique(std::begin(sortedIndices), std::end(sortedIndices));
@@ -610,12 +621,12 @@ public:
   Region<T> mask(const Region<T> & maskRegion){
     // Get mask indices and sort as we're going to be searching through
     // this vector so if it's sorted we can be more efficient
-    auto maskIndices = maskRegion.getIndices();
+    auto maskIndices = maskRegion.copyIndices();
     std::sort(std::begin(maskIndices), std::end(maskIndices));
 
     // Get the current set of indices that we're going to mask and then
     // use to create the result region.
-    auto currentIndices = getIndices();
+    auto currentIndices = copyIndices();
 
     // Lambda that returns true/false depending if the passed value is in maskIndices
     // With C++14 T can be auto instead
@@ -649,7 +660,7 @@ public:
       return *this;
     }
 
-    auto oldInd = getIndices();
+    auto oldInd = copyIndices();
     RegionIndices newInd(oldInd.size());
 
     for (unsigned int i = 0; i < oldInd.size(); i++) {
@@ -676,7 +687,7 @@ public:
     if ( shift < 0 ){
       return periodicShift(period+shift, period);
     }
-    auto newInd = getIndices();
+    auto newInd = copyIndices();
 
     // The calculation of the periodic shifted index is as follows
     //   localPos = index + shift % period;  // Find the shifted position within the period
@@ -695,7 +706,69 @@ public:
 
   /// Number of indices (possibly repeated)
   unsigned int size() const {
-    return indices.size();
+    return npoints;
+  }
+
+  /// A copy of the indices. Unlike getIndices(), this doesn't keep
+  /// the flattened indices in the Region if they weren't already
+  RegionIndices copyIndices() const {
+    {
+      std::lock_guard<std::mutex> lock(indicesMutex());
+      if (have_indices) {
+        return indices;
+      }
+    }
+    return getRegionIndices();
+  }
+
+  /// Return a copy of this Region which visits the same points in
+  /// tiles of \p tile_y points in y: every x in one tile, then every
+  /// x in the next. When a stencil in x reads the lines at x - 1 and
+  /// x + 1, they were used recently and are more likely to still be in
+  /// cache. Only the order of the blocks changes, and blocks which
+  /// cross from one tile (or x) to the next are split.
+  Region<T> asTiled(int tile_y) const {
+    ASSERT1(tile_y > 0);
+
+    struct TiledBlock {
+      int tile, x;
+      ContiguousBlock block;
+    };
+    std::vector<TiledBlock> tiled;
+    tiled.reserve(blocks.size());
+
+    for (const auto& block : blocks) {
+      auto start = block.first;
+      int tile = start.y() / tile_y;
+      int x = start.x();
+      for (auto index = block.first; index < block.second; ++index) {
+        const int index_tile = index.y() / tile_y;
+        const int index_x = index.x();
+        if (index_tile != tile || index_x != x) {
+          tiled.push_back({tile, x, {start, index}});
+          start = index;
+          tile = index_tile;
+          x = index_x;
+        }
+      }
+      tiled.push_back({tile, x, {start, block.second}});
+    }
+
+    // Stable, so blocks with the same tile and x keep their order
+    std::stable_sort(std::begin(tiled), std::end(tiled),
+                     [](const TiledBlock& a, const TiledBlock& b) {
+                       return a.tile < b.tile || (a.tile == b.tile && a.x < b.x);
+                     });
+
+    ContiguousBlocks tiled_blocks;
+    tiled_blocks.reserve(tiled.size());
+    for (const auto& t : tiled) {
+      tiled_blocks.push_back(t.block);
+    }
+    Region<T> result(tiled_blocks);
+    result.ny = ny;
+    result.nz = nz;
+    return result;
   }
 
   /// Returns a RegionStats struct desribing the region
@@ -740,15 +813,39 @@ public:
   // sorted this would prevent this usage.
 
 private:
-  RegionIndices indices;   //< Flattened indices
-  ContiguousBlocks blocks; //< Contiguous sections of flattened indices
-  int ny = -1;             //< Size of y dimension
-  int nz = -1;             //< Size of z dimension
+  ContiguousBlocks blocks;       //< Contiguous sections of flattened indices
+  unsigned int npoints = 0;      //< Number of indices in blocks
+  mutable RegionIndices indices; //< Flattened indices, if have_indices
+  mutable bool have_indices = false;
+  int ny = -1;                   //< Size of y dimension
+  int nz = -1;                   //< Size of z dimension
+
+  /// Serialises building the indices, as begin() etc. can be
+  /// called from several threads at once
+  static std::mutex& indicesMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
 
-  /// Helper function to create a RegionIndices, given the start and end
-  /// points in x, y, z, and the total y, z lengths
-  inline RegionIndices createRegionIndices(int xstart, int xend, int ystart, int yend,
-                                           int zstart, int zend, int ny, int nz) {
+  /// Build the flattened indices from the blocks, if they haven't
+  /// been already, and return them
+  RegionIndices& buildIndices() const {
+    std::lock_guard<std::mutex> lock(indicesMutex());
+    if (!have_indices) {
+      indices = getRegionIndices();
+      have_indices = true;
+    }
+    return indices;
+  }
+
+  /// Helper function to create the ContiguousBlocks, given the start
+  /// and end points in x, y, z, and the total y, z lengths. This
+  /// gives the same blocks as getContiguousBlocks would for the
+  /// indices of the box, without making the indices
+  ContiguousBlocks createRegionBlocks(int xstart, int xend, int ystart, int yend,
+                                      int zstart, int zend, int ny, int nz,
+                                      int maxregionblocksize) const {
+    ASSERT1(maxregionblocksize > 0);
 
     if ((xend + 1 <= xstart) ||
         (yend + 1 <= ystart) ||
@@ -760,36 +857,36 @@ private:
     ASSERT1(ny > 0);
     ASSERT1(nz > 0);
 
-    int len = (xend - xstart + 1) * (yend - ystart + 1) * (zend - zstart + 1);
-    ASSERT1(len > 0);
-    // Guard against invalid length ranges
-    if (len <= 0 ) return {};
-
-    RegionIndices region(len, {-1, ny, nz});
-
-    int x = xstart;
-    int y = ystart;
-    int z = zstart;
+    ContiguousBlocks result;
 
-    bool done = false;
-    int j = -1;
-    while (!done) {
-      j++;
-      region[j].ind = (x * ny + y) * nz + z;
-      if (x == xend && y == yend && z == zend) {
-        done = true;
+    // Each (x, y) gives a line of z indices. Consecutive lines form a
+    // single run of indices if there is no gap between them, which is
+    // the case if the whole of z (and then y) is included. Runs are
+    // then split into blocks of at most maxregionblocksize
+    const int line_length = zend - zstart + 1;
+    int run_start = 0;
+    int run_end = -1;
+
+    auto addRun = [&]() {
+      for (int start = run_start; start < run_end; start += maxregionblocksize) {
+        result.push_back({T{start, ny, nz},
+                          T{std::min(start + maxregionblocksize, run_end), ny, nz}});
       }
-      ++z;
-      if (z > zend) {
-        z = zstart;
-        ++y;
-        if (y > yend) {
-          y = ystart;
-          ++x;
+    };
+
+    for (int x = xstart; x <= xend; ++x) {
+      for (int y = ystart; y <= yend; ++y) {
+        const int line_start = (x * ny + y) * nz + zstart;
+        if (line_start != run_end) {
+          addRun();
+          run_start = line_start;
         }
+        run_end = line_start + line_length;
       }
     }
-    return region;
+    addRun();
+
+    return result;
   }
 
 
@@ -797,20 +894,21 @@ private:
   /// Limits the maximum size of any contiguous block to maxBlockSize.
   /// A contiguous block is described by the inclusive start and the exclusive end
   /// of the contiguous block.
-  ContiguousBlocks getContiguousBlocks(int maxregionblocksize) const {
+  static ContiguousBlocks getContiguousBlocks(const RegionIndices& indices,
+                                              int maxregionblocksize) {
     ASSERT1(maxregionblocksize>0);
-    const int npoints = indices.size();
+    const int nindices = indices.size();
     ContiguousBlocks result;
     int index = 0; // Index within vector of indices
 
-    while (index < npoints) {
+    while (index < nindices) {
       const T startIndex = indices[index];
       int count =
           1; // We will always have at least startPair in the block so count starts at 1
 
       // Consider if the next point should be added to this block
       for (index++; count < maxregionblocksize; index++) {
-        if (index >= npoints) {
+        if (index >= nindices) {
           break;
         }
         if ((indices[index].ind - indices[index - 1].ind) == 1) {
@@ -833,8 +931,9 @@ private:
 
 
   /// Constructs the vector of indices from the stored blocks information
-  RegionIndices getRegionIndices() {
+  RegionIndices getRegionIndices() const {
     RegionIndices result;
+    result.reserve(npoints);
     // This has to be serial unless we can make result large enough in advance
     // otherwise there will be a race between threads to extend the vector
     BOUT_FOR_SERIAL(curInd, (*this)) {
@@ -875,8 +974,8 @@ Region<T> mask(const Region<T> &region, const Region<T> &mask) {
 /// the duplicates.
 template<typename T>
 Region<T> operator+(const Region<T> &lhs, const Region<T> &rhs){
-  auto indices = lhs.getIndices(); // Indices is a copy of the indices
-  auto indicesRhs = rhs.getIndices();
+  auto indices = lhs.copyIndices();
+  auto indicesRhs = rhs.copyIndices();
   indices.insert(std::end(indices), std::begin(indicesRhs), std::end(indicesRhs));
   return Region<T>(indices);
 }
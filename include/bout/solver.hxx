@@ -345,8 +345,28 @@ protected:
   /// This processor's index
   int MYPE{0};
 
+  /// Is each variable stored contiguously in the state vector, rather
+  /// than interleaving all the variables at each point? Set by the
+  /// `field_major` option in init()
+  bool field_major{false};
+  /// Can this solver use a field-major state vector? Should only be
+  /// set by solvers which don't depend on the order of the state
+  bool canUseFieldMajor{false};
+  /// Do the evolving fields use the state vector passed to load_vars
+  /// directly, rather than a copy? Set by the `zero_copy` option in
+  /// init(). The state then contains whole fields, including guard cells
+  bool zero_copy{false};
+
   /// Calculate the number of evolving variables on this processor
   int getLocalN();
+  /// The number of points evolved on this processor. This is less
+  /// than getLocalN with zero_copy, as the state also has guard cells
+  int getLocalNEvolving();
+  /// The weight of each entry of the state in error norms: one if it
+  /// is evolved, zero for the guard cells and unevolved boundary cells
+  /// stored with zero_copy. These change in the RHS function, so
+  /// would otherwise be counted as errors
+  Array<BoutReal> getErrorWeights();
 
   /// A structure to hold an evolving variable
   template <class T>
@@ -472,6 +492,9 @@ protected:
   void save_vars(BoutReal* udata);
   void save_derivs(BoutReal* dudata);
   void set_id(BoutReal* udata);
+  /// Give evolving fields their own copy of their data, so that they
+  /// remain valid after the solver's state has been deleted
+  void detachVars();
 
   /// Returns a Field3D containing the global indices
   Field3D globalIndex(int localStart);
@@ -547,9 +570,38 @@ private:
   /// Should be run after user RHS is called
   void post_rhs(BoutReal t);
 
+  /// Where each variable is stored in the state vector
+  struct StateLayout {
+    bool built{false};
+    /// 2D index of each evolving point, boundary points first
+    std::vector<int> points;
+    /// Offset in the state vector of each 2D variable at each point,
+    /// or -1 if it isn't evolved there. Indexed by point * f2d.size() + variable
+    std::vector<int> offset2d;
+    /// Offset of z = 0 for each 3D variable, indexed like offset2d
+    std::vector<int> offset3d;
+    /// Distance in the state vector between consecutive z points of
+    /// 3D variables, at each point
+    std::vector<int> zstride;
+    /// Number of boundary points at the start of points
+    int nbndry{0};
+    /// 2D index of each point which is never evolved
+    std::vector<int> guards;
+  };
+  StateLayout state_layout;
+
+  /// Calculate state_layout. This is done on first use, after all the
+  /// variables have been added. Throws if any variable is not on the
+  /// global mesh
+  void buildStateLayout();
+
   /// Loading data from BOUT++ to/from solver
-  void loop_vars_op(Ind2D i2d, BoutReal* udata, int& p, SOLVER_VAR_OP op, bool bndry);
   void loop_vars(BoutReal* udata, SOLVER_VAR_OP op);
+  /// As loop_vars, for zero_copy, where the state contains whole fields
+  void loop_fields(BoutReal* udata, SOLVER_VAR_OP op);
+
+  /// Cached result of getLocalN
+  int cacheLocalN{-1};
 
   /// Check if a variable has already been added
   bool varAdded(const std::string& name);
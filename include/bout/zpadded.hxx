@@ -0,0 +1,69 @@
+/// Scratch copies of z-lines with periodic guard cells
+///
+/// Field3D stores each (x, y) line of z values contiguously, without z
+/// guard cells, so a z neighbour of a point has to be found with a
+/// periodic wrap. Kernels which apply a stencil along whole z-lines can
+/// instead copy each line into a ZPaddedLine, after which every z
+/// neighbour is a plain offset from the same pointer:
+///
+///     BOUT_OMP(parallel) {
+///       bout::ZPaddedLine fline(mesh->LocalNz);
+///       BOUT_FOR_INNER(i, mesh->getRegion2D("RGN_NOBNDRY")) {
+///         const BoutReal* fz = fline.load(f(i.x(), i.y()));
+///         BoutReal* rz = result(i.x(), i.y());
+///         for (int z = 0; z < mesh->LocalNz; ++z) {
+///           rz[z] = fz[z + 1] - fz[z - 1];
+///         }
+///       }
+///     }
+///
+/// The inner loop has no branches or modulo, so it can be vectorised.
+/// The buffer is small enough to stay in cache, so the copy is cheap.
+/// Make one ZPaddedLine per thread, and reuse it for every line
+
+#ifndef __ZPADDED_H__
+#define __ZPADDED_H__
+
+#include "bout/array.hxx"
+#include "bout/assert.hxx"
+#include "bout_types.hxx"
+
+#include <algorithm>
+
+namespace bout {
+
+class ZPaddedLine {
+public:
+  /// @param[in] nz      Number of points in each z-line
+  /// @param[in] nguard  Number of periodic guard cells on each side
+  ZPaddedLine(int nz, int nguard = 2) : nz(nz), nguard(nguard), data(nz + 2 * nguard) {
+    ASSERT1(nz > 0);
+    ASSERT1(nguard >= 0);
+  }
+
+  /// Copy the \p nz values starting at \p line, and fill the guard
+  /// cells by wrapping around in z. Returns a pointer to z = 0 in
+  /// the copy, which is valid from -nguard to nz - 1 + nguard, until
+  /// the next call to load
+  const BoutReal* load(const BoutReal* line) {
+    BoutReal* start = data.begin() + nguard;
+    std::copy(line, line + nz, start);
+    for (int k = 1; k <= nguard; ++k) {
+      // Use % in case there are fewer points than guard cells
+      start[-k] = line[(nz - k % nz) % nz];
+      start[nz - 1 + k] = line[(k - 1) % nz];
+    }
+    return start;
+  }
+
+  int getNguard() const { return nguard; }
+
+private:
+  const int nz;
+  const int nguard;
+  Array<BoutReal> data;
+};
+
+} // namespace bout
+
+#endif // __ZPADDED_H__
@@ -74,6 +74,7 @@ public:
     MPI_Comm_rank(c, &myp);
     if ((size != N) || (np != nprocs) || (myp != myproc))
       Nsys = 0; // Need to re-size
+    factorised = false;
     N = size;
     periodic = false;
     nprocs = np;
@@ -107,6 +108,9 @@ public:
 
   /// Set the entries in the matrix to be inverted
   ///
+  /// The elimination of the coefficients is done by the next call to
+  /// solve, and reused by later calls until the coefficients are set again
+  ///
   /// @param[in] a   Left diagonal. Should have size [nsys][N]
   ///                where N is set in the constructor or setup
   /// @param[in] b   Diagonal values. Should have size [nsys][N]
@@ -118,6 +122,7 @@ public:
 
     // Make sure correct memory arrays allocated
     allocMemory(nprocs, nsys, N);
+    factorised = false;
 
     // Fill coefficient array
     BOUT_OMP(parallel for)
@@ -186,7 +191,10 @@ public:
 
     ///////////////////////////////////////
     // Reduce local part of the matrix to interface equations
-    reduce(Nsys, N, coefs, myif);
+    if (!factorised) {
+      factorise();
+    }
+    reduceRHS();
 
     ///////////////////////////////////////
     // Gather all interface equations onto single processor
@@ -427,7 +435,7 @@ public:
 
     ///////////////////////////////////////
     // Solve local equations
-    back_solve(Nsys, N, coefs, x1, xn, x);
+    back_solve_local(x1, xn, x);
     delete[] req;
   }
 
@@ -445,6 +453,10 @@ private:
   Matrix<T> coefs; ///< Starting coefficients, rhs [Nsys, {3*coef,rhs}*N]
   Matrix<T> myif;  ///< Interface equations for this processor
 
+  bool factorised{false}; ///< Are the factors below up to date with coefs?
+  Matrix<T> upper, lower; ///< Multipliers of the rows eliminated by reduce [Nsys, N]
+  Matrix<T> gam, rbet;    ///< Factors for back-solving the local equations [Nsys, N]
+
   Matrix<T> recvbuffer; ///< Buffer for receiving from other processors
   Matrix<T> ifcs;       ///< Coefficients for interface solve
   Matrix<T> if2x2;      ///< 2x2 interface equations on this processor
@@ -479,6 +491,10 @@ private:
 
     coefs.reallocate(Nsys, 4 * N);
     myif.reallocate(Nsys, 8);
+    upper.reallocate(Nsys, N);
+    lower.reallocate(Nsys, N);
+    gam.reallocate(Nsys, N);
+    rbet.reallocate(Nsys, N);
 
     // Note: The recvbuffer is used to receive data in both stages of the solve:
     //  1. In the gather step, this processor will receive myns interface equations
@@ -588,6 +604,100 @@ private:
     // Upper system couples {-1. 0, N-1}
   }
 
+  /// Eliminate the local coefficients, as reduce does, keeping the
+  /// multipliers so that reduceRHS can do the same to each right hand
+  /// side. Also calculates the factors used by back_solve_local.
+  /// Sets the coefficients of the interface equations in myif
+  void factorise() {
+    myif.ensureUnique();
+    upper.ensureUnique();
+    lower.ensureUnique();
+    gam.ensureUnique();
+    rbet.ensureUnique();
+
+    BOUT_OMP(parallel for)
+    for (int j = 0; j < Nsys; j++) {
+      // Upper interface equation
+      for (int i = 0; i < 3; i++) {
+        myif(j, i) = coefs(j, 4 * (N - 2) + i);
+      }
+      for (int i = N - 3; i >= 0; i--) {
+        if (std::abs(myif(j, 1)) < 1e-10)
+          throw BoutException("Zero pivot in CyclicReduce::factorise");
+
+        const T beta = coefs(j, 4 * i + 2) / myif(j, 1);
+        upper(j, i) = beta;
+        myif(j, 1) = coefs(j, 4 * i + 1) - beta * myif(j, 0);
+        myif(j, 0) = coefs(j, 4 * i);
+        myif(j, 2) *= -beta;
+      }
+
+      // Lower interface equation
+      for (int i = 0; i < 3; i++) {
+        myif(j, 4 + i) = coefs(j, 4 + i);
+      }
+      for (int i = 2; i < N; i++) {
+        if (std::abs(myif(j, 4 + 1)) < 1e-10)
+          throw BoutException("Zero pivot in CyclicReduce::factorise");
+
+        const T alpha = coefs(j, 4 * i) / myif(j, 4 + 1);
+        lower(j, i) = alpha;
+        myif(j, 4 + 0) *= -alpha;
+        myif(j, 4 + 1) = coefs(j, 4 * i + 1) - alpha * myif(j, 4 + 2);
+        myif(j, 4 + 2) = coefs(j, 4 * i + 2);
+      }
+
+      // Thomas algorithm between the two ends
+      gam(j, 1) = 0.;
+      for (int i = 1; i < N - 1; i++) {
+        const T bet = coefs(j, 4 * i + 1) - coefs(j, 4 * i) * gam(j, i);
+        rbet(j, i) = T(1.) / bet;
+        gam(j, i + 1) = coefs(j, 4 * i + 2) / bet;
+      }
+    }
+    factorised = true;
+  }
+
+  /// Apply the elimination done by factorise to the right hand side,
+  /// completing the interface equations in myif
+  void reduceRHS() {
+    myif.ensureUnique();
+
+    BOUT_OMP(parallel for)
+    for (int j = 0; j < Nsys; j++) {
+      T rhs = coefs(j, 4 * (N - 2) + 3);
+      for (int i = N - 3; i >= 0; i--) {
+        rhs = coefs(j, 4 * i + 3) - upper(j, i) * rhs;
+      }
+      myif(j, 3) = rhs;
+
+      rhs = coefs(j, 4 + 3);
+      for (int i = 2; i < N; i++) {
+        rhs = coefs(j, 4 * i + 3) - lower(j, i) * rhs;
+      }
+      myif(j, 4 + 3) = rhs;
+    }
+  }
+
+  /// Back-solve the local equations from x at ends (x1, xn), using the
+  /// factors calculated by factorise
+  void back_solve_local(const Array<T>& x1, const Array<T>& xn, Matrix<T>& xa) {
+    xa.ensureUnique(); // Going to be modified, so call this outside parallel region
+
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < Nsys; i++) {
+      xa(i, 0) = x1[i];
+      for (int j = 1; j < N - 1; j++) {
+        xa(i, j) = (coefs(i, 4 * j + 3) - coefs(i, 4 * j) * xa(i, j - 1)) * rbet(i, j);
+      }
+      xa(i, N - 1) = xn[i];
+
+      for (int j = N - 2; j > 0; j--) {
+        xa(i, j) = xa(i, j) - gam(i, j + 1) * xa(i, j + 1);
+      }
+    }
+  }
+
   /// Back-solve from x at ends (x1, xn) to obtain remaining values
   /// Coefficients ordered [ns, nloc*(a,b,c,r)]
   void back_solve(int ns, int nloc, const Matrix<T>& co, const Array<T>& x1,
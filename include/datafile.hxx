@@ -16,6 +16,7 @@ class Datafile;
 
 #include "bout_types.hxx"
 #include "bout/macro_for_each.hxx"
+#include "mpi.h"
 
 #include "dataformat.hxx"
 #include "../src/fileio/impls/hdf5/h5_format.hxx"
@@ -35,6 +36,8 @@ class Vector3D;
 #include <vector>
 #include <string>
 #include <cstring>
+#include <functional>
+#include <map>
 #include <memory>
 
 /*!
@@ -61,6 +64,10 @@ class Datafile {
 
   void close();
 
+  /// Finish writing the output queued by all asynchronous Datafiles,
+  /// and stop the thread which writes it. Called by BoutFinalise
+  static void stopOutputThread();
+
   void setLowPrecision(); ///< Only output floats
   template <typename T>
   void addRepeat(T& value, std::string name) {
@@ -97,6 +104,19 @@ class Datafile {
   /// Opens, writes, closes file
   bool write(const char* filename, ...) const BOUT_FORMAT_ARGS(2, 3);
 
+  /// The processors sharing a file when aggregating
+  struct Group {
+    int aggregate_x; ///< Number of processors in X writing to each file
+    int aggregate_y; ///< Number of processors in Y writing to each file
+    int file_index;  ///< Number put into the file name
+  };
+  /// Value written to an aggregated file, given the processor's \p value
+  using GroupValue = std::function<int(int value, const Group& group)>;
+  /// When aggregating, write the integer variable \p name as the value
+  /// returned by \p func rather than the processor's value. Used by the
+  /// mesh to describe the layout of the blocks of processors
+  void setGroupValue(const std::string& name, GroupValue func);
+
   void setAttribute(const std::string &varname, const std::string &attrname, const std::string &text);
   void setAttribute(const std::string &varname, const std::string &attrname, int value);
   void setAttribute(const std::string &varname, const std::string &attrname, BoutReal value);
@@ -139,6 +159,19 @@ class Datafile {
   // Counter used in determining when next openclose required
   int flushFrequencyCounter{0};
   int flushFrequency{1}; // How many write calls do we want between openclose
+  bool async{false}; // Write from a separate thread?
+  int aggregate_x{1}; // Number of processors in X writing to each file
+  int aggregate_y{1}; // Number of processors in Y writing to each file
+
+  /// How a field variable is stored in the file
+  struct Storage {
+    int compress{0};         ///< Deflate level, from 1 to 9, or 0 for none
+    bool shuffle{true};      ///< Shuffle the bytes before compressing?
+    int significant_bits{0}; ///< Mantissa bits kept when rounding, 0 for all
+    int zmax{-1};            ///< Highest z mode of Field3Ds kept, -1 for all
+  };
+  Options* options{nullptr}; ///< Each variable can have a section with its storage
+  Storage default_storage;   ///< Storage of variables without their own section
 
   std::unique_ptr<DataFormat> file;
   size_t filenamelen;
@@ -148,6 +181,57 @@ class Datafile {
   bool appending{false};
   bool first_time{true}; // is this the first time the data will be written?
 
+  /// Copies of the variables, written in the background when async is set.
+  /// Must be destroyed before file
+  class AsyncWriter;
+  std::unique_ptr<AsyncWriter> writer;
+  bool staging{false}; ///< Are the write_* functions copying into writer?
+
+  /// Wait until the output thread has finished writing. Rethrows any
+  /// exception from writing this file. Must be called before using file
+  void sync();
+
+  /// When aggregating, the processors which write to the same file.
+  /// The first of these writes the file
+  MPI_Comm group_comm{MPI_COMM_NULL};
+  bool writes_file{true}; ///< Does this processor write to the file?
+  int file_index{0};      ///< Number put into the file name
+  int block_nx{0}, block_ny{0}; ///< Sizes of the arrays in aggregated files
+  std::vector<BoutReal> gather_buffer, block_buffer;
+
+  /// Are the files shared between processors?
+  bool aggregating() const { return aggregate_x * aggregate_y > 1; }
+  /// Set the file index and, when aggregating, the group of processors
+  /// which share the file. Called before opening the file
+  void setupGroup();
+  /// Free group_comm, which is owned by this Datafile and not shared
+  /// with copies
+  void freeGroup();
+  /// Gather an array of size LocalNx * \p ny * \p nz from each processor
+  /// in the group onto the processor writing the file, as one block of
+  /// size block_nx * \p out_ny * \p nz. Returns nullptr on other processors
+  BoutReal* gather(const BoutReal* data, int ny, int nz, int out_ny);
+  /// Integer variables written with a different value when aggregating
+  std::map<std::string, GroupValue> group_values;
+
+  std::vector<BoutReal> reduce_buffer, round_buffer;
+
+  /// Storage of the variable \p name
+  Storage getStorage(const std::string& name) const;
+  /// Number of z points stored of a Field3D, fewer than LocalNz if
+  /// storage.zmax removes some of the z modes
+  int storedNz(const Storage& storage) const;
+  /// Add field variables to the file, with the given storage
+  bool addField2D(const std::string& name, bool save_repeat, const Storage& storage);
+  bool addField3D(const std::string& name, bool save_repeat, const Storage& storage);
+  bool addFieldPerp(const std::string& name, bool save_repeat, const Storage& storage);
+  /// Keep only the z modes up to zmax of an array of size
+  /// LocalNx * LocalNy * LocalNz, resampling it onto \p nz points
+  BoutReal* reduceZ(const BoutReal* data, int zmax, int nz);
+  /// Round a copy of \p data to \p bits significant bits, so that
+  /// it can be compressed further
+  BoutReal* roundBits(const BoutReal* data, int n, int bits);
+
   /// Shallow copy, not including dataformat, therefore private
   Datafile(const Datafile& other);
 
@@ -161,6 +245,7 @@ class Datafile {
     bool covar;                   ///< For vectors, true if a covariant vector, false if contravariant
     size_t size;                  ///< Size of a stored vector or string, to check it does not change after being added
     std::string description{""};  ///< Documentation of what the variable is
+    Storage storage;              ///< How the variable is stored, for fields
   };
 
   // one set per variable type
@@ -183,9 +268,12 @@ class Datafile {
   bool write_int_vec(const std::string &name, std::vector<int> *f, bool save_repeat);
   bool write_string(const std::string &name, std::string *f, bool save_repeat);
   bool write_real(const std::string &name, BoutReal *f, bool save_repeat);
-  bool write_f2d(const std::string &name, Field2D *f, bool save_repeat);
-  bool write_f3d(const std::string &name, Field3D *f, bool save_repeat);
-  bool write_fperp(const std::string &name, FieldPerp *f, bool save_repeat);
+  bool write_f2d(const std::string &name, Field2D *f, bool save_repeat,
+                 const Storage &storage);
+  bool write_f3d(const std::string &name, Field3D *f, bool save_repeat,
+                 const Storage &storage);
+  bool write_fperp(const std::string &name, FieldPerp *f, bool save_repeat,
+                   const Storage &storage);
 
   /// Check if a variable has already been added
   bool varAdded(const std::string &name);
@@ -195,6 +283,19 @@ class Datafile {
   void* varPtr(const std::string &name);
 };
 
+namespace bout {
+/// Round \p data to \p bits significant bits of the mantissa, so that the
+/// remaining bits are zero and compress well. Infinities and NaNs are
+/// left unchanged, as is all of \p data if \p bits is not between 1
+/// and the number of mantissa bits (52)
+void roundSignificantBits(BoutReal* data, std::size_t n, int bits);
+
+/// Keep only the z modes up to \p zmax of \p nxy arrays of \p ncz points
+/// in \p data, resampling each onto \p nz points in \p result
+void reduceZ(const BoutReal* data, int nxy, int ncz, int zmax, int nz,
+             BoutReal* result);
+} // namespace bout
+
 /// Write this variable once to the grid file
 #define SAVE_ONCE1(var) bout::globals::dump.addOnce(var, #var);
 #define SAVE_ONCE2(var1, var2) { \
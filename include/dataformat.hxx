@@ -75,6 +75,16 @@ class DataFormat {
   virtual bool setLocalOrigin(int x = 0, int y = 0, int z = 0, int offset_x = 0, int offset_y = 0, int offset_z = 0);
   virtual bool setRecord(int t) = 0; // negative -> latest
 
+  /// Set the sizes of the arrays on this processor, if these are not
+  /// the sizes of the local mesh. Used when the data of several
+  /// processors is written to one file. Call before opening the file
+  void setLocalSize(int nx, int ny, int nz);
+
+  /// Set the number of z points of the Field3D variables added or
+  /// written after this call, if fewer z modes are kept than the mesh
+  /// has. A negative value resets to the mesh size
+  void setLocalNz(int nz);
+
   // Add a variable to the file
   virtual bool addVarInt(const std::string &name, bool repeat) = 0;
   virtual bool addVarIntVec(const std::string &name, bool repeat, size_t size) = 0;
@@ -124,6 +134,11 @@ class DataFormat {
   
   virtual void setLowPrecision() { }  // By default doesn't do anything
 
+  /// Compress the field variables added after this call, with deflate
+  /// \p level from 1 to 9, or 0 for no compression. If \p shuffle is
+  /// true, the bytes are shuffled first. By default doesn't do anything
+  virtual void setCompression(int UNUSED(level), bool UNUSED(shuffle)) { }
+
   // Attributes
 
   /// Sets a string attribute
@@ -228,6 +243,15 @@ class DataFormat {
 
  protected:
   Mesh* mesh;
+
+  /// Sizes of the arrays on this processor: the sizes of the local
+  /// mesh, unless changed with setLocalSize
+  int localNx() const;
+  int localNy() const;
+  int localNz() const;
+
+ private:
+  int local_nx{-1}, local_ny{-1}, local_nz{-1};
 };
 
 // For backwards compatability. In formatfactory.cxx
@@ -34,7 +34,7 @@
 
 class Options;
 
-BOUT_ENUM_CLASS(FFT_MEASUREMENT_FLAG, estimate, measure, exhaustive);
+BOUT_ENUM_CLASS(FFT_MEASUREMENT_FLAG, estimate, measure, patient, exhaustive);
 
 namespace bout {
 namespace fft {
@@ -73,6 +73,38 @@ void rfft(const BoutReal *in, int length, dcomplex *out);
  */
 void irfft(const dcomplex *in, int length, BoutReal *out);
 
+/*!
+ * Batched version of rfft: take the fft of \p howmany real signals
+ * at once, using a single FFTW plan
+ *
+ * Plans are cached for each combination of \p length and \p
+ * howmany, so repeated calls with the same sizes don't re-plan. If
+ * called outside an OpenMP parallel region, the signals are split
+ * between the available threads.
+ *
+ * \param[in] in      Pointer to \p howmany real signals, each of \p
+ *                    length points, stored one after another
+ * \param[in] howmany Number of signals to transform
+ * \param[in] length  Number of points in each signal
+ * \param[out] out    Pointer to \p howmany complex arrays, each of
+ *                    (length / 2) + 1 points, stored one after another.
+ *                    Normalised in the same way as rfft
+ */
+void rfft_many(const BoutReal* in, int howmany, int length, dcomplex* out);
+
+/*!
+ * Batched version of irfft: take the inverse fft of \p howmany
+ * signals at once, using a single FFTW plan
+ *
+ * \param[in] in      Pointer to \p howmany complex arrays, each of
+ *                    (length / 2) + 1 points, stored one after another
+ * \param[in] howmany Number of signals to transform
+ * \param[in] length  Number of points in each real output signal
+ * \param[out] out    Pointer to \p howmany real signals, each of \p
+ *                    length points, stored one after another
+ */
+void irfft_many(const dcomplex* in, int howmany, int length, BoutReal* out);
+
 /*!
  * Discrete Sine Transform
  *
@@ -95,8 +127,16 @@ void fft_init(FFT_MEASUREMENT_FLAG fft_flag);
 ///
 /// If \p options is not nullptr, it should contain a bool called
 /// "fftw_measure". If it is nullptr, use the global `Options` root
+///
+/// If "fft_wisdom_file" is set in \p options, FFTW wisdom is loaded
+/// from that file, and saved back to it by fft_save_wisdom
 void fft_init(Options* options = nullptr);
 
+/// Save the FFTW wisdom to "fft_wisdom_file", if it was set and new
+/// batched plans have been made since the last save. Called by
+/// BoutFinalise
+void fft_save_wisdom();
+
 /// Returns the fft of a real signal \p in using fftw_forward
 Array<dcomplex> rfft(const Array<BoutReal>& in);
 
@@ -124,6 +164,14 @@ inline void irfft(const dcomplex *in, int length, BoutReal *out) {
   return bout::fft::irfft(in, length, out);
 }
 
+inline void rfft_many(const BoutReal* in, int howmany, int length, dcomplex* out) {
+  return bout::fft::rfft_many(in, howmany, length, out);
+}
+
+inline void irfft_many(const dcomplex* in, int howmany, int length, BoutReal* out) {
+  return bout::fft::irfft_many(in, howmany, length, out);
+}
+
 inline void DST(const BoutReal *in, int length, dcomplex *out) {
   return bout::fft::DST(in, length, out);
 }
@@ -33,6 +33,8 @@
 #include "stencils.hxx"
 #include "utils.hxx"
 
+#include <vector>
+
 /// Perform interpolation between centre -> shifted or vice-versa
 /*!
   Interpolate using 4th-order staggered formula
@@ -254,7 +256,20 @@ public:
   virtual Field3D interpolate(const Field3D &f, const Field3D &delta_x,
                               const Field3D &delta_z, const BoutMask &mask) = 0;
 
-  void setMask(const BoutMask &mask) { skip_mask = mask; }
+  /// Interpolate several fields using the same precalculated
+  /// weights. Interpolations which can share work between fields
+  /// should override this; by default each field is done separately
+  virtual std::vector<Field3D>
+  interpolateMany(const std::vector<const Field3D*>& fields) const {
+    std::vector<Field3D> result;
+    result.reserve(fields.size());
+    for (const auto* f : fields) {
+      result.push_back(interpolate(*f));
+    }
+    return result;
+  }
+
+  virtual void setMask(const BoutMask &mask) { skip_mask = mask; }
 
   // Interpolate using the field at (x,y+y_offset,z), rather than (x,y,z)
   int y_offset;
@@ -284,6 +299,27 @@ protected:
   Field3D h10_z;
   Field3D h11_z;
 
+  /// The weights above packed into a fixed 16-point stencil for each
+  /// interpolated point, so that interpolating is a single pass over
+  /// these arrays. Built on first use after the weights or mask change
+  mutable bool stencil_compiled{false};
+  /// Index into the result of each interpolated point
+  mutable Array<int> stencil_target;
+  /// Index of the bottom-left source point, (i_corner, y + y_offset,
+  /// k_corner), with k_corner wrapped into the domain
+  mutable Array<int> stencil_source;
+  /// Index of the source point at the next z, (i_corner, y + y_offset,
+  /// k_corner + 1)
+  mutable Array<int> stencil_source_zp;
+  /// Stencil weights, stored structure-of-arrays: weight w of point p
+  /// is stencil_weights[w * npoints + p]. The weights are grouped in
+  /// fours, for f, df/dx, df/dz and d2f/dxdz, each applied to the
+  /// points (i, k), (i + 1, k), (i, k + 1), (i + 1, k + 1)
+  mutable Array<BoutReal> stencil_weights;
+
+  /// Pack the weights and the current mask into the stencil arrays
+  void compileStencil() const;
+
 public:
   HermiteSpline(Mesh *mesh = nullptr) : HermiteSpline(0, mesh) {}
   HermiteSpline(int y_offset = 0, Mesh *mesh = nullptr);
@@ -308,6 +344,16 @@ public:
                       const Field3D &delta_z) override;
   Field3D interpolate(const Field3D &f, const Field3D &delta_x, const Field3D &delta_z,
                       const BoutMask &mask) override;
+
+  /// Interpolate several fields, communicating all their derivatives
+  /// together and applying each block of stencils to every field
+  std::vector<Field3D>
+  interpolateMany(const std::vector<const Field3D*>& fields) const override;
+
+  void setMask(const BoutMask &mask) override {
+    Interpolation::setMask(mask);
+    stencil_compiled = false;
+  }
 };
 
 
@@ -336,6 +382,13 @@ public:
   /// This function is called by the other interpolate functions
   /// in the base class HermiteSpline.
   Field3D interpolate(const Field3D &f) const override;
+
+  /// The compiled stencils of HermiteSpline don't include the
+  /// monotonicity limiter, so interpolate each field separately
+  std::vector<Field3D>
+  interpolateMany(const std::vector<const Field3D*>& fields) const override {
+    return Interpolation::interpolateMany(fields);
+  }
 };
 
 class Lagrange4pt : public Interpolation {
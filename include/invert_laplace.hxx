@@ -47,6 +47,8 @@ class Laplacian;
 #include "dcomplex.hxx"
 #include "options.hxx"
 
+#include <vector>
+
 // Inversion flags for each boundary
 /// Zero-gradient for DC (constant in Z) component. Default is zero value
 constexpr int INVERT_DC_GRAD = 1;
@@ -199,6 +201,13 @@ public:
   virtual Field3D solve(const Field3D &b, const Field3D &x0);
   virtual Field2D solve(const Field2D &b, const Field2D &x0);
 
+  /// Solve for several right hand sides with the same coefficients.
+  /// Solvers which can do so solve them together, so that the
+  /// communication is shared between them
+  virtual std::vector<Field3D> solve(const std::vector<Field3D> &b);
+  virtual std::vector<Field3D> solve(const std::vector<Field3D> &b,
+                                     const std::vector<Field3D> &x0);
+
   /// Coefficients in tridiagonal inversion
   void tridagCoefs(int jx, int jy, int jz, dcomplex &a, dcomplex &b, dcomplex &c,
                    const Field2D *ccoef = nullptr, const Field2D *d = nullptr,
@@ -258,6 +267,12 @@ protected:
                     const Field2D *a, const Field2D *c1coef, const Field2D *c2coef,
                     const Field2D *d,
                     bool includeguards=true);
+
+  /// Zero the boundary elements of a right hand side, as tridagMatrix
+  /// does, for solvers reusing a matrix with a new right hand side
+  void zeroBoundaryRHS(dcomplex *bk, int flags, int inner_boundary_flags,
+                       int outer_boundary_flags, bool includeguards = true) const;
+
   CELL_LOC location;   ///< staggered grid location of this solver
   Mesh* localmesh;     ///< Mesh object for this solver
   Coordinates* coords; ///< Coordinates object, so we only have to call
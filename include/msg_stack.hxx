@@ -81,6 +81,11 @@ public:
 
   void dump();           ///< Write out all messages (using output)
   std::string getDump(); ///< Write out all messages to a string
+
+  /// Ignore all messages from the calling thread. For threads which
+  /// are not part of an OpenMP team, such as the Datafile output
+  /// thread, and so would otherwise race with the main thread
+  static void disableThisThread();
 #else
   /// Dummy functions which should be optimised out
   int push(const char *UNUSED(s), ...) { return 0; }
@@ -94,6 +99,8 @@ public:
 
   void dump() {}
   std::string getDump() { return ""; }
+
+  static void disableThisThread() {}
 #endif
 
 private:
@@ -111,6 +111,15 @@ public:
 
   static Output *getInstance(); ///< Return pointer to instance
 
+  /// Store the messages written by the calling thread, rather than
+  /// writing them. Output is not thread safe, so this is for threads
+  /// other than the main one, such as the Datafile output thread
+  static void collectThisThread();
+
+  /// Write the messages stored by collectThisThread. Should only be
+  /// called from the main thread
+  static void writeCollected();
+
 protected:
   friend class ConditionalOutput;
   virtual Output *getBase() { return this; }
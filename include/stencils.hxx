@@ -124,4 +124,46 @@ stencil inline populateStencil(const FieldType& f, const typename FieldType::ind
   populateStencil<direction, stagger, nGuard, FieldType>(s, f, i);
   return s;
 }
+
+/// As populateStencil in z, but \p p points into a z-line padded with
+/// periodic guard cells (see bout::ZPaddedLine), so the neighbours are
+/// plain offsets rather than wrapped indices
+template <STAGGER stagger = STAGGER::None, int nGuard = 1>
+stencil inline populateStencilZ(const BoutReal* p) {
+  static_assert(nGuard == 1 || nGuard == 2,
+                "populateStencilZ currently only supports one or two guard cells");
+  stencil s;
+  switch (stagger) {
+  case (STAGGER::None):
+    if (nGuard == 2) {
+      s.mm = p[-2];
+    }
+    s.m = p[-1];
+    s.c = p[0];
+    s.p = p[1];
+    if (nGuard == 2) {
+      s.pp = p[2];
+    }
+    break;
+  case (STAGGER::C2L):
+    if (nGuard == 2) {
+      s.mm = p[-2];
+    }
+    s.m = p[-1];
+    s.c = p[0];
+    s.p = s.c;
+    s.pp = p[1];
+    break;
+  case (STAGGER::L2C):
+    s.mm = p[-1];
+    s.m = p[0];
+    s.c = s.m;
+    s.p = p[1];
+    if (nGuard == 2) {
+      s.pp = p[2];
+    }
+    break;
+  }
+  return s;
+}
 #endif /* __STENCILS_H__ */
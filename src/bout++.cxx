@@ -42,10 +42,12 @@ const char DEFAULT_DIR[] = "data";
 #include "boutcomm.hxx"
 #include "boutexception.hxx"
 #include "datafile.hxx"
+#include "fft.hxx"
 #include "invert_laplace.hxx"
 #include "msg_stack.hxx"
 #include "optionsreader.hxx"
 #include "output.hxx"
+#include "bout/check_data.hxx"
 #include "bout/openmpwrap.hxx"
 #include "bout/petsclib.hxx"
 #include "bout/slepclib.hxx"
@@ -163,6 +165,9 @@ int BoutInitialise(int& argc, char**& argv) {
 
     setRunStartInfo(Options::root());
 
+    // Which run-time checks for non-finite values to make
+    bout::checks::init(Options::root()["check"]);
+
     if (MYPE == 0) {
       writeSettingsFile(Options::root(), args.data_dir, args.set_file);
     }
@@ -613,6 +618,16 @@ int BoutFinalise(bool write_settings) {
     output.write("\nTimer report \n\n");
     Timer::printTimeReport();
     output.write("\n");
+
+    const auto array_stats = Array<BoutReal>::getStats();
+    output.write("Field memory: %zu bytes in %zu blocks, %zu requests\n",
+                 array_stats.bytes, array_stats.allocations, array_stats.requests);
+    if (array_stats.scopes > 0) {
+      const auto scopes = static_cast<BoutReal>(array_stats.scopes);
+      output.write("  per RHS evaluation: %.1f requests, %.1f new blocks\n\n",
+                   array_stats.scope_requests / scopes,
+                   array_stats.scope_allocations / scopes);
+    }
   }
 
   // Delete the mesh
@@ -620,6 +635,7 @@ int BoutFinalise(bool write_settings) {
 
   // Close the output file
   bout::globals::dump.close();
+  Datafile::stopOutputThread();
 
   // Make sure all processes have finished writing before exit
   MPI_Barrier(BoutComm::get());
@@ -627,6 +643,9 @@ int BoutFinalise(bool write_settings) {
   // Laplacian inversion
   Laplacian::cleanup();
 
+  // Keep any FFT plans made during the run for the next one
+  bout::fft::fft_save_wisdom();
+
   // Delete field memory
   Array<BoutReal>::cleanup();
   Array<dcomplex>::cleanup();
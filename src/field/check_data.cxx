@@ -0,0 +1,92 @@
+#include "bout/check_data.hxx"
+
+#include "boutexception.hxx"
+#include "field2d.hxx"
+#include "field3d.hxx"
+#include "fieldperp.hxx"
+#include "options.hxx"
+
+#include <atomic>
+
+namespace bout {
+namespace checks {
+
+namespace {
+/// Current mode. The default keeps the old behaviour of CHECK > 2
+CHECK_FINITE finite_mode{CHECK > 2 ? CHECK_FINITE::all : CHECK_FINITE::none};
+/// Scan one in this many checkData calls in sample mode
+int finite_sample_interval{1};
+/// Number of checkData calls since the last scan. checkData may be
+/// called from several threads, so this is atomic
+std::atomic<int> finite_sample_counter{0};
+
+/// Wrap the field name for error messages
+std::string quotedName(const std::string& name) {
+  return name.empty() ? "" : " '" + name + "'";
+}
+} // namespace
+
+void init(Options& options) {
+  const auto mode = options["finite"]
+                        .doc("Check fields for NaN or infinite values: none, all, "
+                             "sample or rhs. Checks in operators need CHECK > 0")
+                        .withDefault(finite_mode);
+  const int interval =
+      options["sample_interval"]
+          .doc("With finite = sample, check one in this many calls to checkData")
+          .withDefault(100);
+  setFiniteMode(mode, interval);
+}
+
+void setFiniteMode(CHECK_FINITE mode, int sample_interval) {
+  if (sample_interval < 1) {
+    throw BoutException("check:sample_interval must be at least 1, got %d",
+                        sample_interval);
+  }
+  finite_mode = mode;
+  finite_sample_interval = sample_interval;
+  finite_sample_counter = 0;
+}
+
+CHECK_FINITE getFiniteMode() { return finite_mode; }
+
+bool checkDataFinite() {
+  switch (finite_mode) {
+  case CHECK_FINITE::all:
+    return true;
+  case CHECK_FINITE::sample:
+    return (++finite_sample_counter % finite_sample_interval) == 0;
+  default:
+    return false;
+  }
+}
+
+bool checkRHSFinite() { return finite_mode == CHECK_FINITE::rhs; }
+
+void checkFinite(const Field2D& f, const std::string& name, const std::string& region) {
+  Ind2D i;
+  if (findNonFinite(&f(0, 0), f.getRegion(region), i)) {
+    throw BoutException("Field2D%s: Operation on non-finite data at [%d][%d]\n",
+                        quotedName(name).c_str(), i.x(), i.y());
+  }
+}
+
+void checkFinite(const Field3D& f, const std::string& name, const std::string& region) {
+  Ind3D i;
+  if (findNonFinite(&f(0, 0, 0), f.getRegion(region), i)) {
+    throw BoutException("Field3D%s: Operation on non-finite data at [%d][%d][%d]\n",
+                        quotedName(name).c_str(), i.x(), i.y(), i.z());
+  }
+}
+
+void checkFinite(const FieldPerp& f, const std::string& name,
+                 const std::string& region) {
+  IndPerp i;
+  if (findNonFinite(&f(0, 0), f.getRegion(region), i)) {
+    throw BoutException("FieldPerp%s: Operation on non-finite data at [%d][%d]\n",
+                        quotedName(name).c_str(), i.x(), i.z());
+  }
+}
+
+} // namespace checks
+} // namespace bout
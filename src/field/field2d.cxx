@@ -45,6 +45,7 @@
 #include <output.hxx>
 
 #include <bout/assert.hxx>
+#include <bout/check_data.hxx>
 
 Field2D::Field2D(Mesh* localmesh, CELL_LOC location_in,
       DirectionTypes directions_in)
@@ -326,25 +327,6 @@ Field2D operator-(const Field2D &f) { return -1.0 * f; }
 
 //////////////// NON-MEMBER FUNCTIONS //////////////////
 
-namespace {
-  // Internal routine to avoid ugliness with interactions between CHECK
-  // levels and UNUSED parameters
-#if CHECK > 2
-void checkDataIsFiniteOnRegion(const Field2D& f, const std::string& region) {
-  // Do full checks
-  BOUT_FOR_SERIAL(i, f.getRegion(region)) {
-    if (!::finite(f[i])) {
-      throw BoutException("Field2D: Operation on non-finite data at [%d][%d]\n", i.x(),
-                          i.y());
-    }
-  }
-}
-#elif CHECK > 0
-// No-op for no checking
-void checkDataIsFiniteOnRegion(const Field2D &UNUSED(f), const std::string& UNUSED(region)) {}
-#endif
-}
-
 #if CHECK > 0
 /// Check if the data is valid
 void checkData(const Field2D &f, const std::string& region) {
@@ -352,7 +334,9 @@ void checkData(const Field2D &f, const std::string& region) {
     throw BoutException("Field2D: Operation on empty data\n");
   }
 
-  checkDataIsFiniteOnRegion(f, region);
+  if (bout::checks::checkDataFinite()) {
+    bout::checks::checkFinite(f, f.name, region);
+  }
 }
 #endif
 
@@ -42,6 +42,7 @@
 #include <msg_stack.hxx>
 #include <bout/constants.hxx>
 #include <bout/assert.hxx>
+#include <bout/check_data.hxx>
 
 /// Constructor
 Field3D::Field3D(Mesh* localmesh, CELL_LOC location_in,
@@ -773,31 +774,15 @@ void shiftZ(Field3D &var, double zangle, const std::string& rgn) {
   }
 }
 
-namespace {
-  // Internal routine to avoid ugliness with interactions between CHECK
-  // levels and UNUSED parameters
-#if CHECK > 2
-void checkDataIsFiniteOnRegion(const Field3D& f, const std::string& region) {
-  // Do full checks
-  BOUT_FOR_SERIAL(i, f.getRegion(region)) {
-    if (!finite(f[i])) {
-      throw BoutException("Field3D: Operation on non-finite data at [%d][%d][%d]\n",
-                          i.x(), i.y(), i.z());
-    }
-  }
-}
-#elif CHECK > 0
-// No-op for no checking
-void checkDataIsFiniteOnRegion(const Field3D &UNUSED(f), const std::string& UNUSED(region)) {}
-#endif
-}
-
 #if CHECK > 0
 void checkData(const Field3D &f, const std::string& region) {
   if (!f.isAllocated())
     throw BoutException("Field3D: Operation on empty data\n");
 
-  checkDataIsFiniteOnRegion(f, region);
+  // Whether to scan for NaNs is set by the [check] finite option
+  if (bout::checks::checkDataFinite()) {
+    bout::checks::checkFinite(f, f.name, region);
+  }
 }
 #endif
 
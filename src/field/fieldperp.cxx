@@ -28,6 +28,7 @@
 
 #include <cmath>
 
+#include <bout/check_data.hxx>
 #include <bout/mesh.hxx>
 #include <fieldperp.hxx>
 #include <utils.hxx>
@@ -171,20 +172,6 @@ const FieldPerp sliceXZ(const Field3D& f, int y) {
   return result;
 }
 
-#if CHECK > 2
-void checkDataIsFiniteOnRegion(const FieldPerp &f, const std::string& region) {
-  // Do full checks
-  BOUT_FOR_SERIAL(i, f.getRegion(region)) {
-    if (!::finite(f[i])) {
-      throw BoutException("FieldPerp: Operation on non-finite data at [%d][%d]\n", i.x(),
-                          i.z());
-    }
-  }
-}
-#else
-void checkDataIsFiniteOnRegion(const FieldPerp &UNUSED(f), const std::string& UNUSED(region)) {}
-#endif
-
 
 #if CHECK > 0
 /// Check if the data is valid
@@ -195,7 +182,9 @@ void checkData(const FieldPerp &f, const std::string& region) {
 
   ASSERT3(f.getIndex() >= 0 && f.getIndex() < f.getMesh()->LocalNy);
 
-  checkDataIsFiniteOnRegion(f, region);
+  if (bout::checks::checkDataFinite()) {
+    bout::checks::checkFinite(f, f.name, region);
+  }
 }
 #endif
 
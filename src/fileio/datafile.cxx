@@ -46,9 +46,297 @@
 #include <boutcomm.hxx>
 #include <utils.hxx>
 #include <msg_stack.hxx>
+#include <fft.hxx>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
 #include "formatfactory.hxx"
 
+namespace {
+/// A copy of one variable to be written by the output thread
+struct OutputItem {
+  enum class Type { Int, Char, Real, Perp };
+  Type type;
+  std::string name;
+  bool save_repeat;
+  int lx, ly, lz;
+  std::vector<int> ints;
+  std::vector<char> chars;
+  std::vector<BoutReal> reals;
+};
+
+/// Everything needed by the output thread for one call to Datafile::write
+struct OutputJob {
+  DataFormat* file{nullptr};
+  bool open{false};   ///< Open the file before writing?
+  std::string filename;
+  int rank{0};
+  bool append{false};
+  bool close{false};  ///< Close the file after writing?
+  bool low_precision{false};
+
+  /// Items are kept between writes so that their buffers can be reused
+  std::vector<OutputItem> items;
+  std::size_t nitems{0}; ///< Number of items in use
+
+  bool queued{false};       ///< Waiting for, or being written by, the output thread
+  std::exception_ptr error; ///< Exception thrown while writing, if any
+
+  OutputItem& add(OutputItem::Type type, const std::string& name, bool save_repeat,
+                  int lx, int ly = 0, int lz = 0) {
+    if (nitems == items.size()) {
+      items.emplace_back();
+    }
+    auto& item = items[nitems++];
+    item.type = type;
+    item.name = name;
+    item.save_repeat = save_repeat;
+    item.lx = lx;
+    item.ly = ly;
+    item.lz = lz;
+    return item;
+  }
+
+  /// Make the DataFormat calls. Only run on the output thread
+  void write() {
+    if (open and !file->openw(filename, rank, append)) {
+      throw BoutException("Datafile::write: Failed to open file %s for %s!",
+                          filename.c_str(), append ? "appending" : "writing");
+    }
+    if (!file->is_valid()) {
+      throw BoutException("Datafile::write: File is not valid!");
+    }
+    if (low_precision) {
+      file->setLowPrecision();
+    }
+    file->setRecord(-1); // Latest record
+
+    for (std::size_t i = 0; i < nitems; ++i) {
+      auto& item = items[i];
+      bool success = true;
+      switch (item.type) {
+      case OutputItem::Type::Int:
+        success = item.save_repeat ? file->write_rec(item.ints.data(), item.name, item.lx)
+                                   : file->write(item.ints.data(), item.name, item.lx);
+        break;
+      case OutputItem::Type::Char:
+        success = item.save_repeat ? file->write_rec(item.chars.data(), item.name, item.lx)
+                                   : file->write(item.chars.data(), item.name, item.lx);
+        break;
+      case OutputItem::Type::Real:
+        // Field3Ds may be stored with fewer z points than the mesh
+        if (item.lz > 0) {
+          file->setLocalNz(item.lz);
+        }
+        success = item.save_repeat ? file->write_rec(item.reals.data(), item.name, item.lx,
+                                                     item.ly, item.lz)
+                                   : file->write(item.reals.data(), item.name, item.lx,
+                                                 item.ly, item.lz);
+        file->setLocalNz(-1);
+        break;
+      case OutputItem::Type::Perp:
+        success = item.save_repeat
+                      ? file->write_rec_perp(item.reals.data(), item.name, item.lx, item.lz)
+                      : file->write_perp(item.reals.data(), item.name, item.lx, item.lz);
+        break;
+      }
+      if (!success) {
+        throw BoutException("Datafile::write: Failed to write %s!", item.name.c_str());
+      }
+    }
+
+    if (close) {
+      file->close();
+    }
+  }
+};
+
+/// The thread which writes all asynchronous Datafiles, in the order
+/// they were submitted. The file libraries are not in general thread
+/// safe, so there is only one of these, and every Datafile waits for
+/// it to finish before touching a file itself.
+///
+/// Nothing run on this thread may use Arrays, Timers or MPI. The
+/// message stack is disabled, and messages are stored until the main
+/// thread writes them with Output::writeCollected
+class OutputQueue {
+public:
+  /// Never destroyed, so that Datafiles can still wait for it
+  /// during static destruction
+  static OutputQueue& get() {
+    static auto* instance = new OutputQueue;
+    return *instance;
+  }
+
+  /// Add \p job to the queue, starting the thread if needed
+  void push(OutputJob& job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!thread.joinable()) {
+        thread = std::thread(&OutputQueue::run, this);
+      }
+      job.queued = true;
+      jobs.push_back(&job);
+    }
+    work.notify_one();
+  }
+
+  /// Wait until \p job has been written
+  void wait(const OutputJob& job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&job] { return !job.queued; });
+  }
+
+  /// Wait until all jobs have been written
+  void waitAll() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return jobs.empty(); });
+  }
+
+  /// Write all the queued jobs, then stop the thread. It is started
+  /// again if more jobs are pushed
+  void shutdown() {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      done.wait(lock, [this] { return jobs.empty(); });
+      if (!thread.joinable()) {
+        return;
+      }
+      stopping = true;
+    }
+    work.notify_one();
+    thread.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = false;
+  }
+
+private:
+  void run() {
+    MsgStack::disableThisThread();
+    Output::collectThisThread();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      work.wait(lock, [this] { return stopping or !jobs.empty(); });
+      if (jobs.empty()) {
+        return;
+      }
+      // Leave the job in the queue until finished, so waitAll waits for it
+      OutputJob* job = jobs.front();
+      lock.unlock();
+      try {
+        job->write();
+      } catch (...) {
+        job->error = std::current_exception();
+      }
+      lock.lock();
+      jobs.pop_front();
+      job->queued = false;
+      done.notify_all();
+    }
+  }
+
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable work, done;
+  std::deque<OutputJob*> jobs;
+  bool stopping{false}; ///< Should the thread finish once the queue is empty?
+};
+
+} // namespace
+
+namespace bout {
+void roundSignificantBits(BoutReal* data, std::size_t n, int bits) {
+  static_assert(sizeof(BoutReal) == sizeof(std::uint64_t), "BoutReal must be a double");
+  constexpr int mantissa_bits = std::numeric_limits<BoutReal>::digits - 1;
+  if (bits <= 0 or bits >= mantissa_bits) {
+    return;
+  }
+  const int dropped = mantissa_bits - bits;
+  const std::uint64_t half = std::uint64_t{1} << (dropped - 1);
+  const std::uint64_t mask = ~((std::uint64_t{1} << dropped) - 1);
+  const std::uint64_t exponent = std::uint64_t{0x7ff} << mantissa_bits;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    std::uint64_t value;
+    std::memcpy(&value, data + i, sizeof(value));
+    if ((value & exponent) == exponent) {
+      continue;
+    }
+    // Round to nearest. A carry out of the mantissa increments the exponent
+    value = (value + half) & mask;
+    std::memcpy(data + i, &value, sizeof(value));
+  }
+}
+
+void reduceZ(const BoutReal* data, int nxy, int ncz, int zmax, int nz,
+             BoutReal* result) {
+  std::vector<dcomplex> modes(ncz / 2 + 1);
+  for (int i = 0; i < nxy; ++i) {
+    rfft(data + i * ncz, ncz, modes.data());
+    // Remove the modes above zmax, as lowPass does
+    std::fill(modes.begin() + zmax + 1, modes.end(), 0.0);
+    irfft(modes.data(), nz, result + i * nz);
+  }
+}
+} // namespace bout
+
+/// Two jobs, so that one can be filled while the other is written
+class Datafile::AsyncWriter {
+public:
+  /// Job to fill, waiting until it has finished its last write
+  OutputJob& next() {
+    auto& job = jobs[current];
+    OutputQueue::get().wait(job);
+    Output::writeCollected();
+    rethrow(job);
+    job.nitems = 0;
+    job.open = false;
+    job.close = false;
+    return job;
+  }
+
+  /// Give the filled job to the output thread
+  void submit() {
+    OutputQueue::get().push(jobs[current]);
+    current = 1 - current;
+  }
+
+  /// Wait for both jobs, and rethrow any exception from writing them
+  void wait() {
+    auto& queue = OutputQueue::get();
+    for (auto& job : jobs) {
+      queue.wait(job);
+    }
+    Output::writeCollected();
+    for (auto& job : jobs) {
+      rethrow(job);
+    }
+  }
+
+  /// The job being filled
+  OutputJob& job() { return jobs[current]; }
+
+private:
+  static void rethrow(OutputJob& job) {
+    if (job.error) {
+      auto error = job.error;
+      job.error = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  OutputJob jobs[2];
+  int current{0};
+};
+
 Datafile::Datafile(Options* opt, Mesh* mesh_in)
     : mesh(mesh_in == nullptr ? bout::globals::mesh : mesh_in), file(nullptr) {
   filenamelen=FILENAMELEN;
@@ -70,6 +358,37 @@ Datafile::Datafile(Options* opt, Mesh* mesh_in)
   OPTION(opt, shiftOutput, false); // Do we want to write 3D fields in shifted space?
   OPTION(opt, shiftInput, false); // Do we want to read 3D fields in shifted space?
   OPTION(opt, flushFrequency, 1); // How frequently do we flush the file
+  OPTION(opt, async, false); // Write from a separate thread?
+  OPTION(opt, aggregate_x, 1); // Number of processors in X writing to each file
+  OPTION(opt, aggregate_y, 1); // Number of processors in Y writing to each file
+
+  // Storage of field variables, which can be changed for each variable
+  // in a subsection with the variable's name
+  options = opt;
+  default_storage.compress = (*opt)["compress"]
+                                 .doc("Deflate level of fields, 1 to 9, or 0 for none")
+                                 .withDefault(0);
+  default_storage.shuffle = (*opt)["shuffle"]
+                                .doc("Shuffle the bytes of fields before compressing?")
+                                .withDefault(true);
+  default_storage.significant_bits =
+      (*opt)["significant_bits"]
+          .doc("Round fields to this many significant bits, or 0 to keep all")
+          .withDefault(0);
+  default_storage.zmax = (*opt)["zmax"]
+                             .doc("Highest z mode of Field3Ds to write, or -1 for all")
+                             .withDefault(-1);
+
+  if (async and parallel) {
+    throw BoutException("Datafile: async cannot be used with parallel output");
+  }
+  if (aggregate_x < 1 or aggregate_y < 1) {
+    throw BoutException("Datafile: aggregate_x and aggregate_y must be at least 1");
+  }
+  if (aggregating() and parallel) {
+    throw BoutException("Datafile: aggregate_x and aggregate_y cannot be used with "
+                        "parallel output");
+  }
 }
 
 Datafile::Datafile(Datafile &&other) noexcept
@@ -77,8 +396,14 @@ Datafile::Datafile(Datafile &&other) noexcept
       floats(other.floats), openclose(other.openclose), Lx(other.Lx), Ly(other.Ly),
       Lz(other.Lz), enabled(other.enabled), init_missing(other.init_missing), shiftOutput(other.shiftOutput),
       shiftInput(other.shiftInput), flushFrequencyCounter(other.flushFrequencyCounter),
-      flushFrequency(other.flushFrequency), file(std::move(other.file)),
-      writable(other.writable), appending(other.appending), first_time(other.first_time),
+      flushFrequency(other.flushFrequency), async(other.async),
+      aggregate_x(other.aggregate_x), aggregate_y(other.aggregate_y),
+      options(other.options), default_storage(other.default_storage),
+      file(std::move(other.file)), writable(other.writable), appending(other.appending),
+      first_time(other.first_time), writer(std::move(other.writer)),
+      group_comm(other.group_comm), writes_file(other.writes_file),
+      file_index(other.file_index), block_nx(other.block_nx), block_ny(other.block_ny),
+      group_values(std::move(other.group_values)),
       int_arr(std::move(other.int_arr)), int_vec_arr(std::move(other.int_vec_arr)),
       string_arr(std::move(other.string_arr)),
       BoutReal_arr(std::move(other.BoutReal_arr)), bool_arr(std::move(other.bool_arr)),
@@ -89,6 +414,7 @@ Datafile::Datafile(Datafile &&other) noexcept
   other.filenamelen = 0;
   other.filename = nullptr;
   other.file = nullptr;
+  other.group_comm = MPI_COMM_NULL;
 }
 
 Datafile::Datafile(const Datafile& other)
@@ -97,18 +423,29 @@ Datafile::Datafile(const Datafile& other)
       Lx(other.Lx), Ly(other.Ly), Lz(other.Lz), enabled(other.enabled),
       init_missing(other.init_missing), shiftOutput(other.shiftOutput),
       shiftInput(other.shiftInput), flushFrequencyCounter(other.flushFrequencyCounter),
-      flushFrequency(other.flushFrequency), file(nullptr), writable(other.writable),
-      appending(other.appending), first_time(other.first_time), int_arr(other.int_arr),
+      flushFrequency(other.flushFrequency), async(other.async),
+      aggregate_x(other.aggregate_x), aggregate_y(other.aggregate_y),
+      options(other.options), default_storage(other.default_storage), file(nullptr),
+      writable(other.writable),
+      appending(other.appending), first_time(other.first_time),
+      writes_file(other.writes_file),
+      file_index(other.file_index), block_nx(other.block_nx), block_ny(other.block_ny),
+      group_values(other.group_values), int_arr(other.int_arr),
       int_vec_arr(other.int_vec_arr), string_arr(other.string_arr),
       BoutReal_arr(other.BoutReal_arr), bool_arr(other.bool_arr), f2d_arr(other.f2d_arr),
       f3d_arr(other.f3d_arr), v2d_arr(other.v2d_arr), v3d_arr(other.v3d_arr) {
   filenamelen = other.filenamelen;
   filename = new char[filenamelen];
   strncpy(filename, other.filename, filenamelen);
-  // Same added variables, but the file not the same
+  // Same added variables, but the file not the same. The group
+  // communicator isn't shared either: it is split again in setupGroup
+  // when this copy opens a file
 }
 
 Datafile& Datafile::operator=(Datafile &&rhs) noexcept {
+  // Our file is about to be closed
+  OutputQueue::get().waitAll();
+
   mesh         = rhs.mesh;
   parallel     = rhs.parallel;
   flush        = rhs.flush;
@@ -121,10 +458,24 @@ Datafile& Datafile::operator=(Datafile &&rhs) noexcept {
   shiftInput   = rhs.shiftInput;
   flushFrequencyCounter = 0;
   flushFrequency = rhs.flushFrequency;
+  async        = rhs.async;
+  aggregate_x  = rhs.aggregate_x;
+  aggregate_y  = rhs.aggregate_y;
+  options      = rhs.options;
+  default_storage = rhs.default_storage;
+  writer       = std::move(rhs.writer);
   file         = std::move(rhs.file);
   writable     = rhs.writable;
   appending    = rhs.appending;
   first_time   = rhs.first_time;
+  freeGroup();
+  group_comm   = rhs.group_comm;
+  rhs.group_comm = MPI_COMM_NULL;
+  writes_file  = rhs.writes_file;
+  file_index   = rhs.file_index;
+  block_nx     = rhs.block_nx;
+  block_ny     = rhs.block_ny;
+  group_values = std::move(rhs.group_values);
   int_arr      = std::move(rhs.int_arr);
   int_vec_arr  = std::move(rhs.int_vec_arr);
   string_arr   = std::move(rhs.string_arr);
@@ -144,6 +495,11 @@ Datafile& Datafile::operator=(Datafile &&rhs) noexcept {
 }
 
 Datafile::~Datafile() {
+  if (writer) {
+    // Can't throw here, so any errors are lost
+    OutputQueue::get().waitAll();
+  }
+  freeGroup();
   if (filename != nullptr){
     delete[] filename;
     filename=nullptr;
@@ -156,6 +512,8 @@ bool Datafile::openr(const char *format, ...) {
     throw BoutException("Datafile::open: No argument given for opening file!");
   }
 
+  sync();
+
   bout_vsnprintf(filename,filenamelen, format);
   
   // Get the data format
@@ -192,6 +550,8 @@ bool Datafile::openw(const char *format, ...) {
     throw BoutException("Datafile::open: No argument given for opening file!");
   }
 
+  sync();
+
   bout_vsnprintf(filename, filenamelen, format);
   
   // Get the data format
@@ -213,10 +573,17 @@ bool Datafile::openw(const char *format, ...) {
     Ly = mesh->LocalNy;
     Lz = mesh->LocalNz;
   }
-  
+
+  setupGroup();
+  if (!writes_file) {
+    // Data is only sent to the processor writing the file
+    writable = true;
+    return true;
+  }
+
   appending = false;
   // Open the file
-  if(!file->openw(filename, BoutComm::rank(), appending))
+  if(!file->openw(filename, file_index, appending))
     throw BoutException("Datafile::open: Failed to open file %s for writing!", filename);
 
   appending = true;
@@ -260,21 +627,21 @@ bool Datafile::openw(const char *format, ...) {
 
   // Add 2D fields
   for (const auto& var : f2d_arr) {
-    if (!file->addVarField2D(var.name, var.save_repeat)) {
+    if (!addField2D(var.name, var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Field2D variable %s to Datafile", var.name.c_str());
     }
   }
 
   // Add 3D fields
   for (const auto& var : f3d_arr) {
-    if (!file->addVarField3D(var.name, var.save_repeat)) {
+    if (!addField3D(var.name, var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Field3D variable %s to Datafile", var.name.c_str());
     }
   }
 
   // Add FieldPerps
   for (const auto& var : fperp_arr) {
-    if (!file->addVarFieldPerp(var.name, var.save_repeat)) {
+    if (!addFieldPerp(var.name, var.save_repeat, var.storage)) {
       throw BoutException("Failed to add FieldPerp variable %s to Datafile", var.name.c_str());
     }
   }
@@ -282,13 +649,13 @@ bool Datafile::openw(const char *format, ...) {
   // 2D vectors
   for(const auto& var : v2d_arr) {
     auto name = var.covar ? var.name + "_" : var.name;
-    if (!file->addVarField2D(name + "x", var.save_repeat)) {
+    if (!addField2D(name + "x", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField2D(name + "y", var.save_repeat)) {
+    if (!addField2D(name + "y", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField2D(name + "z", var.save_repeat)) {
+    if (!addField2D(name + "z", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile", name.c_str());
     }
   }
@@ -296,13 +663,13 @@ bool Datafile::openw(const char *format, ...) {
   // 3D vectors
   for(const auto& var : v3d_arr) {
     auto name = var.covar ? var.name + "_" : var.name;
-    if (!file->addVarField3D(name + "x", var.save_repeat)) {
+    if (!addField3D(name + "x", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField3D(name + "y", var.save_repeat)) {
+    if (!addField3D(name + "y", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField3D(name + "z", var.save_repeat)) {
+    if (!addField3D(name + "z", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile", name.c_str());
     }
   }
@@ -323,6 +690,8 @@ bool Datafile::opena(const char *format, ...) {
     throw BoutException("Datafile::open: No argument given for opening file!");
   }
 
+  sync();
+
   bout_vsnprintf(filename, filenamelen, format);
 
   // Get the data format
@@ -344,10 +713,17 @@ bool Datafile::opena(const char *format, ...) {
     Ly = mesh->LocalNy;
     Lz = mesh->LocalNz;
   }
-  
+
+  setupGroup();
+  if (!writes_file) {
+    // Data is only sent to the processor writing the file
+    writable = true;
+    return true;
+  }
+
   appending = true;
   // Open the file
-  if(!file->openw(filename, BoutComm::rank(), true))
+  if(!file->openw(filename, file_index, true))
     throw BoutException("Datafile::open: Failed to open file %s for appending!",
         filename);
 
@@ -391,21 +767,21 @@ bool Datafile::opena(const char *format, ...) {
 
   // Add 2D fields
   for (const auto& var : f2d_arr) {
-    if (!file->addVarField2D(var.name, var.save_repeat)) {
+    if (!addField2D(var.name, var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Field2D variable %s to Datafile", var.name.c_str());
     }
   }
 
   // Add 3D fields
   for (const auto& var : f3d_arr) {
-    if (!file->addVarField3D(var.name, var.save_repeat)) {
+    if (!addField3D(var.name, var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Field3D variable %s to Datafile", var.name.c_str());
     }
   }
 
   // Add FieldPerps
   for (const auto& var : fperp_arr) {
-    if (!file->addVarFieldPerp(var.name, var.save_repeat)) {
+    if (!addFieldPerp(var.name, var.save_repeat, var.storage)) {
       throw BoutException("Failed to add FieldPerp variable %s to Datafile", var.name.c_str());
     }
   }
@@ -413,13 +789,13 @@ bool Datafile::opena(const char *format, ...) {
   // 2D vectors
   for(const auto& var : v2d_arr) {
     auto name = var.covar ? var.name + "_" : var.name;
-    if (!file->addVarField2D(name + "x", var.save_repeat)) {
+    if (!addField2D(name + "x", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField2D(name + "y", var.save_repeat)) {
+    if (!addField2D(name + "y", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField2D(name + "z", var.save_repeat)) {
+    if (!addField2D(name + "z", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile", name.c_str());
     }
   }
@@ -427,13 +803,13 @@ bool Datafile::opena(const char *format, ...) {
   // 3D vectors
   for(const auto& var : v3d_arr) {
     auto name = var.covar ? var.name + "_" : var.name;
-    if (!file->addVarField3D(name + "x", var.save_repeat)) {
+    if (!addField3D(name + "x", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField3D(name + "y", var.save_repeat)) {
+    if (!addField3D(name + "y", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile", name.c_str());
     }
-    if (!file->addVarField3D(name + "z", var.save_repeat)) {
+    if (!addField3D(name + "z", var.save_repeat, var.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile", name.c_str());
     }
   }
@@ -452,24 +828,36 @@ bool Datafile::isValid() {
   
   if(!file)
     return false;
-  
+
+  if (!writes_file)
+    return true; // Another processor writes the file
+
+  sync();
   return file->is_valid();
 }
 
 void Datafile::close() {
   if(!file)
     return;
-  if(!openclose)
+  sync();
+  writer = nullptr;
+  if(!openclose and writes_file)
     file->close();
   // free:
   file = nullptr;
   writable = false;
 }
 
+void Datafile::stopOutputThread() {
+  OutputQueue::get().shutdown();
+  Output::writeCollected();
+}
+
 void Datafile::setLowPrecision() {
   if(!enabled)
     return;
   floats = true;
+  sync();
   file->setLowPrecision();
 }
 
@@ -498,14 +886,15 @@ void Datafile::add(int &i, const char *name, bool save_repeat, const std::string
   
   int_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       // Check filename has been set
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -557,14 +946,15 @@ void Datafile::add(std::vector<int> &i, const char *name, bool save_repeat, cons
 
   int_vec_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       // Check filename has been set
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
                               filename);
@@ -617,15 +1007,16 @@ void Datafile::add(std::string &s, const char *name, bool save_repeat, const std
 
   string_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       // Check filename has been set
       if (strcmp(filename, "") == 0) {
         throw BoutException("Datafile::add: Filename has not been set");
       }
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
                               filename);
@@ -677,13 +1068,14 @@ void Datafile::add(BoutReal &r, const char *name, bool save_repeat, const std::s
   
   BoutReal_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -737,14 +1129,15 @@ void Datafile::add(bool &b, const char *name, bool save_repeat, const std::strin
 
   bool_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       // Check filename has been set
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -792,16 +1185,18 @@ void Datafile::add(Field2D &f, const char *name, bool save_repeat, const std::st
   d.save_repeat = save_repeat;
   d.covar = false;
   d.description = description;
+  d.storage = getStorage(name);
   
   f2d_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -820,7 +1215,7 @@ void Datafile::add(Field2D &f, const char *name, bool save_repeat, const std::st
       file->setLowPrecision();
 
     // Add variable to file
-    if (!file->addVarField2D(name, save_repeat)) {
+    if (!addField2D(name, save_repeat, d.storage)) {
       throw BoutException("Failed to add Field2D variable %s to Datafile", name);
     }
 
@@ -852,16 +1247,18 @@ void Datafile::add(Field3D &f, const char *name, bool save_repeat, const std::st
   d.save_repeat = save_repeat;
   d.covar = false;
   d.description = description;
+  d.storage = getStorage(name);
   
   f3d_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -880,7 +1277,7 @@ void Datafile::add(Field3D &f, const char *name, bool save_repeat, const std::st
       file->setLowPrecision();
 
     // Add variable to file
-    if (!file->addVarField3D(name, save_repeat)) {
+    if (!addField3D(name, save_repeat, d.storage)) {
       throw BoutException("Failed to add Field3D variable %s to Datafile", name);
     }
 
@@ -912,16 +1309,18 @@ void Datafile::add(FieldPerp &f, const char *name, bool save_repeat, const std::
   d.save_repeat = save_repeat;
   d.covar = false;
   d.description = description;
+  d.storage = getStorage(name);
 
   fperp_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -940,7 +1339,7 @@ void Datafile::add(FieldPerp &f, const char *name, bool save_repeat, const std::
       file->setLowPrecision();
 
     // Add variable to file
-    if (!file->addVarFieldPerp(name, save_repeat)) {
+    if (!addFieldPerp(name, save_repeat, d.storage)) {
       throw BoutException("Failed to add FieldPerp variable %s to Datafile", name);
     }
 
@@ -972,16 +1371,18 @@ void Datafile::add(Vector2D &f, const char *name, bool save_repeat, const std::s
   d.save_repeat = save_repeat;
   d.covar = f.covariant;
   d.description = description;
+  d.storage = getStorage(name);
 
   v2d_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -1001,15 +1402,15 @@ void Datafile::add(Vector2D &f, const char *name, bool save_repeat, const std::s
 
     // Add variables to file
     auto dname = d.covar ? d.name + "_" : d.name;
-    if (!file->addVarField2D(dname + "x", save_repeat)) {
+    if (!addField2D(dname + "x", save_repeat, d.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile",
                           dname.c_str());
     }
-    if (!file->addVarField2D(dname + "y", save_repeat)) {
+    if (!addField2D(dname + "y", save_repeat, d.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile",
                           dname.c_str());
     }
-    if (!file->addVarField2D(dname + "z", save_repeat)) {
+    if (!addField2D(dname + "z", save_repeat, d.storage)) {
       throw BoutException("Failed to add Vector2D variable %s to Datafile",
                           dname.c_str());
     }
@@ -1042,16 +1443,18 @@ void Datafile::add(Vector3D &f, const char *name, bool save_repeat, const std::s
   d.save_repeat = save_repeat;
   d.covar = f.covariant;
   d.description = description;
+  d.storage = getStorage(name);
 
   v3d_arr.push_back(d);
 
-  if (writable) {
+  if (writable and writes_file) {
     // Otherwise will add variables when Datafile is opened for writing/appending
+    sync();
     if (openclose) {
       // Open the file
       if (strcmp(filename, "") == 0)
         throw BoutException("Datafile::add: Filename has not been set");
-      if(!file->openw(filename, BoutComm::rank(), appending)) {
+      if(!file->openw(filename, file_index, appending)) {
         if (appending) {
           throw BoutException("Datafile::add: Failed to open file %s for appending!",
               filename);
@@ -1071,15 +1474,15 @@ void Datafile::add(Vector3D &f, const char *name, bool save_repeat, const std::s
 
     // Add variables to file
     auto dname = d.covar ? d.name + "_" : d.name;
-    if (!file->addVarField3D(dname + "x", save_repeat)) {
+    if (!addField3D(dname + "x", save_repeat, d.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile",
                           dname.c_str());
     }
-    if (!file->addVarField3D(dname + "y", save_repeat)) {
+    if (!addField3D(dname + "y", save_repeat, d.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile",
                           dname.c_str());
     }
-    if (!file->addVarField3D(dname + "z", save_repeat)) {
+    if (!addField3D(dname + "z", save_repeat, d.storage)) {
       throw BoutException("Failed to add Vector3D variable %s to Datafile",
                           dname.c_str());
     }
@@ -1120,6 +1523,24 @@ void checkFileGrid(DataFormat* file, const std::string& filename, const Mesh* me
 bool Datafile::read() {
   Timer timer("io");  ///< Start timer. Stops when goes out of scope
 
+  if (aggregating()) {
+    throw BoutException("Datafile::read: Can't read files shared between processors");
+  }
+  for (const auto& var : f3d_arr) {
+    if (storedNz(var.storage) < mesh->LocalNz) {
+      throw BoutException("Datafile::read: Can't read %s, as only its z modes up to "
+                          "zmax are stored", var.name.c_str());
+    }
+  }
+  for (const auto& var : v3d_arr) {
+    if (storedNz(var.storage) < mesh->LocalNz) {
+      throw BoutException("Datafile::read: Can't read %s, as only its z modes up to "
+                          "zmax are stored", var.name.c_str());
+    }
+  }
+
+  sync();
+
   if(openclose) {
     // Open the file
     if(!file->openr(filename, BoutComm::rank())) {
@@ -1329,9 +1750,35 @@ bool Datafile::write() {
   if(!file)
     throw BoutException("Datafile::write: File is not valid!");
 
-  if(openclose && (flushFrequencyCounter % flushFrequency == 0)) {
+  // The first write sets the attributes, so is never done in the background
+  staging = async and not first_time and writes_file;
+  // Reset when this returns or throws. A job which isn't submitted is
+  // discarded when the next write starts filling it again
+  struct StagingReset {
+    bool& staging;
+    ~StagingReset() { staging = false; }
+  } staging_reset{staging};
+  if (staging) {
+    if (!writer) {
+      writer = bout::utils::make_unique<AsyncWriter>();
+    }
+    // Waits if this buffer is still being written
+    auto& job = writer->next();
+    job.file = file.get();
+    job.low_precision = floats;
+  } else {
+    sync();
+  }
+
+  if(writes_file && openclose && (flushFrequencyCounter % flushFrequency == 0)) {
     // Open the file
-    if(!file->openw(filename, BoutComm::rank(), appending)) {
+    if (staging) {
+      auto& job = writer->job();
+      job.open = true;
+      job.filename = filename;
+      job.rank = file_index;
+      job.append = appending;
+    } else if(!file->openw(filename, file_index, appending)) {
       if (appending) {
         throw BoutException("Datafile::add: Failed to open file %s for appending!",
             filename);
@@ -1343,18 +1790,23 @@ bool Datafile::write() {
     appending = true;
     flushFrequencyCounter = 0;
   }
-  
-  if(!file->is_valid())
-    throw BoutException("Datafile::open: File is not valid!");
 
-  if(floats)
-    file->setLowPrecision();
-  
+  if (writes_file and !staging) {
+    if(!file->is_valid())
+      throw BoutException("Datafile::open: File is not valid!");
+
+    if(floats)
+      file->setLowPrecision();
+  }
+
+  // When staging, only measures the time taken to copy the variables
   Timer timer("io");
-  
-  file->setRecord(-1); // Latest record
 
-  if (first_time) {
+  if (writes_file and !staging) {
+    file->setRecord(-1); // Latest record
+  }
+
+  if (first_time and writes_file) {
     first_time = false;
 
     // Set the field attributes from field meta-data.
@@ -1410,6 +1862,10 @@ bool Datafile::write() {
       if (not var.description.empty()) {
         file->setAttribute(var.name, "description", var.description);
       }
+      if (storedNz(var.storage) < mesh->LocalNz) {
+        // Only the z modes up to zmax were written
+        file->setAttribute(var.name, "zmax", var.storage.zmax);
+      }
     }
 
     // FieldPerps
@@ -1442,6 +1898,11 @@ bool Datafile::write() {
       if (not var.description.empty()) {
         file->setAttribute(var.name, "description", var.description);
       }
+      if (storedNz(var.storage) < mesh->LocalNz) {
+        file->setAttribute(name+"x", "zmax", var.storage.zmax);
+        file->setAttribute(name+"y", "zmax", var.storage.zmax);
+        file->setAttribute(name+"z", "zmax", var.storage.zmax);
+      }
     }
   }
 
@@ -1481,17 +1942,17 @@ bool Datafile::write() {
 
   // Write 2D fields
   for (const auto& var : f2d_arr) {
-    write_f2d(var.name, var.ptr, var.save_repeat);
+    write_f2d(var.name, var.ptr, var.save_repeat, var.storage);
   }
 
   // Write 3D fields
   for (const auto& var : f3d_arr) {
-    write_f3d(var.name, var.ptr, var.save_repeat);
+    write_f3d(var.name, var.ptr, var.save_repeat, var.storage);
   }
   
   // Write FieldPerps
   for (const auto& var : fperp_arr) {
-    write_fperp(var.name, var.ptr, var.save_repeat);
+    write_fperp(var.name, var.ptr, var.save_repeat, var.storage);
   }
 
   // 2D vectors
@@ -1508,9 +1969,9 @@ bool Datafile::write() {
       v.toContravariant();
     }
 
-    write_f2d(name+"x", &(v.x), var.save_repeat);
-    write_f2d(name+"y", &(v.y), var.save_repeat);
-    write_f2d(name+"z", &(v.z), var.save_repeat);
+    write_f2d(name+"x", &(v.x), var.save_repeat, var.storage);
+    write_f2d(name+"y", &(v.y), var.save_repeat, var.storage);
+    write_f2d(name+"z", &(v.z), var.save_repeat, var.storage);
   }
 
   // 3D vectors
@@ -1527,13 +1988,21 @@ bool Datafile::write() {
       v.toContravariant();
     }
 
-    write_f3d(name+"x", &(v.x), var.save_repeat);
-    write_f3d(name+"y", &(v.y), var.save_repeat);
-    write_f3d(name+"z", &(v.z), var.save_repeat);
+    write_f3d(name+"x", &(v.x), var.save_repeat, var.storage);
+    write_f3d(name+"y", &(v.y), var.save_repeat, var.storage);
+    write_f3d(name+"z", &(v.z), var.save_repeat, var.storage);
   }
   
-  if(openclose  && (flushFrequencyCounter+1 % flushFrequency == 0)){
-    file->close();
+  if(writes_file && openclose  && (flushFrequencyCounter+1 % flushFrequency == 0)){
+    if (staging) {
+      writer->job().close = true;
+    } else {
+      file->close();
+    }
+  }
+
+  if (staging) {
+    writer->submit();
   }
   flushFrequencyCounter++;
   return true;
@@ -1564,6 +2033,10 @@ bool Datafile::write(const char *format, ...) const {
   return ret;
 }
 
+void Datafile::setGroupValue(const std::string& name, GroupValue func) {
+  group_values[name] = std::move(func);
+}
+
 void Datafile::setAttribute(const std::string &varname, const std::string &attrname, const std::string &text) {
 
   TRACE("Datafile::setAttribute(string, string, string)");
@@ -1577,9 +2050,15 @@ void Datafile::setAttribute(const std::string &varname, const std::string &attrn
   if(!file)
     throw BoutException("Datafile::write: File is not valid!");
 
+  sync();
+
+  if (!writes_file) {
+    return;
+  }
+
   if(openclose && (flushFrequencyCounter % flushFrequency == 0)) {
     // Open the file
-    if(!file->openw(filename, BoutComm::rank(), appending)) {
+    if(!file->openw(filename, file_index, appending)) {
       if (appending) {
         throw BoutException("Datafile::add: Failed to open file %s for appending!",
             filename);
@@ -1615,9 +2094,15 @@ void Datafile::setAttribute(const std::string &varname, const std::string &attrn
   if(!file)
     throw BoutException("Datafile::write: File is not valid!");
 
+  sync();
+
+  if (!writes_file) {
+    return;
+  }
+
   if(openclose && (flushFrequencyCounter % flushFrequency == 0)) {
     // Open the file
-    if(!file->openw(filename, BoutComm::rank(), appending)) {
+    if(!file->openw(filename, file_index, appending)) {
       if (appending) {
         throw BoutException("Datafile::add: Failed to open file %s for appending!",
             filename);
@@ -1653,9 +2138,15 @@ void Datafile::setAttribute(const std::string &varname, const std::string &attrn
   if(!file)
     throw BoutException("Datafile::write: File is not valid!");
 
+  sync();
+
+  if (!writes_file) {
+    return;
+  }
+
   if(openclose && (flushFrequencyCounter % flushFrequency == 0)) {
     // Open the file
-    if(!file->openw(filename, BoutComm::rank(), appending)) {
+    if(!file->openw(filename, file_index, appending)) {
       if (appending) {
         throw BoutException("Datafile::add: Failed to open file %s for appending!",
             filename);
@@ -1811,14 +2302,37 @@ bool Datafile::read_fperp(const std::string &name, FieldPerp *f, bool save_repea
 }
 
 bool Datafile::write_int(const std::string &name, int *f, bool save_repeat) {
+  if (!writes_file) {
+    return true;
+  }
+  int value = *f;
+  if (aggregating()) {
+    const auto it = group_values.find(name);
+    if (it != group_values.end()) {
+      value = it->second(value, Group{aggregate_x, aggregate_y, file_index});
+    }
+  }
+  if (staging) {
+    auto& item = writer->job().add(OutputItem::Type::Int, name, save_repeat, 0);
+    item.ints.assign(1, value);
+    return true;
+  }
   if(save_repeat) {
-    return file->write_rec(f, name);
+    return file->write_rec(&value, name);
   }else {
-    return file->write(f, name);
+    return file->write(&value, name);
   }
 }
 
 bool Datafile::write_int_vec(const std::string &name, std::vector<int> *f, bool save_repeat) {
+  if (!writes_file) {
+    return true;
+  }
+  if (staging) {
+    auto& item = writer->job().add(OutputItem::Type::Int, name, save_repeat, f->size());
+    item.ints.assign(f->begin(), f->end());
+    return true;
+  }
   if(save_repeat) {
     return file->write_rec(&(*f)[0], name, f->size());
   }else {
@@ -1827,6 +2341,14 @@ bool Datafile::write_int_vec(const std::string &name, std::vector<int> *f, bool
 }
 
 bool Datafile::write_string(const std::string &name, std::string *f, bool save_repeat) {
+  if (!writes_file) {
+    return true;
+  }
+  if (staging) {
+    auto& item = writer->job().add(OutputItem::Type::Char, name, save_repeat, f->size());
+    item.chars.assign(f->begin(), f->end());
+    return true;
+  }
   if (save_repeat) {
     return file->write_rec(&(*f)[0], name, f->size());
   } else {
@@ -1835,6 +2357,14 @@ bool Datafile::write_string(const std::string &name, std::string *f, bool save_r
 }
 
 bool Datafile::write_real(const std::string &name, BoutReal *f, bool save_repeat) {
+  if (!writes_file) {
+    return true;
+  }
+  if (staging) {
+    auto& item = writer->job().add(OutputItem::Type::Real, name, save_repeat, 0);
+    item.reals.assign(f, f + 1);
+    return true;
+  }
   if(save_repeat) {
     return file->write_rec(f, name);
   }else {
@@ -1842,23 +2372,48 @@ bool Datafile::write_real(const std::string &name, BoutReal *f, bool save_repeat
   }
 }
 
-bool Datafile::write_f2d(const std::string &name, Field2D *f, bool save_repeat) {
+bool Datafile::write_f2d(const std::string &name, Field2D *f, bool save_repeat,
+                         const Storage &storage) {
   if (!f->isAllocated()) {
     throw BoutException("Datafile::write_f2d: Field2D '%s' is not allocated!", name.c_str());
   }
+
+  BoutReal* data = &((*f)(0, 0));
+  int nx = mesh->LocalNx;
+  int ny = mesh->LocalNy;
+  if (aggregating()) {
+    data = gather(data, ny, 1, block_ny);
+    if (!writes_file) {
+      return true;
+    }
+    nx = block_nx;
+    ny = block_ny;
+  }
+
+  if (staging) {
+    auto& item = writer->job().add(OutputItem::Type::Real, name, save_repeat, nx, ny);
+    item.reals.assign(data, data + nx * ny);
+    bout::roundSignificantBits(item.reals.data(), item.reals.size(),
+                               storage.significant_bits);
+    return true;
+  }
+  if (storage.significant_bits > 0) {
+    data = roundBits(data, nx * ny, storage.significant_bits);
+  }
   if (save_repeat) {
-    if (!file->write_rec(&((*f)(0, 0)), name, mesh->LocalNx, mesh->LocalNy)) {
+    if (!file->write_rec(data, name, nx, ny)) {
       throw BoutException("Datafile::write_f2d: Failed to write %s!", name.c_str());
     }
   } else {
-    if (!file->write(&((*f)(0, 0)), name, mesh->LocalNx, mesh->LocalNy)) {
+    if (!file->write(data, name, nx, ny)) {
       throw BoutException("Datafile::write_f2d: Failed to write %s!", name.c_str());
     }
   }
   return true;
 }
 
-bool Datafile::write_f3d(const std::string &name, Field3D *f, bool save_repeat) {
+bool Datafile::write_f3d(const std::string &name, Field3D *f, bool save_repeat,
+                         const Storage &storage) {
   if (!f->isAllocated()) {
     throw BoutException("Datafile::write_f3d: Field3D '%s' is not allocated!", name.c_str());
   }
@@ -1871,14 +2426,48 @@ bool Datafile::write_f3d(const std::string &name, Field3D *f, bool save_repeat)
     f_out = *f;
   }
 
-  if(save_repeat) {
-    return file->write_rec(&(f_out(0,0,0)), name, mesh->LocalNx, mesh->LocalNy, mesh->LocalNz);
-  }else {
-    return file->write(&(f_out(0,0,0)), name, mesh->LocalNx, mesh->LocalNy, mesh->LocalNz);
+  BoutReal* data = &(f_out(0, 0, 0));
+  int nx = mesh->LocalNx;
+  int ny = mesh->LocalNy;
+  const int nz = storedNz(storage);
+  if (nz < mesh->LocalNz) {
+    data = reduceZ(data, storage.zmax, nz);
+  }
+  if (aggregating()) {
+    data = gather(data, ny, nz, block_ny);
+    if (!writes_file) {
+      return true;
+    }
+    nx = block_nx;
+    ny = block_ny;
+  }
+
+  if (staging) {
+    auto& item = writer->job().add(OutputItem::Type::Real, name, save_repeat, nx, ny, nz);
+    item.reals.assign(data, data + nx * ny * nz);
+    bout::roundSignificantBits(item.reals.data(), item.reals.size(),
+                               storage.significant_bits);
+    return true;
   }
+  if (storage.significant_bits > 0) {
+    data = roundBits(data, nx * ny * nz, storage.significant_bits);
+  }
+
+  file->setLocalNz(nz);
+  const bool success = save_repeat ? file->write_rec(data, name, nx, ny, nz)
+                                   : file->write(data, name, nx, ny, nz);
+  file->setLocalNz(-1);
+  return success;
 }
 
-bool Datafile::write_fperp(const std::string &name, FieldPerp *f, bool save_repeat) {
+bool Datafile::write_fperp(const std::string &name, FieldPerp *f, bool save_repeat,
+                           const Storage &storage) {
+  if (aggregate_y > 1) {
+    // Processors in different y rows would need to agree on the y index
+    throw BoutException("Datafile::write_fperp: Can't write FieldPerp '%s' with "
+                        "aggregate_y > 1", name.c_str());
+  }
+
   int yindex = f->getIndex();
   if (yindex >= 0 and yindex < mesh->LocalNy) {
     if (!f->isAllocated()) {
@@ -1893,10 +2482,33 @@ bool Datafile::write_fperp(const std::string &name, FieldPerp *f, bool save_repe
       f_out = *f;
     }
 
+    // All processors sharing a file are in the same y row, so agree on yindex
+    BoutReal* data = &(f_out(0, 0));
+    int nx = mesh->LocalNx;
+    const int nz = mesh->LocalNz;
+    if (aggregating()) {
+      data = gather(data, 1, nz, 1);
+      if (!writes_file) {
+        return true;
+      }
+      nx = block_nx;
+    }
+
+    if (staging) {
+      auto& item = writer->job().add(OutputItem::Type::Perp, name, save_repeat, nx, 0, nz);
+      item.reals.assign(data, data + nx * nz);
+      bout::roundSignificantBits(item.reals.data(), item.reals.size(),
+                                 storage.significant_bits);
+      return true;
+    }
+    if (storage.significant_bits > 0) {
+      data = roundBits(data, nx * nz, storage.significant_bits);
+    }
+
     if(save_repeat) {
-      return file->write_rec_perp(&(f_out(0,0)), name, mesh->LocalNx, mesh->LocalNz);
+      return file->write_rec_perp(data, name, nx, nz);
     }else {
-      return file->write_perp(&(f_out(0,0)), name, mesh->LocalNx, mesh->LocalNz);
+      return file->write_perp(data, name, nx, nz);
     }
   }
 
@@ -1905,6 +2517,175 @@ bool Datafile::write_fperp(const std::string &name, FieldPerp *f, bool save_repe
   return true;
 }
 
+Datafile::Storage Datafile::getStorage(const std::string& name) const {
+  Storage storage = default_storage;
+  if (options != nullptr and options->isSection(name)) {
+    auto& section = (*options)[name];
+    storage.compress = section["compress"].withDefault(storage.compress);
+    storage.shuffle = section["shuffle"].withDefault(storage.shuffle);
+    storage.significant_bits =
+        section["significant_bits"].withDefault(storage.significant_bits);
+    storage.zmax = section["zmax"].withDefault(storage.zmax);
+  }
+
+  if (storage.compress < 0 or storage.compress > 9) {
+    throw BoutException("Datafile: compress for %s must be between 0 and 9, not %d",
+                        name.c_str(), storage.compress);
+  }
+  if (storage.significant_bits < 0) {
+    throw BoutException("Datafile: significant_bits for %s can't be negative",
+                        name.c_str());
+  }
+  if (storage.zmax < -1) {
+    throw BoutException("Datafile: zmax for %s must be -1 (all modes) or more, not %d",
+                        name.c_str(), storage.zmax);
+  }
+  if (storage.zmax >= 0 and parallel) {
+    throw BoutException("Datafile: zmax for %s cannot be used with parallel output",
+                        name.c_str());
+  }
+  return storage;
+}
+
+int Datafile::storedNz(const Storage& storage) const {
+  // Modes up to zmax are kept exactly by 2 * (zmax + 1) points,
+  // for which the Nyquist mode is zero
+  const int nz = 2 * (storage.zmax + 1);
+  if (storage.zmax < 0 or nz >= mesh->LocalNz) {
+    return mesh->LocalNz;
+  }
+  return nz;
+}
+
+bool Datafile::addField2D(const std::string& name, bool save_repeat,
+                          const Storage& storage) {
+  file->setCompression(storage.compress, storage.shuffle);
+  return file->addVarField2D(name, save_repeat);
+}
+
+bool Datafile::addField3D(const std::string& name, bool save_repeat,
+                          const Storage& storage) {
+  file->setCompression(storage.compress, storage.shuffle);
+  file->setLocalNz(storedNz(storage));
+  const bool success = file->addVarField3D(name, save_repeat);
+  file->setLocalNz(-1);
+  return success;
+}
+
+bool Datafile::addFieldPerp(const std::string& name, bool save_repeat,
+                            const Storage& storage) {
+  file->setCompression(storage.compress, storage.shuffle);
+  return file->addVarFieldPerp(name, save_repeat);
+}
+
+BoutReal* Datafile::reduceZ(const BoutReal* data, int zmax, int nz) {
+  const int ncz = mesh->LocalNz;
+  const int nxy = mesh->LocalNx * mesh->LocalNy;
+  reduce_buffer.resize(nxy * nz);
+  bout::reduceZ(data, nxy, ncz, zmax, nz, reduce_buffer.data());
+  return reduce_buffer.data();
+}
+
+BoutReal* Datafile::roundBits(const BoutReal* data, int n, int bits) {
+  round_buffer.assign(data, data + n);
+  bout::roundSignificantBits(round_buffer.data(), round_buffer.size(), bits);
+  return round_buffer.data();
+}
+
+void Datafile::setupGroup() {
+  file_index = BoutComm::rank();
+  writes_file = true;
+  if (!aggregating()) {
+    return;
+  }
+
+  const int nxpe = mesh->getNXPE();
+  const int nype = mesh->getNYPE();
+  if (nxpe % aggregate_x != 0 or nype % aggregate_y != 0) {
+    throw BoutException("Datafile: aggregate_x (%d) and aggregate_y (%d) must divide "
+                        "NXPE (%d) and NYPE (%d)",
+                        aggregate_x, aggregate_y, nxpe, nype);
+  }
+
+  // Each block of aggregate_x by aggregate_y processors shares a file.
+  // The files are numbered as the processors of a run with the blocks as
+  // processors, and the first processor in the block writes the file
+  const int xind = mesh->getXProcIndex();
+  const int yind = mesh->getYProcIndex();
+  file_index = xind / aggregate_x + (nxpe / aggregate_x) * (yind / aggregate_y);
+  const int group_rank = xind % aggregate_x + aggregate_x * (yind % aggregate_y);
+  if (group_comm == MPI_COMM_NULL) {
+    MPI_Comm_split(BoutComm::get(), file_index, group_rank, &group_comm);
+  }
+  writes_file = group_rank == 0;
+
+  block_nx = (mesh->xend - mesh->xstart + 1) * aggregate_x + 2 * mesh->xstart;
+  block_ny = (mesh->yend - mesh->ystart + 1) * aggregate_y + 2 * mesh->ystart;
+  file->setLocalSize(block_nx, block_ny, mesh->LocalNz);
+  Lx = block_nx;
+  Ly = block_ny;
+}
+
+void Datafile::freeGroup() {
+  if (group_comm == MPI_COMM_NULL) {
+    return;
+  }
+  // The global dump file may outlive MPI
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (finalized == 0) {
+    MPI_Comm_free(&group_comm);
+  }
+  group_comm = MPI_COMM_NULL;
+}
+
+BoutReal* Datafile::gather(const BoutReal* data, int ny, int nz, int out_ny) {
+  const int nx = mesh->LocalNx;
+  const int nlocal = nx * ny * nz;
+  const int group_size = aggregate_x * aggregate_y;
+
+  if (writes_file) {
+    gather_buffer.resize(nlocal * group_size);
+  }
+  MPI_Gather(data, nlocal, MPI_DOUBLE, gather_buffer.data(), nlocal, MPI_DOUBLE, 0,
+             group_comm);
+  if (!writes_file) {
+    return nullptr;
+  }
+
+  // Put each processor's data into the block. Guard cells are only kept
+  // at the edges of the block, as collect would do
+  const int mxsub = mesh->xend - mesh->xstart + 1;
+  const int mysub = mesh->yend - mesh->ystart + 1;
+  block_buffer.resize(block_nx * out_ny * nz);
+  for (int proc = 0; proc < group_size; ++proc) {
+    const int ix = proc % aggregate_x;
+    const int iy = proc / aggregate_x;
+    const int xlo = ix == 0 ? 0 : mesh->xstart;
+    const int xhi = ix == aggregate_x - 1 ? nx : mesh->xend + 1;
+    const int ylo = iy == 0 ? 0 : mesh->ystart;
+    const int yhi = iy == aggregate_y - 1 ? ny : mesh->yend + 1;
+
+    const BoutReal* source = gather_buffer.data() + proc * nlocal;
+    for (int x = xlo; x < xhi; ++x) {
+      for (int y = ylo; y < yhi; ++y) {
+        const BoutReal* from = source + (x * ny + y) * nz;
+        std::copy(from, from + nz,
+                  block_buffer.data()
+                      + ((ix * mxsub + x) * out_ny + iy * mysub + y) * nz);
+      }
+    }
+  }
+  return block_buffer.data();
+}
+
+void Datafile::sync() {
+  OutputQueue::get().waitAll();
+  if (writer) {
+    writer->wait();
+  }
+}
+
 bool Datafile::varAdded(const std::string &name) {
   for(const auto& var : int_arr ) {
     if(name == var.name)
@@ -27,6 +27,18 @@ bool DataFormat::openw(const std::string &name, int mype, bool append) {
   return openw(base + "." + toString(mype) + "." + ext, append);
 }
 
+void DataFormat::setLocalSize(int nx, int ny, int nz) {
+  local_nx = nx;
+  local_ny = ny;
+  local_nz = nz;
+}
+
+void DataFormat::setLocalNz(int nz) { local_nz = nz; }
+
+int DataFormat::localNx() const { return local_nx < 0 ? mesh->LocalNx : local_nx; }
+int DataFormat::localNy() const { return local_ny < 0 ? mesh->LocalNy : local_ny; }
+int DataFormat::localNz() const { return local_nz < 0 ? mesh->LocalNz : local_nz; }
+
 bool DataFormat::setLocalOrigin(int x, int y, int z, int UNUSED(offset_x),
                                 int UNUSED(offset_y), int UNUSED(offset_z)) {
   // This function should not be called from the DataFormat in GridFromFile, which is
@@ -272,6 +272,9 @@ bool H5Format::addVar(const std::string &name, bool repeat, hid_t write_hdf5_typ
     throw BoutException("Unrecognized datatype '"+datatype+"'");
   }
 
+  // Only fields are compressed
+  const bool compress = compression_level > 0 and datatype.compare(0, 5, "Field") == 0;
+
   if (repeat) {
     // add time dimension
     datatype += "_t";
@@ -290,13 +293,13 @@ bool H5Format::addVar(const std::string &name, bool repeat, hid_t write_hdf5_typ
     }
     else {
       init_size[0]=0;
-      init_size[1] = lx == 0 ? mesh->LocalNx : lx;
+      init_size[1] = lx == 0 ? localNx() : lx;
       if (datatype == "FieldPerp_t") {
-        init_size[2] = lz == 0 ? mesh->LocalNz : lz;
+        init_size[2] = lz == 0 ? localNz() : lz;
       } else {
-        init_size[2] = ly == 0 ? mesh->LocalNy : ly;
+        init_size[2] = ly == 0 ? localNy() : ly;
       }
-      init_size[3] = lz == 0 ? mesh->LocalNz : lz;
+      init_size[3] = lz == 0 ? localNz() : lz;
     }
 
     // Modify dataset creation properties, i.e. enable chunking.
@@ -306,8 +309,15 @@ bool H5Format::addVar(const std::string &name, bool repeat, hid_t write_hdf5_typ
     hsize_t chunk_dims[4],max_dims[4];
     max_dims[0] = H5S_UNLIMITED; max_dims[1]=init_size[1]; max_dims[2]=init_size[2]; max_dims[3]=init_size[3];
     chunk_dims[0] = chunk_length; chunk_dims[1]=init_size[1]; chunk_dims[2]=init_size[2]; chunk_dims[3]=init_size[3];
+    if (compress) {
+      // One record per chunk, so that each chunk is compressed once when written
+      chunk_dims[0] = 1;
+    }
     if (H5Pset_chunk(propertyList, nd, chunk_dims) < 0)
       throw BoutException("Failed to set chunk property");
+    if (compress) {
+      setFilters(propertyList);
+    }
 
     hid_t init_space = H5Screate_simple(nd, init_size, max_dims);
     if (init_space < 0)
@@ -361,13 +371,13 @@ bool H5Format::addVar(const std::string &name, bool repeat, hid_t write_hdf5_typ
         }
         init_size[2] = lz == 0 ? mesh->GlobalNz : lz;
       } else {
-        init_size[0] = lx == 0 ? mesh->LocalNx : lx;
+        init_size[0] = lx == 0 ? localNx() : lx;
         if (datatype == "FieldPerp") {
-          init_size[1] = lz == 0 ? mesh->LocalNz : lz;
+          init_size[1] = lz == 0 ? localNz() : lz;
         } else {
-          init_size[1] = ly == 0 ? mesh->LocalNy : ly;
+          init_size[1] = ly == 0 ? localNy() : ly;
         }
-        init_size[2] = lz == 0 ? mesh->LocalNz : lz;
+        init_size[2] = lz == 0 ? localNz() : lz;
       }
 
       // Create value for attribute to say what kind of field this is
@@ -381,10 +391,27 @@ bool H5Format::addVar(const std::string &name, bool repeat, hid_t write_hdf5_typ
       hid_t init_space = H5Screate_simple(nd, init_size, init_size);
       if (init_space < 0)
         throw BoutException("Failed to create init_space");
-      dataSet = H5Dcreate(dataFile, name.c_str(), write_hdf5_type, init_space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+      // Compressed datasets must be chunked, so use a single chunk
+      hid_t propertyList = H5P_DEFAULT;
+      if (compress) {
+        propertyList = H5Pcreate(H5P_DATASET_CREATE);
+        if (propertyList < 0)
+          throw BoutException("Failed to create propertyList");
+        if (H5Pset_chunk(propertyList, nd, init_size) < 0)
+          throw BoutException("Failed to set chunk property");
+        setFilters(propertyList);
+      }
+
+      dataSet = H5Dcreate(dataFile, name.c_str(), write_hdf5_type, init_space, H5P_DEFAULT, propertyList, H5P_DEFAULT);
       if (dataSet < 0)
         throw BoutException("Failed to create dataSet");
 
+      if (compress) {
+        if (H5Pclose(propertyList) < 0)
+          throw BoutException("Failed to close propertyList");
+      }
+
       // Add attribute to say what kind of field this is
       setAttribute(dataSet, "bout_type", datatype);
     }
@@ -395,6 +422,15 @@ bool H5Format::addVar(const std::string &name, bool repeat, hid_t write_hdf5_typ
   return true;
 }
 
+void H5Format::setFilters(hid_t propertyList) {
+  if (compression_shuffle) {
+    if (H5Pset_shuffle(propertyList) < 0)
+      throw BoutException("Failed to set shuffle filter");
+  }
+  if (H5Pset_deflate(propertyList, compression_level) < 0)
+    throw BoutException("Failed to set deflate filter");
+}
+
 bool H5Format::addVarInt(const std::string &name, bool repeat) {
   return addVar(name, repeat, H5T_NATIVE_INT, "scalar");
 }
@@ -630,9 +666,9 @@ bool H5Format::write(void *data, hid_t mem_hdf5_type, const char *name, int lx,
   offset_local[0] = x0_local;
   offset_local[1] = y0_local;
   offset_local[2] = z0_local;
-  init_size_local[0] = mesh->LocalNx;
-  init_size_local[1] = mesh->LocalNy;
-  init_size_local[2] = mesh->LocalNz;
+  init_size_local[0] = localNx();
+  init_size_local[1] = localNy();
+  init_size_local[2] = localNz();
 
   if (nd==0) {
     // Need to write a scalar, not a 0-d array
@@ -697,8 +733,8 @@ bool H5Format::write_perp(BoutReal *data, const std::string& name, int lx, int l
   offset[1] = z0;
   offset_local[0] = x0_local;
   offset_local[1] = z0_local;
-  init_size_local[0] = mesh->LocalNx;
-  init_size_local[1] = mesh->LocalNz;
+  init_size_local[0] = localNx();
+  init_size_local[1] = localNz();
 
   if (nd==0) {
     // Need to write a scalar, not a 0-d array
@@ -805,9 +841,9 @@ bool H5Format::read_rec(void *data, hid_t hdf5_type, const char *name, int lx, i
   offset_local[0] = x0_local;
   offset_local[1] = y0_local;
   offset_local[2] = z0_local;
-  init_size_local[0] = mesh->LocalNx;
-  init_size_local[1] = mesh->LocalNy;
-  init_size_local[2] = mesh->LocalNz;
+  init_size_local[0] = localNx();
+  init_size_local[1] = localNy();
+  init_size_local[2] = localNz();
 
   if (nd == 1) {
     // Need to write a time-series of scalars
@@ -876,8 +912,8 @@ bool H5Format::read_rec_perp(BoutReal *data, const std::string& name, int lx, in
   offset[2] = z0;
   offset_local[0] = x0_local;
   offset_local[1] = z0_local;
-  init_size_local[0] = mesh->LocalNx;
-  init_size_local[1] = mesh->LocalNz;
+  init_size_local[0] = localNx();
+  init_size_local[1] = localNz();
 
   if (nd == 1) {
     // Need to write a time-series of scalars
@@ -989,9 +1025,9 @@ bool H5Format::write_rec(void *data, hid_t mem_hdf5_type, const char *name, int
   offset_local[0] = x0_local;
   offset_local[1] = y0_local;
   offset_local[2] = z0_local;
-  init_size_local[0] = mesh->LocalNx;
-  init_size_local[1] = mesh->LocalNy;
-  init_size_local[2] = mesh->LocalNz;
+  init_size_local[0] = localNx();
+  init_size_local[1] = localNy();
+  init_size_local[2] = localNz();
 
   if (nd_local == 0) {
     nd_local = 1;
@@ -1082,8 +1118,8 @@ bool H5Format::write_rec_perp(BoutReal *data, const std::string& name, int lx, i
   offset[2] = z0;
   offset_local[0] = x0_local;
   offset_local[1] = z0_local;
-  init_size_local[0] = mesh->LocalNx;
-  init_size_local[1] = mesh->LocalNz;
+  init_size_local[0] = localNx();
+  init_size_local[1] = localNz();
 
   if (nd_local == 0) {
     nd_local = 1;
@@ -127,6 +127,10 @@ class H5Format : public DataFormat {
   bool write_rec_perp(BoutReal *var, const std::string &name, int lx = 0, int lz = 0) override;
   
   void setLowPrecision() override { lowPrecision = true; }
+  void setCompression(int level, bool shuffle) override {
+    compression_level = level;
+    compression_shuffle = shuffle;
+  }
 
   // Attributes
 
@@ -156,6 +160,12 @@ class H5Format : public DataFormat {
   
   hsize_t chunk_length;
 
+  int compression_level{0}; ///< Deflate level of field variables, 0 for none
+  bool compression_shuffle{false}; ///< Shuffle bytes before compressing
+
+  /// Add the filters to compress a dataset to \p propertyList
+  void setFilters(hid_t propertyList);
+
   bool addVar(const std::string &name, bool repeat, hid_t write_hdf5_type, std::string datatype,
               int lx = 0, int ly = 0, int lz = 0);
   bool read(void *var, hid_t hdf5_type, const char *name, int lx = 1, int ly = 0, int lz = 0);
@@ -103,9 +103,9 @@ bool NcFormat::openr(const char *name) {
     xDim = nullptr;
   } else if (mesh != nullptr) {
     // Check that the dimension size is correct
-    if (xDim->size() != mesh->LocalNx) {
+    if (xDim->size() != localNx()) {
       throw BoutException("X dimension incorrect. Expected %lu, got %lu",
-                          static_cast<long unsigned>(mesh->LocalNx),
+                          static_cast<long unsigned>(localNx()),
                           static_cast<long unsigned>(xDim->size()));
     }
   }
@@ -120,9 +120,9 @@ bool NcFormat::openr(const char *name) {
     yDim = nullptr;
   } else if (mesh != nullptr) {
     // Check that the dimension size is correct
-    if(yDim->size() != mesh->LocalNy) {
+    if(yDim->size() != localNy()) {
       throw BoutException("Y dimension incorrect. Expected %lu, got %lu",
-                          static_cast<long unsigned>(mesh->LocalNy),
+                          static_cast<long unsigned>(localNy()),
                           static_cast<long unsigned>(yDim->size()));
     }
   }
@@ -135,9 +135,9 @@ bool NcFormat::openr(const char *name) {
     zDim = nullptr;
   } else if (mesh != nullptr) {
     // Check that the dimension size is correct
-    if(zDim->size() != mesh->LocalNz) {
+    if(zDim->size() != localNz()) {
       throw BoutException("Z dimension incorrect. Expected %lu, got %lu",
-                          static_cast<long unsigned>(mesh->LocalNz),
+                          static_cast<long unsigned>(localNz()),
                           static_cast<long unsigned>(zDim->size()));
     }
   }
@@ -215,7 +215,7 @@ bool NcFormat::openw(const char *name, bool append) {
 
     /// Test they're the right size (and t is unlimited)
     
-    if((xDim->size() != mesh->LocalNx) || (yDim->size() != mesh->LocalNy) || (zDim->size() != mesh->LocalNz)
+    if((xDim->size() != localNx()) || (yDim->size() != localNy()) || (zDim->size() != localNz())
        || (!tDim->is_unlimited()) ) {
       delete dataFile;
       dataFile = nullptr;
@@ -236,19 +236,19 @@ bool NcFormat::openw(const char *name, bool append) {
 
     /// Add the dimensions
     
-    if(!(xDim = dataFile->add_dim("x", mesh->LocalNx))) {
+    if(!(xDim = dataFile->add_dim("x", localNx()))) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
   
-    if(!(yDim = dataFile->add_dim("y", mesh->LocalNy))) {
+    if(!(yDim = dataFile->add_dim("y", localNy()))) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
     
-    if(!(zDim = dataFile->add_dim("z", mesh->LocalNz))) {
+    if(!(zDim = dataFile->add_dim("z", localNz()))) {
       delete dataFile;
       dataFile = nullptr;
       return false;
@@ -562,10 +562,20 @@ bool NcFormat::addVarField3D(const string &name, bool repeat) {
   if (!(var = dataFile->get_var(name.c_str()))) {
     // Variable not in file, so add it.
     auto nc_float_type = lowPrecision ? ncFloat : ncDouble;
+    const NcDim* dims[4] = {recDimList[0], recDimList[1], recDimList[2], recDimList[3]};
+    if (zDim->size() != localNz()) {
+      // Fewer z points than the mesh, so needs its own dimension
+      const auto z_dim_name = "z" + std::to_string(localNz());
+      NcDim* reduced_z_dim = dataFile->get_dim(z_dim_name.c_str());
+      if (!reduced_z_dim) {
+        reduced_z_dim = dataFile->add_dim(z_dim_name.c_str(), localNz());
+      }
+      dims[3] = reduced_z_dim;
+    }
     if (repeat)
-      var = dataFile->add_var(name.c_str(), nc_float_type, 4, recDimList);
+      var = dataFile->add_var(name.c_str(), nc_float_type, 4, dims);
     else
-      var = dataFile->add_var(name.c_str(), nc_float_type, 3, dimList);
+      var = dataFile->add_var(name.c_str(), nc_float_type, 3, dims + 1);
 
     if(!var->is_valid()) {
       output_error.write("ERROR: NetCDF could not add Field3D '%s' to file '%s'\n", name.c_str(), fname);
@@ -189,9 +189,9 @@ bool Ncxx4::openw(const char *name, bool append) {
     }
 
     /// Test they're the right size (and t is unlimited)
-    if ((xDim.getSize() != static_cast<size_t>(mesh->LocalNx)) ||
-        (yDim.getSize() != static_cast<size_t>(mesh->LocalNy)) ||
-        (zDim.getSize() != static_cast<size_t>(mesh->LocalNz)) || (!tDim.isUnlimited())) {
+    if ((xDim.getSize() != static_cast<size_t>(localNx())) ||
+        (yDim.getSize() != static_cast<size_t>(localNy())) ||
+        (zDim.getSize() != static_cast<size_t>(localNz())) || (!tDim.isUnlimited())) {
       delete dataFile;
       dataFile = nullptr;
       return false;
@@ -215,21 +215,21 @@ bool Ncxx4::openw(const char *name, bool append) {
 
     /// Add the dimensions
     
-    xDim = dataFile->addDim("x", mesh->LocalNx);
+    xDim = dataFile->addDim("x", localNx());
     if(xDim.isNull()) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
   
-    yDim = dataFile->addDim("y", mesh->LocalNy);
+    yDim = dataFile->addDim("y", localNy());
     if(yDim.isNull()) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
     
-    zDim = dataFile->addDim("z", mesh->LocalNz);
+    zDim = dataFile->addDim("z", localNz());
     if(zDim.isNull()) {
       delete dataFile;
       dataFile = nullptr;
@@ -491,6 +491,7 @@ bool Ncxx4::addVarField2D(const string &name, bool repeat) {
       output_error.write("ERROR: NetCDF could not add Field2D '%s' to file '%s'\n", name.c_str(), fname);
       return false;
     }
+    compress(var, repeat);
   }
   return true;
 }
@@ -502,22 +503,28 @@ bool Ncxx4::addVarField3D(const string &name, bool repeat) {
   NcVar var = dataFile->getVar(name);
   if(var.isNull()) {
     // Variable not in file, so add it.
+    auto dims = repeat ? getRecDimVec(4) : getDimVec(3);
+    if (static_cast<int>(zDim.getSize()) != localNz()) {
+      // Fewer z points than the mesh, so needs its own dimension
+      const auto z_dim_name = "z" + std::to_string(localNz());
+      auto reduced_z_dim = dataFile->getDim(z_dim_name);
+      if (reduced_z_dim.isNull()) {
+        reduced_z_dim = dataFile->addDim(z_dim_name, localNz());
+      }
+      dims.back() = reduced_z_dim;
+    }
+
     if(lowPrecision) {
-      if (repeat)
-        var = dataFile->addVar(name, ncFloat, getRecDimVec(4));
-      else
-        var = dataFile->addVar(name, ncFloat, getDimVec(3));
+      var = dataFile->addVar(name, ncFloat, dims);
     } else {
-      if (repeat)
-        var = dataFile->addVar(name, ncDouble, getRecDimVec(4));
-      else
-        var = dataFile->addVar(name, ncDouble, getDimVec(3));
+      var = dataFile->addVar(name, ncDouble, dims);
     }
 
     if(var.isNull()) {
       output_error.write("ERROR: NetCDF could not add Field3D '%s' to file '%s'\n", name.c_str(), fname);
       return false;
     }
+    compress(var, repeat);
   }
   return true;
 }
@@ -549,6 +556,7 @@ bool Ncxx4::addVarFieldPerp(const string &name, bool repeat) {
       output_error.write("ERROR: NetCDF could not add FieldPerp '%s' to file '%s'\n", name.c_str(), fname);
       return false;
     }
+    compress(var, repeat);
   }
   return true;
 }
@@ -1413,5 +1421,20 @@ std::vector<NcDim> Ncxx4::getRecDimVec(int nd) {
   return vec;
 }
 
+void Ncxx4::compress(NcVar &var, bool repeat) {
+  if (compression_level == 0) {
+    return;
+  }
+  if (repeat) {
+    // One record per chunk, so that each chunk is compressed once when written
+    std::vector<size_t> chunks;
+    for (const auto &dim : var.getDims()) {
+      chunks.push_back(dim.isUnlimited() ? 1 : dim.getSize());
+    }
+    var.setChunking(NcVar::nc_CHUNKED, chunks);
+  }
+  var.setCompression(compression_shuffle, true, compression_level);
+}
+
 #endif // NCDF
 
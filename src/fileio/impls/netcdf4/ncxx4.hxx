@@ -132,6 +132,10 @@ class Ncxx4 : public DataFormat {
   bool write_rec_perp(BoutReal *var, const std::string &name, int lx = 0, int lz = 0) override;
   
   void setLowPrecision() override { lowPrecision = true; }
+  void setCompression(int level, bool shuffle) override {
+    compression_level = level;
+    compression_shuffle = shuffle;
+  }
 
   // Attributes
 
@@ -160,6 +164,9 @@ private:
   bool appending;
   bool lowPrecision; ///< When writing, down-convert to floats
 
+  int compression_level{0}; ///< Deflate level of field variables, 0 for none
+  bool compression_shuffle{false}; ///< Shuffle bytes before compressing
+
   int x0, y0, z0, t0; ///< Data origins
 
   std::map<std::string, int> rec_nr; // Record number for each variable (bit nasty)
@@ -167,6 +174,9 @@ private:
   
   std::vector<netCDF::NcDim> getDimVec(int nd);
   std::vector<netCDF::NcDim> getRecDimVec(int nd);
+
+  /// Set the chunking and compression of a new field variable
+  void compress(netCDF::NcVar &var, bool repeat);
 };
 
 #endif // __NCFORMAT4_H__
@@ -31,11 +31,18 @@
 #include <unused.hxx>
 
 #ifdef BOUT_HAS_FFTW
+#include <boutcomm.hxx>
 #include <bout/constants.hxx>
 #include <bout/openmpwrap.hxx>
+#include <output.hxx>
 
 #include <fftw3.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <map>
+#include <string>
+#include <tuple>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -51,6 +58,8 @@ namespace fft {
 bool fft_initialised{false};
 /// Should FFTW find an optimised plan by measuring various plans?
 FFT_MEASUREMENT_FLAG fft_measurement_flag{FFT_MEASUREMENT_FLAG::estimate};
+/// File to load FFTW wisdom from and save it to. Empty if not used
+std::string fft_wisdom_file;
 
 void fft_init(Options* options) {
   if (fft_initialised) {
@@ -63,8 +72,19 @@ void fft_init(Options* options) {
                     .doc("Perform speed measurements to optimise settings?")
                     .withDefault(false);
   fft_measurement_flag = (*options)["fft_measurement_flag"]
-                    .doc("Level speed measurements to optimise FFT settings: [estimate], measure, exhaustive")
+                    .doc("Level speed measurements to optimise FFT settings: [estimate], measure, patient, exhaustive")
                     .withDefault(FFT_MEASUREMENT_FLAG::estimate);
+  fft_wisdom_file = (*options)["fft_wisdom_file"]
+                    .doc("File to load FFTW wisdom from, and save new wisdom to")
+                    .withDefault(std::string{});
+
+#ifdef BOUT_HAS_FFTW
+  if (!fft_wisdom_file.empty()) {
+    if (fftw_import_wisdom_from_filename(fft_wisdom_file.c_str()) == 0) {
+      output_info.write("Could not read FFTW wisdom from '%s'\n", fft_wisdom_file.c_str());
+    }
+  }
+#endif
 
   if ((*options)["fft_measure"].isSet()) {
     output << "WARNING: fft_measure is deprecated and will be removed in BOUT++ v5.0. "
@@ -84,6 +104,8 @@ unsigned int get_measurement_flag(FFT_MEASUREMENT_FLAG fft_measurement_flag) {
       return FFTW_ESTIMATE;
     case FFT_MEASUREMENT_FLAG::measure:
       return FFTW_MEASURE;
+    case FFT_MEASUREMENT_FLAG::patient:
+      return FFTW_PATIENT;
     case FFT_MEASUREMENT_FLAG::exhaustive:
       return FFTW_EXHAUSTIVE;
     default:
@@ -375,6 +397,200 @@ void irfft(MAYBE_UNUSED(const dcomplex *in), MAYBE_UNUSED(int length), MAYBE_UNU
 }
 #endif
 
+/***********************************************************
+ * Batched real FFTs
+ ***********************************************************/
+
+#ifdef BOUT_HAS_FFTW
+namespace {
+/// Cached plans are keyed on the signal length, the number of
+/// signals, and whether the arrays are not aligned for SIMD
+using BatchPlanKey = std::tuple<int, int, bool>;
+
+/// Are both arrays aligned in the same way fftw_malloc would align them?
+bool fftwAligned(const void* in, const void* out) {
+  return (fftw_alignment_of(static_cast<double*>(const_cast<void*>(in))) == 0)
+         and (fftw_alignment_of(static_cast<double*>(const_cast<void*>(out))) == 0);
+}
+
+/// Has a plan been made since the wisdom was last saved? Set by
+/// both planners, so atomic
+std::atomic<bool> new_wisdom{false};
+
+/// Find or make a plan for \p howmany real-to-complex transforms of
+/// size \p length. Planning is not thread safe, so must be done
+/// inside a critical section
+fftw_plan getPlanR2C(int length, int howmany, bool unaligned) {
+  static std::map<BatchPlanKey, fftw_plan> plans;
+
+  fftw_plan plan;
+  BOUT_OMP(critical(rfft_many))
+  {
+    const auto key = std::make_tuple(length, howmany, unaligned);
+    const auto found = plans.find(key);
+    if (found != plans.end()) {
+      plan = found->second;
+    } else {
+      fft_init();
+
+      const int nmodes = (length / 2) + 1;
+
+      // Plan with temporary arrays, as planning may overwrite them.
+      // The plan is later executed on the user's arrays
+      auto* fin = static_cast<double*>(fftw_malloc(sizeof(double) * length * howmany));
+      auto* fout = static_cast<fftw_complex*>(
+          fftw_malloc(sizeof(fftw_complex) * nmodes * howmany));
+
+      auto flags = get_measurement_flag(fft_measurement_flag) | FFTW_PRESERVE_INPUT;
+      if (unaligned) {
+        flags |= FFTW_UNALIGNED;
+      }
+
+      plan = fftw_plan_many_dft_r2c(1, &length, howmany, fin, nullptr, 1, length, fout,
+                                    nullptr, 1, nmodes, flags);
+      fftw_free(fin);
+      fftw_free(fout);
+
+      plans.emplace(key, plan);
+      new_wisdom = true;
+    }
+  }
+  return plan;
+}
+
+/// Find or make a plan for \p howmany complex-to-real transforms of
+/// size \p length
+fftw_plan getPlanC2R(int length, int howmany, bool unaligned) {
+  static std::map<BatchPlanKey, fftw_plan> plans;
+
+  fftw_plan plan;
+  BOUT_OMP(critical(irfft_many))
+  {
+    const auto key = std::make_tuple(length, howmany, unaligned);
+    const auto found = plans.find(key);
+    if (found != plans.end()) {
+      plan = found->second;
+    } else {
+      fft_init();
+
+      const int nmodes = (length / 2) + 1;
+
+      auto* fin = static_cast<fftw_complex*>(
+          fftw_malloc(sizeof(fftw_complex) * nmodes * howmany));
+      auto* fout = static_cast<double*>(fftw_malloc(sizeof(double) * length * howmany));
+
+      auto flags = get_measurement_flag(fft_measurement_flag);
+      if (unaligned) {
+        flags |= FFTW_UNALIGNED;
+      }
+
+      plan = fftw_plan_many_dft_c2r(1, &length, howmany, fin, nullptr, 1, nmodes, fout,
+                                    nullptr, 1, length, flags);
+      fftw_free(fin);
+      fftw_free(fout);
+
+      plans.emplace(key, plan);
+      new_wisdom = true;
+    }
+  }
+  return plan;
+}
+
+/// Transform a batch of signals on the calling thread
+void rfftBatch(const BoutReal* in, int howmany, int length, dcomplex* out) {
+  const fftw_plan plan = getPlanR2C(length, howmany, not fftwAligned(in, out));
+
+  // Input is preserved, so safe to cast away const
+  fftw_execute_dft_r2c(plan, const_cast<BoutReal*>(in),
+                       reinterpret_cast<fftw_complex*>(out));
+
+  const BoutReal fac = 1.0 / static_cast<BoutReal>(length);
+  const int ntotal = howmany * ((length / 2) + 1);
+  for (int i = 0; i < ntotal; i++) {
+    out[i] *= fac;
+  }
+}
+
+/// Inverse transform a batch of signals on the calling thread
+void irfftBatch(const dcomplex* in, int howmany, int length, BoutReal* out) {
+  // Complex-to-real transforms overwrite their input, so work on a copy
+  const int ntotal = howmany * ((length / 2) + 1);
+  Array<dcomplex> fin(ntotal);
+  std::copy_n(in, ntotal, fin.begin());
+
+  const fftw_plan plan = getPlanC2R(length, howmany, not fftwAligned(fin.begin(), out));
+
+  fftw_execute_dft_c2r(plan, reinterpret_cast<fftw_complex*>(fin.begin()), out);
+}
+
+/// Split \p howmany signals between threads, if not already inside a
+/// parallel region, and call \p batch on each chunk
+template <typename In, typename Out, typename F>
+void splitBatch(const In* in, MAYBE_UNUSED(int in_dist), int howmany, int length,
+                Out* out, MAYBE_UNUSED(int out_dist), F batch) {
+#ifdef _OPENMP
+  if (not omp_in_parallel() and omp_get_max_threads() > 1 and howmany > 1) {
+    BOUT_OMP(parallel)
+    {
+      const int n_th = omp_get_num_threads();
+      const int th_id = omp_get_thread_num();
+      // Split signals as evenly as possible, giving the first threads
+      // one extra signal if needed
+      const int chunk = howmany / n_th;
+      const int extra = howmany % n_th;
+      const int start = th_id * chunk + std::min(th_id, extra);
+      const int count = chunk + ((th_id < extra) ? 1 : 0);
+      if (count > 0) {
+        batch(in + start * in_dist, count, length, out + start * out_dist);
+      }
+    }
+    return;
+  }
+#endif
+  batch(in, howmany, length, out);
+}
+} // namespace
+#endif
+
+void fft_save_wisdom() {
+#ifdef BOUT_HAS_FFTW
+  // Only done on one processor, as all processors plan the same sizes
+  if (not new_wisdom.exchange(false) or fft_wisdom_file.empty() or BoutComm::rank() != 0) {
+    return;
+  }
+  if (fftw_export_wisdom_to_filename(fft_wisdom_file.c_str()) == 0) {
+    output_warn.write("WARNING: Could not write FFTW wisdom to '%s'\n",
+                      fft_wisdom_file.c_str());
+  }
+#endif
+}
+
+void rfft_many(MAYBE_UNUSED(const BoutReal* in), MAYBE_UNUSED(int howmany),
+               MAYBE_UNUSED(int length), MAYBE_UNUSED(dcomplex* out)) {
+#ifndef BOUT_HAS_FFTW
+  throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
+#else
+  ASSERT1(length > 0);
+  if (howmany <= 0) {
+    return;
+  }
+  splitBatch(in, length, howmany, length, out, (length / 2) + 1, rfftBatch);
+#endif
+}
+
+void irfft_many(MAYBE_UNUSED(const dcomplex* in), MAYBE_UNUSED(int howmany),
+                MAYBE_UNUSED(int length), MAYBE_UNUSED(BoutReal* out)) {
+#ifndef BOUT_HAS_FFTW
+  throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
+#else
+  ASSERT1(length > 0);
+  if (howmany <= 0) {
+    return;
+  }
+  splitBatch(in, (length / 2) + 1, howmany, length, out, length, irfftBatch);
+#endif
+}
+
 //  Discrete sine transforms (B Shanahan)
 
 void DST(MAYBE_UNUSED(const BoutReal *in), MAYBE_UNUSED(int length), MAYBE_UNUSED(dcomplex *out)) {
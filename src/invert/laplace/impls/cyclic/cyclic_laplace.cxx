@@ -54,6 +54,10 @@ LaplaceCyclic::LaplaceCyclic(Options *opt, const CELL_LOC loc, Mesh *mesh_in)
   // Get options
 
   OPTION(opt, dst, false);
+  // Reuse the factorised matrix between Field3D solves if the coefficients,
+  // flags and metric are unchanged. Changes to the metric are only seen
+  // once Coordinates::geometry() has been called
+  OPTION(opt, cache_coefs, true);
 
   if(dst) {
     nmode = localmesh->LocalNz-2;
@@ -87,10 +91,67 @@ LaplaceCyclic::LaplaceCyclic(Options *opt, const CELL_LOC loc, Mesh *mesh_in)
 }
 
 LaplaceCyclic::~LaplaceCyclic() {
-  // Delete tridiagonal solver
+  // Delete tridiagonal solvers
   delete cr;
 }
 
+void LaplaceCyclic::setCoef(Field2D &coef, const Field2D &val) {
+  ASSERT1(val.getLocation() == location);
+  ASSERT1(localmesh == val.getMesh());
+
+  if (coefs_cached && val.isAllocated()) {
+    bool same = true;
+    for (const auto& i : coef.getRegion("RGN_ALL")) {
+      if (coef[i] != val[i]) {
+        same = false;
+        break;
+      }
+    }
+    if (same) {
+      return;
+    }
+  }
+  coefs_cached = false;
+
+  // Take a copy, so that later changes to val are not missed
+  coef = copy(val);
+}
+
+void LaplaceCyclic::zeroBoundaryRHS(Matrix<dcomplex> &bk) const {
+  const int nsys = std::get<0>(bk.shape());
+  for (int ind = 0; ind < nsys; ind++) {
+    Laplacian::zeroBoundaryRHS(&bk(ind, 0), global_flags, inner_boundary_flags,
+                               outer_boundary_flags, false);
+  }
+}
+
+CyclicReduce<dcomplex>& LaplaceCyclic::solver3D(int nrhs) {
+  auto& solver = cr3d[nrhs];
+  if (solver) {
+    return *solver;
+  }
+
+  solver = bout::utils::make_unique<CyclicReduce<dcomplex>>(localmesh->getXcomm(),
+                                                            xe - xs + 1);
+  solver->setPeriodic(localmesh->periodicX);
+  if (nrhs == 1) {
+    solver->setCoefs(a3D, b3D, c3D);
+    return *solver;
+  }
+
+  // Same matrix for each of the right hand sides
+  const int nsys = std::get<0>(a3D.shape());
+  const int nx = std::get<1>(a3D.shape());
+  Matrix<dcomplex> a(nrhs * nsys, nx), b(nrhs * nsys, nx), c(nrhs * nsys, nx);
+  for (int r = 0; r < nrhs; r++) {
+    std::copy(a3D.begin(), a3D.end(), &a(r * nsys, 0));
+    std::copy(b3D.begin(), b3D.end(), &b(r * nsys, 0));
+    std::copy(c3D.begin(), c3D.end(), &c(r * nsys, 0));
+  }
+  solver->setCoefs(a, b, c);
+  return *solver;
+}
+
 FieldPerp LaplaceCyclic::solve(const FieldPerp& rhs, const FieldPerp& x0) {
   ASSERT1(localmesh == rhs.getMesh() && localmesh == x0.getMesh());
   ASSERT1(rhs.getLocation() == location);
@@ -257,15 +318,35 @@ FieldPerp LaplaceCyclic::solve(const FieldPerp& rhs, const FieldPerp& x0) {
 }
 
 Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
-  TRACE("LaplaceCyclic::solve(Field3D, Field3D)");
+  return solve(std::vector<Field3D>{rhs}, std::vector<Field3D>{x0}).front();
+}
 
-  ASSERT1(rhs.getLocation() == location);
-  ASSERT1(x0.getLocation() == location);
-  ASSERT1(localmesh == rhs.getMesh() && localmesh == x0.getMesh());
+std::vector<Field3D> LaplaceCyclic::solve(const std::vector<Field3D>& rhs,
+                                          const std::vector<Field3D>& x0) {
+  TRACE("LaplaceCyclic::solve(vector<Field3D>, vector<Field3D>)");
+
+  if (rhs.size() != x0.size()) {
+    throw BoutException("LaplaceCyclic::solve: %d right hand sides but %d initial guesses",
+                        static_cast<int>(rhs.size()), static_cast<int>(x0.size()));
+  }
+  const int nrhs = rhs.size();
+  if (nrhs == 0) {
+    return {};
+  }
+
+  for (int r = 0; r < nrhs; r++) {
+    ASSERT1(rhs[r].getLocation() == location);
+    ASSERT1(x0[r].getLocation() == location);
+    ASSERT1(localmesh == rhs[r].getMesh() && localmesh == x0[r].getMesh());
+  }
 
   Timer timer("invert");
 
-  Field3D x{emptyFrom(rhs)}; // Result
+  std::vector<Field3D> x; // Result
+  x.reserve(nrhs);
+  for (const auto& b : rhs) {
+    x.push_back(emptyFrom(b));
+  }
 
   // Get the width of the boundary
 
@@ -299,15 +380,34 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
   }
 
   const int ny = (ye - ys + 1); // Number of Y points
-  const int nsys = nmode * ny;  // Number of systems of equations to solve
+  const int nsys = nmode * ny;  // Number of systems of equations for each RHS
   const int nxny = nx * ny;     // Number of points in X-Y
 
-  auto a3D = Matrix<dcomplex>(nsys, nx);
-  auto b3D = Matrix<dcomplex>(nsys, nx);
-  auto c3D = Matrix<dcomplex>(nsys, nx);
+  // The systems for all the right hand sides are solved together, so
+  // each communication in the cyclic reduction carries all of them.
+  // System index is (r * ny + iy - ys) * nmode + kz for right hand side r
+  const int nsys_all = nrhs * nsys;
+
+  // The matrix only needs calculating if something has changed since the
+  // last solve. Changes to the coefficients are checked in setCoef
+  // The matrix for one right hand side is kept, and the solvers for any
+  // number of right hand sides are factorised from it
+  const bool reuse = cache_coefs && coefs_cached
+                     && (coords->getGeneration() == cached_generation)
+                     && (ys == cached_ys) && (ye == cached_ye)
+                     && (global_flags == cached_global_flags)
+                     && (inner_boundary_flags == cached_inner_flags)
+                     && (outer_boundary_flags == cached_outer_flags);
+
+  if (!reuse) {
+    a3D.reallocate(nsys, nx);
+    b3D.reallocate(nsys, nx);
+    c3D.reallocate(nsys, nx);
+    cr3d.clear();
+  }
 
-  auto xcmplx3D = Matrix<dcomplex>(nsys, nx);
-  auto bcmplx3D = Matrix<dcomplex>(nsys, nx);
+  auto xcmplx3D = Matrix<dcomplex>(nsys_all, nx);
+  auto bcmplx3D = Matrix<dcomplex>(nsys_all, nx);
 
   if (dst) {
     BOUT_OMP(parallel) {
@@ -318,9 +418,10 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
       // Loop over X and Y indices, including boundaries but not guard cells.
       // (unless periodic in x)
       BOUT_OMP(for)
-      for (int ind = 0; ind < nxny; ++ind) {
-        // ind = (ix - xs)*(ye - ys + 1) + (iy - ys)
-        int ix = xs + ind / ny;
+      for (int ind = 0; ind < nrhs * nxny; ++ind) {
+        // ind = r * nxny + (ix - xs)*(ye - ys + 1) + (iy - ys)
+        int r = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
         int iy = ys + ind % ny;
 
         // Take DST in Z direction and put result in k1d
@@ -329,41 +430,44 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
             ((localmesh->LocalNx - ix - 1 < outbndry) && (outer_boundary_flags & INVERT_SET) &&
              localmesh->lastX())) {
           // Use the values in x0 in the boundary
-          DST(x0(ix, iy) + 1, localmesh->LocalNz - 2, std::begin(k1d));
+          DST(x0[r](ix, iy) + 1, localmesh->LocalNz - 2, std::begin(k1d));
         } else {
-          DST(rhs(ix, iy) + 1, localmesh->LocalNz - 2, std::begin(k1d));
+          DST(rhs[r](ix, iy) + 1, localmesh->LocalNz - 2, std::begin(k1d));
         }
 
         // Copy into array, transposing so kz is first index
         for (int kz = 0; kz < nmode; kz++) {
-          bcmplx3D((iy - ys) * nmode + kz, ix - xs) = k1d[kz];
+          bcmplx3D((r * ny + iy - ys) * nmode + kz, ix - xs) = k1d[kz];
         }
       }
 
       // Get elements of the tridiagonal matrix
       // including boundary conditions
-      BOUT_OMP(for nowait)
-      for (int ind = 0; ind < nsys; ind++) {
-        // ind = (iy - ys) * nmode + kz
-        int iy = ys + ind / nmode;
-        int kz = ind % nmode;
+      if (!reuse) {
+        BOUT_OMP(for nowait)
+        for (int ind = 0; ind < nsys; ind++) {
+          // ind = (iy - ys) * nmode + kz
+          int iy = ys + ind / nmode;
+          int kz = ind % nmode;
+
+          BoutReal zlen = coords->dz * (localmesh->LocalNz - 3);
+          BoutReal kwave =
+              kz * 2.0 * PI / (2. * zlen); // wave number is 1/[rad]; DST has extra 2.
+
+          tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
+                       kz,    // wave number index
+                       kwave, // kwave (inverse wave length)
+                       global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
+                       &C1coef, &C2coef, &Dcoef,
+                       false); // Don't include guard cells in arrays
 
-        BoutReal zlen = coords->dz * (localmesh->LocalNz - 3);
-        BoutReal kwave =
-            kz * 2.0 * PI / (2. * zlen); // wave number is 1/[rad]; DST has extra 2.
-
-        tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
-                     kz,    // wave number index
-                     kwave, // kwave (inverse wave length)
-                     global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
-                     &C1coef, &C2coef, &Dcoef,
-                     false); // Don't include guard cells in arrays
+        }
       }
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a3D, b3D, c3D);
-    cr->solve(bcmplx3D, xcmplx3D);
+    zeroBoundaryRHS(bcmplx3D);
+    solver3D(nrhs).solve(bcmplx3D, xcmplx3D);
 
     // FFT back to real space
     BOUT_OMP(parallel) {
@@ -372,22 +476,23 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
           Array<dcomplex>(localmesh->LocalNz); // ZFFT routine expects input of this length
 
       BOUT_OMP(for nowait)
-      for (int ind = 0; ind < nxny; ++ind) { // Loop over X and Y
-        // ind = (ix - xs)*(ye - ys + 1) + (iy - ys)
-        int ix = xs + ind / ny;
+      for (int ind = 0; ind < nrhs * nxny; ++ind) { // Loop over X and Y
+        // ind = r * nxny + (ix - xs)*(ye - ys + 1) + (iy - ys)
+        int r = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
         int iy = ys + ind % ny;
 
         for (int kz = 0; kz < nmode; kz++) {
-          k1d[kz] = xcmplx3D((iy - ys) * nmode + kz, ix - xs);
+          k1d[kz] = xcmplx3D((r * ny + iy - ys) * nmode + kz, ix - xs);
         }
 
         for (int kz = nmode; kz < localmesh->LocalNz; kz++)
           k1d[kz] = 0.0; // Filtering out all higher harmonics
 
-        DST_rev(std::begin(k1d), localmesh->LocalNz - 2, &x(ix, iy, 1));
+        DST_rev(std::begin(k1d), localmesh->LocalNz - 2, &x[r](ix, iy, 1));
 
-        x(ix, iy, 0) = -x(ix, iy, 2);
-        x(ix, iy, localmesh->LocalNz - 1) = -x(ix, iy, localmesh->LocalNz - 3);
+        x[r](ix, iy, 0) = -x[r](ix, iy, 2);
+        x[r](ix, iy, localmesh->LocalNz - 1) = -x[r](ix, iy, localmesh->LocalNz - 3);
       }
     }
   } else {
@@ -400,9 +505,10 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
       // (unless periodic in x)
 
       BOUT_OMP(for)
-      for (int ind = 0; ind < nxny; ++ind) {
-        // ind = (ix - xs)*(ye - ys + 1) + (iy - ys)
-        int ix = xs + ind / ny;
+      for (int ind = 0; ind < nrhs * nxny; ++ind) {
+        // ind = r * nxny + (ix - xs)*(ye - ys + 1) + (iy - ys)
+        int r = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
         int iy = ys + ind % ny;
 
         // Take FFT in Z direction, apply shift, and put result in k1d
@@ -411,37 +517,40 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
             ((localmesh->LocalNx - ix - 1 < outbndry) && (outer_boundary_flags & INVERT_SET) &&
              localmesh->lastX())) {
           // Use the values in x0 in the boundary
-          rfft(x0(ix, iy), localmesh->LocalNz, std::begin(k1d));
+          rfft(x0[r](ix, iy), localmesh->LocalNz, std::begin(k1d));
         } else {
-          rfft(rhs(ix, iy), localmesh->LocalNz, std::begin(k1d));
+          rfft(rhs[r](ix, iy), localmesh->LocalNz, std::begin(k1d));
         }
 
         // Copy into array, transposing so kz is first index
         for (int kz = 0; kz < nmode; kz++)
-          bcmplx3D((iy - ys) * nmode + kz, ix - xs) = k1d[kz];
+          bcmplx3D((r * ny + iy - ys) * nmode + kz, ix - xs) = k1d[kz];
       }
 
       // Get elements of the tridiagonal matrix
       // including boundary conditions
-      BOUT_OMP(for nowait)
-      for (int ind = 0; ind < nsys; ind++) {
-        // ind = (iy - ys) * nmode + kz
-        int iy = ys + ind / nmode;
-        int kz = ind % nmode;
+      if (!reuse) {
+        BOUT_OMP(for nowait)
+        for (int ind = 0; ind < nsys; ind++) {
+          // ind = (iy - ys) * nmode + kz
+          int iy = ys + ind / nmode;
+          int kz = ind % nmode;
+
+          BoutReal kwave = kz * 2.0 * PI / (coords->zlength()); // wave number is 1/[rad]
+          tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
+                       kz,    // True for the component constant (DC) in Z
+                       kwave, // Z wave number
+                       global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
+                       &C1coef, &C2coef, &Dcoef,
+                       false); // Don't include guard cells in arrays
 
-        BoutReal kwave = kz * 2.0 * PI / (coords->zlength()); // wave number is 1/[rad]
-        tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
-                     kz,    // True for the component constant (DC) in Z
-                     kwave, // Z wave number
-                     global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
-                     &C1coef, &C2coef, &Dcoef,
-                     false); // Don't include guard cells in arrays
+        }
       }
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a3D, b3D, c3D);
-    cr->solve(bcmplx3D, xcmplx3D);
+    zeroBoundaryRHS(bcmplx3D);
+    solver3D(nrhs).solve(bcmplx3D, xcmplx3D);
 
     // FFT back to real space
     BOUT_OMP(parallel) {
@@ -452,9 +561,10 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
       const bool zero_DC = global_flags & INVERT_ZERO_DC;
 
       BOUT_OMP(for nowait)
-      for (int ind = 0; ind < nxny; ++ind) { // Loop over X and Y
-        // ind = (ix - xs)*(ye - ys + 1) + (iy - ys)
-        int ix = xs + ind / ny;
+      for (int ind = 0; ind < nrhs * nxny; ++ind) { // Loop over X and Y
+        // ind = r * nxny + (ix - xs)*(ye - ys + 1) + (iy - ys)
+        int r = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
         int iy = ys + ind % ny;
 
         if (zero_DC) {
@@ -462,17 +572,29 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
         }
 
         for (int kz = zero_DC; kz < nmode; kz++)
-          k1d[kz] = xcmplx3D((iy - ys) * nmode + kz, ix - xs);
+          k1d[kz] = xcmplx3D((r * ny + iy - ys) * nmode + kz, ix - xs);
 
         for (int kz = nmode; kz < localmesh->LocalNz / 2 + 1; kz++)
           k1d[kz] = 0.0; // Filtering out all higher harmonics
 
-        irfft(std::begin(k1d), localmesh->LocalNz, x(ix, iy));
+        irfft(std::begin(k1d), localmesh->LocalNz, x[r](ix, iy));
       }
     }
   }
 
-  checkData(x);
+  if (cache_coefs && !reuse) {
+    coefs_cached = true;
+    cached_generation = coords->getGeneration();
+    cached_ys = ys;
+    cached_ye = ye;
+    cached_global_flags = global_flags;
+    cached_inner_flags = inner_boundary_flags;
+    cached_outer_flags = outer_boundary_flags;
+  }
+
+  for (const auto& result : x) {
+    checkData(result);
+  }
 
   return x;
 }
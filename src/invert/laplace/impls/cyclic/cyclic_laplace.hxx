@@ -38,6 +38,9 @@ class LaplaceCyclic;
 
 #include "utils.hxx"
 
+#include <map>
+#include <memory>
+
 /// Solves the 2D Laplacian equation using the CyclicReduce class
 /*!
  * 
@@ -48,34 +51,18 @@ public:
   ~LaplaceCyclic();
   
   using Laplacian::setCoefA;
-  void setCoefA(const Field2D &val) override {
-    ASSERT1(val.getLocation() == location);
-    ASSERT1(localmesh == val.getMesh());
-    Acoef = val;
-  }
+  void setCoefA(const Field2D &val) override { setCoef(Acoef, val); }
   using Laplacian::setCoefC;
   void setCoefC(const Field2D &val) override {
     setCoefC1(val);
     setCoefC2(val);
   }
   using Laplacian::setCoefC1;
-  void setCoefC1(const Field2D &val) override {
-    ASSERT1(val.getLocation() == location);
-    ASSERT1(localmesh == val.getMesh());
-    C1coef = val;
-  }
+  void setCoefC1(const Field2D &val) override { setCoef(C1coef, val); }
   using Laplacian::setCoefC2;
-  void setCoefC2(const Field2D &val) override {
-    ASSERT1(val.getLocation() == location);
-    ASSERT1(localmesh == val.getMesh());
-    C2coef = val;
-  }
+  void setCoefC2(const Field2D &val) override { setCoef(C2coef, val); }
   using Laplacian::setCoefD;
-  void setCoefD(const Field2D &val) override {
-    ASSERT1(val.getLocation() == location);
-    ASSERT1(localmesh == val.getMesh());
-    Dcoef = val;
-  }
+  void setCoefD(const Field2D &val) override { setCoef(Dcoef, val); }
   using Laplacian::setCoefEx;
   void setCoefEx(const Field2D &UNUSED(val)) override {
     throw BoutException("LaplaceCyclic does not have Ex coefficient");
@@ -91,8 +78,25 @@ public:
 
   Field3D solve(const Field3D &b) override {return solve(b,b);}
   Field3D solve(const Field3D &b, const Field3D &x0) override;
+
+  std::vector<Field3D> solve(const std::vector<Field3D> &b) override {
+    return solve(b, b);
+  }
+  std::vector<Field3D> solve(const std::vector<Field3D> &b,
+                             const std::vector<Field3D> &x0) override;
 private:
   Field2D Acoef, C1coef, C2coef, Dcoef;
+
+  /// Set one of the coefficients, invalidating the cached matrix
+  /// if the values have changed
+  void setCoef(Field2D &coef, const Field2D &val);
+
+  /// Zero the boundary elements of every system in bk, as tridagMatrix does
+  void zeroBoundaryRHS(Matrix<dcomplex> &bk) const;
+
+  /// Tridiagonal solver for \p nrhs right hand sides at once, factorised
+  /// with the matrix in a3D, b3D, c3D for each of them
+  CyclicReduce<dcomplex>& solver3D(int nrhs);
   
   int nmode;  // Number of modes being solved
   int xs, xe; // Start and end X indices
@@ -101,6 +105,19 @@ private:
   bool dst;
   
   CyclicReduce<dcomplex> *cr; ///< Tridiagonal solver
+
+  /// Matrix for the Field3D solves, for one right hand side
+  Matrix<dcomplex> a3D, b3D, c3D;
+  /// Tridiagonal solvers for Field3D, by number of right hand sides.
+  /// Each keeps its factorisation until the matrix changes
+  std::map<int, std::unique_ptr<CyclicReduce<dcomplex>>> cr3d;
+
+  bool cache_coefs;         ///< Reuse the matrix between Field3D solves?
+  bool coefs_cached{false}; ///< Are a3D, b3D, c3D and cr3d valid?
+  /// Flags, Y range and metric (Coordinates::getGeneration) the cached
+  /// matrix was calculated with
+  int cached_global_flags, cached_inner_flags, cached_outer_flags;
+  int cached_ys, cached_ye, cached_generation;
 };
 
 #endif // __SPT_H__
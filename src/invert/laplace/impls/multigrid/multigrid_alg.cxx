@@ -31,6 +31,8 @@
 #include <bout/openmpwrap.hxx>
 #include "unused.hxx"
 
+#include <algorithm>
+
 // Define basic multigrid algorithm
 
 MultigridAlg::MultigridAlg(int level, int lx, int lz, int gx, int gz, MPI_Comm comm,
@@ -63,12 +65,29 @@ MultigridAlg::MultigridAlg(int level, int lx, int lz, int gx, int gz, MPI_Comm c
   for(int i = 0;i<mglevel;i++) {
     matmg[i] = new BoutReal[(lnx[i]+2)*(lnz[i]+2)*9];
   }
+
+  // Coefficients split by stencil direction, filled by packMatrix
+  matsoa.resize(mglevel);
+  rdiag.resize(mglevel);
+  for(int i = 0;i<mglevel;i++) {
+    matsoa[i].reallocate(9, (lnx[i]+2)*(lnz[i]+2));
+    rdiag[i].reallocate((lnx[i]+2)*(lnz[i]+2));
+  }
 }
 
 MultigridAlg::~MultigridAlg() {
   output<<"End deconstruction Malg AAAA "<<numP<<endl;
   for(int i = 0;i<mglevel;i++) delete [] matmg[i];
   delete [] matmg;
+
+  int finalised;
+  MPI_Finalized(&finalised);
+  if(!finalised) {
+    for(auto &plan : commplan) {
+      for(auto &req : plan.zrequest) MPI_Request_free(&req);
+      for(auto &req : plan.xrequest) MPI_Request_free(&req);
+    }
+  }
 }
 
 void MultigridAlg::getSolution(BoutReal *x,BoutReal *b,int flag) {
@@ -199,59 +218,64 @@ void MultigridAlg::smoothings(int level, BoutReal *x, BoutReal *b) {
   int dim;
   int mm = lnz[level]+2;
   dim = mm*(lnx[level]+2);
+  int xend = lnx[level]+1;
+  int zend = lnz[level]+1;
+
+  const BoutReal *a0 = &matsoa[level](0, 0);
+  const BoutReal *a1 = &matsoa[level](1, 0);
+  const BoutReal *a2 = &matsoa[level](2, 0);
+  const BoutReal *a3 = &matsoa[level](3, 0);
+  const BoutReal *a5 = &matsoa[level](5, 0);
+  const BoutReal *a6 = &matsoa[level](6, 0);
+  const BoutReal *a7 = &matsoa[level](7, 0);
+  const BoutReal *a8 = &matsoa[level](8, 0);
+  const BoutReal *rd = std::begin(rdiag[level]);
+
   if(mgsm == 0) {
+    // Damped Jacobi
     Array<BoutReal> x0(dim);
+    const BoutReal *y = std::begin(x0);
 BOUT_OMP(parallel default(shared))
     for(int num =0;num < 2;num++) {
 BOUT_OMP(for)
       for(int i = 0;i<dim;i++) x0[i] = x[i];    
 
-      int xend = lnx[level]+1;
-      int zend = lnz[level]+1;
-BOUT_OMP(for collapse(2))
-      for(int i=1;i<xend;i++)
+BOUT_OMP(for)
+      for(int i=1;i<xend;i++) {
         for(int k=1;k<zend;k++) {
           int nn = i*mm+k;
-          BoutReal val = b[nn] - matmg[level][nn*9+3]*x0[nn-1]
-	   - matmg[level][nn*9+5]*x0[nn+1] - matmg[level][nn*9+1]*x0[nn-mm]
-           - matmg[level][nn*9+7]*x0[nn+mm] - matmg[level][nn*9]*x0[nn-mm-1]
-           - matmg[level][nn*9+2]*x0[nn-mm+1] - matmg[level][nn*9+6]*x0[nn+mm-1]
-           - matmg[level][nn*9+8]*x0[nn+mm+1];
-          if(fabs(matmg[level][nn*9+4]) <atol)
-            throw BoutException("Error at matmg(%d-%d)",level,nn);
-
-          x[nn] = (1.0-omega)*x[nn] + omega*val/matmg[level][nn*9+4];
-        } 
+          BoutReal val = b[nn] - a3[nn]*y[nn-1] - a5[nn]*y[nn+1]
+            - a1[nn]*y[nn-mm] - a7[nn]*y[nn+mm] - a0[nn]*y[nn-mm-1]
+            - a2[nn]*y[nn-mm+1] - a6[nn]*y[nn+mm-1] - a8[nn]*y[nn+mm+1];
+          x[nn] = (1.0-omega)*x[nn] + omega*val*rd[nn];
+        }
+      }
+BOUT_OMP(single)
       communications(x,level);
     }
   }
   else {
-    for(int i = 1;i<lnx[level]+1;i++)
-      for(int k=1;k<lnz[level]+1;k++) {
-        int nn = i*mm+k;
-        BoutReal val = b[nn] - matmg[level][nn*9+3]*x[nn-1]
-	    - matmg[level][nn*9+5]*x[nn+1] - matmg[level][nn*9+1]*x[nn-mm]
-            - matmg[level][nn*9+7]*x[nn+mm] - matmg[level][nn*9]*x[nn-mm-1]
-            - matmg[level][nn*9+2]*x[nn-mm+1] - matmg[level][nn*9+6]*x[nn+mm-1]
-            - matmg[level][nn*9+8]*x[nn+mm+1];
-          if(fabs(matmg[level][nn*9+4]) <atol)
-            throw BoutException("Error at matmg(%d-%d)",level,nn);
-        x[nn] = val/matmg[level][nn*9+4];
-      } 
-    communications(x,level);
-    for(int i = lnx[level];i>0;i--)
-      for(int k= lnz[level];k>0;k--) {
-        int nn = i*mm+k;
-        BoutReal val = b[nn] - matmg[level][nn*9+3]*x[nn-1]
-	    - matmg[level][nn*9+5]*x[nn+1] - matmg[level][nn*9+1]*x[nn-mm]
-            - matmg[level][nn*9+7]*x[nn+mm] - matmg[level][nn*9]*x[nn-mm-1]
-            - matmg[level][nn*9+2]*x[nn-mm+1] - matmg[level][nn*9+6]*x[nn+mm-1]
-            - matmg[level][nn*9+8]*x[nn+mm+1];
-          if(fabs(matmg[level][nn*9+4]) <atol)
-            throw BoutException("Error at matmg(%d-%d)",level,nn);
-        x[nn] = val/matmg[level][nn*9+4];
-      } 
-    communications(x,level);
+    // Symmetric Gauss-Seidel with four colours, given by the parity of
+    // (i, k). None of the 9 stencil neighbours of a point share its
+    // colour, so all points of one colour can be updated in parallel.
+    // As before, guard cells are only exchanged after each sweep.
+    const int order[8][2] = {{1,1},{1,2},{2,1},{2,2},{2,2},{2,1},{1,2},{1,1}};
+    for(int sweep = 0;sweep < 2;sweep++) {
+BOUT_OMP(parallel default(shared))
+      for(int c = 4*sweep;c < 4*sweep+4;c++) {
+BOUT_OMP(for)
+        for(int i=order[c][0];i<xend;i+=2) {
+          for(int k=order[c][1];k<zend;k+=2) {
+            int nn = i*mm+k;
+            BoutReal val = b[nn] - a3[nn]*x[nn-1] - a5[nn]*x[nn+1]
+              - a1[nn]*x[nn-mm] - a7[nn]*x[nn+mm] - a0[nn]*x[nn-mm-1]
+              - a2[nn]*x[nn-mm+1] - a6[nn]*x[nn+mm-1] - a8[nn]*x[nn+mm+1];
+            x[nn] = val*rd[nn];
+          }
+        }
+      }
+      communications(x,level);
+    }
   }
 }
 
@@ -458,6 +482,7 @@ BOUT_OMP(for)
 void MultigridAlg::setMultigridC(int UNUSED(plag)) {
 
   int level = mglevel - 1;
+  packMatrix(level);
   for(int n = level;n>0;n--) {
     setMatrixC(n);
     if(pcheck == 2) {
@@ -498,6 +523,8 @@ BOUT_OMP(for reduction(+:ini_e) collapse(2))
 void MultigridAlg::multiAVec(int level, BoutReal *x, BoutReal *b) {
 
   int mm = lnz[level]+2;
+  const BoutReal *a[9];
+  for(int k = 0;k<9;k++) a[k] = &matsoa[level](k, 0);
 BOUT_OMP(parallel default(shared))
   {
 BOUT_OMP(for)
@@ -509,11 +536,9 @@ BOUT_OMP(for collapse(2))
     for(int i=1;i<xend;i++) {
       for(int k=1;k<zend;k++) {
         int nn = i*mm+k;
-        b[nn] = matmg[level][nn*9+4]*x[nn] + matmg[level][nn*9+3]*x[nn-1]
-          +matmg[level][nn*9+5]*x[nn+1] + matmg[level][nn*9+1]*x[nn-mm]
-          +matmg[level][nn*9+7]*x[nn+mm] +matmg[level][nn*9]*x[nn-mm-1]
-          +matmg[level][nn*9+2]*x[nn-mm+1] + matmg[level][nn*9+6]*x[nn+mm-1]
-          +matmg[level][nn*9+8]*x[nn+mm+1];
+        b[nn] = a[4][nn]*x[nn] + a[3][nn]*x[nn-1] + a[5][nn]*x[nn+1]
+          + a[1][nn]*x[nn-mm] + a[7][nn]*x[nn+mm] + a[0][nn]*x[nn-mm-1]
+          + a[2][nn]*x[nn-mm+1] + a[6][nn]*x[nn+mm-1] + a[8][nn]*x[nn+mm+1];
       } 
     }
   }
@@ -523,8 +548,9 @@ BOUT_OMP(for collapse(2))
 void MultigridAlg::residualVec(int level, BoutReal *x, BoutReal *b,
 BoutReal *r) {
 
-  int mm;
-  mm = lnz[level]+2;
+  int mm = lnz[level]+2;
+  const BoutReal *a[9];
+  for(int k = 0;k<9;k++) a[k] = &matsoa[level](k, 0);
 BOUT_OMP(parallel default(shared))
   {
 BOUT_OMP(for)
@@ -536,11 +562,9 @@ BOUT_OMP(for collapse(2))
     for(int i=1;i<xend;i++) {
       for(int k=1;k<zend;k++) {
         int nn = i*mm+k;
-        BoutReal val = matmg[level][nn*9+4]*x[nn] + matmg[level][nn*9+3]*x[nn-1]
-          +matmg[level][nn*9+5]*x[nn+1] + matmg[level][nn*9+1]*x[nn-mm]
-          +matmg[level][nn*9+7]*x[nn+mm] +matmg[level][nn*9]*x[nn-mm-1]
-          +matmg[level][nn*9+2]*x[nn-mm+1] + matmg[level][nn*9+6]*x[nn+mm-1]
-          +matmg[level][nn*9+8]*x[nn+mm+1];
+        BoutReal val = a[4][nn]*x[nn] + a[3][nn]*x[nn-1] + a[5][nn]*x[nn+1]
+          + a[1][nn]*x[nn-mm] + a[7][nn]*x[nn+mm] + a[0][nn]*x[nn-mm-1]
+          + a[2][nn]*x[nn-mm+1] + a[6][nn]*x[nn+mm-1] + a[8][nn]*x[nn+mm+1];
         r[nn] = b[nn]-val;
       } 
     }
@@ -600,105 +624,171 @@ BOUT_OMP(for collapse(2))
     }
   }
 
+  packMatrix(level-1);
 }
 
-void MultigridAlg::communications(BoutReal* x, int level) {
-  // Note: currently z-direction communications and x-direction communications are done
-  // independently. They should really be done together if zNP>1 and xNP>1 (with a single
-  // MPI_Waitall after all the MPI_Isend and MPI_Irecv calls, instead of the two
-  // MPI_Waitalls there are now. As there are never any z-communications at the moment, it
-  // is not worth implementing for now.
-
-  MPI_Status status[4];
-  int stag, rtag;
-  MAYBE_UNUSED(int ierr);
-
-  if(zNP > 1) {
-    MPI_Request requests[] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
-    MPI_Datatype xvector;
-
-    // Create datatype to hold z-direction guard cells, which are not continuous in memory
-    ierr = MPI_Type_vector(lnx[level], 1, lnz[level]+2, MPI_DOUBLE, &xvector);
-    ASSERT1(ierr == MPI_SUCCESS);
-    
-    ierr = MPI_Type_commit(&xvector);
-    ASSERT1(ierr == MPI_SUCCESS);
-    
-    // Receive from z-
-    rtag = zProcM;
-    ierr = MPI_Irecv(&x[lnz[level]+2], 1, xvector, zProcM, rtag, commMG, &requests[2]);
-    ASSERT1(ierr == MPI_SUCCESS);
+void MultigridAlg::packMatrix(int level) {
+  // Copy matmg into the structure-of-arrays layout used by the smoothers
+  // and check the diagonal once here, rather than in every smoothing step
 
-    // Receive from z+
-    rtag = zProcP+numP;
-    ierr = MPI_Irecv(&x[2*(lnz[level]+2)-1], 1, xvector, zProcP, rtag, commMG,
-        &requests[3]);
-    ASSERT1(ierr == MPI_SUCCESS);
+  int dim = (lnx[level]+2)*(lnz[level]+2);
+  int mm = lnz[level]+2;
+  int xend = lnx[level]+1;
+  int zend = lnz[level]+1;
+  const BoutReal *mat = matmg[level];
+  BoutReal *rd = std::begin(rdiag[level]);
+  int bad = dim;
 
-    // Send to z+
-    stag = rProcI;
-    ierr = MPI_Isend(&x[2*(lnz[level]+2)-2], 1, xvector, zProcP, stag, commMG,
-        &requests[0]);
-    ASSERT1(ierr == MPI_SUCCESS);
+BOUT_OMP(parallel default(shared))
+  {
+    for(int k = 0;k<9;k++) {
+      BoutReal *ak = &matsoa[level](k, 0);
+BOUT_OMP(for nowait)
+      for(int nn = 0;nn<dim;nn++) ak[nn] = mat[nn*9+k];
+    }
 
-    // Send to z-
-    stag = rProcI+numP;
-    ierr = MPI_Isend(&x[lnz[level]+3], 1, xvector, zProcM, stag, commMG, &requests[1]);
-    ASSERT1(ierr == MPI_SUCCESS);
+BOUT_OMP(for)
+    for(int nn = 0;nn<dim;nn++) rd[nn] = 0.0;
 
-    // Wait for communications to complete
-    ierr = MPI_Waitall(4, requests, status);
-    ASSERT1(ierr == MPI_SUCCESS);
-    
-    ierr = MPI_Type_free(&xvector);
-    ASSERT1(ierr == MPI_SUCCESS);
-  } else {
-    for (int i=1;i<lnx[level]+1;i++) {
-      x[i*(lnz[level]+2)] = x[(i+1)*(lnz[level]+2)-2];
-      x[(i+1)*(lnz[level]+2)-1] = x[i*(lnz[level]+2)+1];
+BOUT_OMP(for reduction(min:bad))
+    for(int i=1;i<xend;i++) {
+      for(int k=1;k<zend;k++) {
+        int nn = i*mm+k;
+        if(fabs(mat[nn*9+4]) < atol) {
+          bad = std::min(bad, nn);
+        } else {
+          rd[nn] = 1.0/mat[nn*9+4];
+        }
+      }
     }
   }
-  if (xNP > 1) {
-    // Note: periodic x-direction not handled here
 
-    MPI_Request requests[] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  if(bad < dim)
+    throw BoutException("Error at matmg(%d-%d)",level,bad);
+}
+
+void MultigridAlg::setupCommunications() {
+  // Called by the derived constructors, once the neighbouring processors
+  // are known. Creates the buffers and persistent requests for every level.
+  // Buffers hold, in order, the guard cells received from the - and +
+  // neighbours, then the cells sent to the + and - neighbours
+
+  MAYBE_UNUSED(int ierr);
+
+  commplan.resize(mglevel);
+  for(int level = 0;level<mglevel;level++) {
+    CommPlan &plan = commplan[level];
+
+    if(zNP > 1) {
+      int len = lnx[level];
+      plan.zbuff.reallocate(4*len);
+      plan.zrequest.resize(4);
+      BoutReal *buff = std::begin(plan.zbuff);
 
-    if (xProcI > 0) {
-      // Receive from x-
-      rtag = xProcM;
-      ierr = MPI_Irecv(&x[0], lnz[level]+2, MPI_DOUBLE, xProcM, rtag, commMG, &requests[2]);
+      // Receive from z-
+      ierr = MPI_Recv_init(buff, len, MPI_DOUBLE, zProcM, zProcM, commMG,
+          &plan.zrequest[0]);
       ASSERT1(ierr == MPI_SUCCESS);
-    }
-    
-    if (xProcI < xNP - 1) {
-      // Receive from x+
-      rtag = xProcP+xNP;;
-      ierr = MPI_Irecv(&x[(lnx[level]+1)*(lnz[level]+2)], lnz[level]+2, MPI_DOUBLE, xProcP,
-          rtag, commMG, &requests[3]);
+      // Receive from z+
+      ierr = MPI_Recv_init(buff+len, len, MPI_DOUBLE, zProcP, zProcP+numP, commMG,
+          &plan.zrequest[1]);
       ASSERT1(ierr == MPI_SUCCESS);
-
-      // Send to x+
-      stag = rProcI;
-      ierr = MPI_Isend(&x[lnx[level]*(lnz[level]+2)], lnz[level]+2, MPI_DOUBLE, xProcP,
-          stag, commMG, &requests[0]);
+      // Send to z+
+      ierr = MPI_Send_init(buff+2*len, len, MPI_DOUBLE, zProcP, rProcI, commMG,
+          &plan.zrequest[2]);
+      ASSERT1(ierr == MPI_SUCCESS);
+      // Send to z-
+      ierr = MPI_Send_init(buff+3*len, len, MPI_DOUBLE, zProcM, rProcI+numP, commMG,
+          &plan.zrequest[3]);
       ASSERT1(ierr == MPI_SUCCESS);
     }
 
-    if (xProcI > 0) {
-      // Send to x-
-      stag = rProcI+xNP;
-      ierr = MPI_Isend(&x[lnz[level]+2], lnz[level]+2, MPI_DOUBLE, xProcM, stag, commMG,
-          &requests[1]);
-      ASSERT1(ierr == MPI_SUCCESS);
+    if(xNP > 1) {
+      // Note: periodic x-direction not handled here
+      int len = lnz[level]+2;
+      plan.xbuff.reallocate(4*len);
+      BoutReal *buff = std::begin(plan.xbuff);
+      MPI_Request req;
+
+      if(xProcI > 0) {
+        // Receive from x-
+        ierr = MPI_Recv_init(buff, len, MPI_DOUBLE, xProcM, xProcM, commMG, &req);
+        ASSERT1(ierr == MPI_SUCCESS);
+        plan.xrequest.push_back(req);
+      }
+      if(xProcI < xNP - 1) {
+        // Receive from x+
+        ierr = MPI_Recv_init(buff+len, len, MPI_DOUBLE, xProcP, xProcP+xNP, commMG, &req);
+        ASSERT1(ierr == MPI_SUCCESS);
+        plan.xrequest.push_back(req);
+        // Send to x+
+        ierr = MPI_Send_init(buff+2*len, len, MPI_DOUBLE, xProcP, rProcI, commMG, &req);
+        ASSERT1(ierr == MPI_SUCCESS);
+        plan.xrequest.push_back(req);
+      }
+      if(xProcI > 0) {
+        // Send to x-
+        ierr = MPI_Send_init(buff+3*len, len, MPI_DOUBLE, xProcM, rProcI+xNP, commMG,
+            &req);
+        ASSERT1(ierr == MPI_SUCCESS);
+        plan.xrequest.push_back(req);
+      }
+    }
+  }
+}
+
+void MultigridAlg::communications(BoutReal* x, int level) {
+  // Note: the z-direction guard cells must arrive before the x-direction
+  // exchange starts, as the x-direction guard rows include the corners.
+  // As there are never any z-communications at the moment, it is not worth
+  // combining the two phases with a diagonal exchange.
+
+  MAYBE_UNUSED(int ierr);
+  CommPlan &plan = commplan[level];
+  int mm = lnz[level]+2;
+
+  if(zNP > 1) {
+    int len = lnx[level];
+    BoutReal *buff = std::begin(plan.zbuff);
+    for (int i=0;i<len;i++) {
+      buff[2*len+i] = x[(i+1)*mm+mm-2];
+      buff[3*len+i] = x[(i+1)*mm+1];
     }
 
-    // Wait for communications to complete
-    ierr = MPI_Waitall(4, requests, status);
+    ierr = MPI_Startall(4, plan.zrequest.data());
+    ASSERT1(ierr == MPI_SUCCESS);
+    ierr = MPI_Waitall(4, plan.zrequest.data(), MPI_STATUSES_IGNORE);
+    ASSERT1(ierr == MPI_SUCCESS);
+
+    for (int i=0;i<len;i++) {
+      x[(i+1)*mm] = buff[i];
+      x[(i+1)*mm+mm-1] = buff[len+i];
+    }
+  } else {
+    for (int i=1;i<lnx[level]+1;i++) {
+      x[i*mm] = x[(i+1)*mm-2];
+      x[(i+1)*mm-1] = x[i*mm+1];
+    }
+  }
+  if (xNP > 1) {
+    BoutReal *buff = std::begin(plan.xbuff);
+    BoutReal *first = &x[mm];
+    BoutReal *last = &x[lnx[level]*mm];
+    std::copy(last, last+mm, buff+2*mm);
+    std::copy(first, first+mm, buff+3*mm);
+
+    int nreq = plan.xrequest.size();
+    ierr = MPI_Startall(nreq, plan.xrequest.data());
     ASSERT1(ierr == MPI_SUCCESS);
+    ierr = MPI_Waitall(nreq, plan.xrequest.data(), MPI_STATUSES_IGNORE);
+    ASSERT1(ierr == MPI_SUCCESS);
+
+    if (xProcI > 0) std::copy(buff, buff+mm, x);
+    if (xProcI < xNP - 1) std::copy(buff+mm, buff+2*mm, &x[(lnx[level]+1)*mm]);
   } else {
-    for (int i=0;i<lnz[level]+2;i++) {
-      x[i] = x[lnx[level]*(lnz[level]+2)+i];
-      x[(lnx[level]+1)*(lnz[level]+2)+i] = x[(lnz[level]+2)+i];
+    for (int i=0;i<mm;i++) {
+      x[i] = x[lnx[level]*mm+i];
+      x[(lnx[level]+1)*mm+i] = x[mm+i];
     }
   }
 }
@@ -385,7 +385,7 @@ BOUT_OMP(for)
     fclose(outf);
   }
 
-  if (level > 0) kMG->setMultigridC(0);
+  kMG->setMultigridC(0);
 
   if((pcheck == 3) && (mgcount == 0)) {
     for(int i = level; i> 0;i--) {
@@ -33,6 +33,8 @@
 
 #include <mpi.h>
 
+#include <vector>
+
 #include <globals.hxx>
 #include <output.hxx>
 #include <options.hxx>
@@ -56,6 +58,10 @@ public:
   BoutReal rtol,atol,dtol,omega;
   Array<int> gnx, gnz, lnx, lnz;
   BoutReal **matmg;
+  // Same coefficients as matmg, split by stencil direction, and the
+  // inverse of the diagonal. Filled from matmg by packMatrix
+  std::vector<Matrix<BoutReal>> matsoa;
+  std::vector<Array<BoutReal>> rdiag;
 
 protected:
   /******* Start implementation ********/
@@ -63,8 +69,19 @@ protected:
 
   MPI_Comm commMG;
 
+  /// Guard cell exchange for one level. Guard cells are packed into
+  /// contiguous buffers and sent with persistent requests, all set up
+  /// once by setupCommunications
+  struct CommPlan {
+    Array<BoutReal> zbuff, xbuff;
+    std::vector<MPI_Request> zrequest, xrequest;
+  };
+  std::vector<CommPlan> commplan;
+
+  void setupCommunications();
   void communications(BoutReal *, int );
   void setMatrixC(int );
+  void packMatrix(int );
 
   void cycleMG(int ,BoutReal *, BoutReal *);
   void smoothings(int , BoutReal *, BoutReal *);
@@ -58,6 +58,7 @@ Multigrid1DP::Multigrid1DP(int level,int lx, int lz, int gx, int dl, int merge,
   zProcI = xProcI;
   zProcP = xProcI;
   zProcM = xProcI;  
+  setupCommunications();
 
   if(pcheck == 1) {
     output <<"In MG1DP level "<<mglevel<<" xNP="<<xNP<<"("<<xProcI<<")"<<endl;
@@ -153,6 +154,7 @@ Multigrid1DP::Multigrid1DP(int level,int lx, int lz, int gx, int dl, int merge,
 void Multigrid1DP::setMultigridC(int UNUSED(plag)) {
 
   int level = mglevel - 1;
+  packMatrix(level);
   for(int n = level;n>0;n--) {
     if(pcheck == 2) {
       output<<n<<"matrix in 1DP = "<<lnx[n-1]<<","<<lnz[n-1]<<endl;
@@ -165,7 +167,7 @@ void Multigrid1DP::setMultigridC(int UNUSED(plag)) {
     level = rMG->mglevel-1;
     convertMatrixF2D(level);
 
-    if(level > 0) rMG->setMultigridC(0);      
+    rMG->setMultigridC(0);
 
     if(pcheck == 2) {
       for(int i = level; i >= 0;i--) {      
@@ -190,7 +192,7 @@ void Multigrid1DP::setMultigridC(int UNUSED(plag)) {
     level = sMG->mglevel-1;
     convertMatrixFS(level);
 
-    if(level > 0) sMG->setMultigridC(0);      
+    sMG->setMultigridC(0);
     if(pcheck == 3) {
       for(int i = level; i >= 0;i--) {      
         FILE *outf;
@@ -526,6 +528,7 @@ Multigrid2DPf1D::Multigrid2DPf1D(int level,int lx,int lz, int gx, int gz,
   else zProcM = rProcI-1;
   if(zProcI ==zNP-1) zProcP = xProcI*zNP;
   else zProcP = rProcI + 1;
+  setupCommunications();
   if(pcheck == 2) {
     output<<"In 2DP "<<mglevel<<"xNP="<<xNP<<"("<<zNP<<")"<<dl << endl;
     for(int i = mglevel-1;i>=0;i--) {
@@ -559,6 +562,7 @@ Multigrid2DPf1D::Multigrid2DPf1D(int level,int lx,int lz, int gx, int gz,
 void Multigrid2DPf1D::setMultigridC(int UNUSED(plag)) {
 
   int level = mglevel - 1;
+  packMatrix(level);
   for(int n = level;n>0;n--) {
     setMatrixC(n);
     if(pcheck == 2) {
@@ -569,7 +573,7 @@ void Multigrid2DPf1D::setMultigridC(int UNUSED(plag)) {
   if(kflag == 2) {
     level = sMG->mglevel-1;
     convertMatrixFS(level);
-    if(level > 0) sMG->setMultigridC(0);      
+    sMG->setMultigridC(0);
     if(pcheck == 2) {
       for(int i = level; i >= 0;i--) {      
         FILE *outf;
@@ -708,6 +712,7 @@ MultigridSerial::MultigridSerial(int level, int gx, int gz, MPI_Comm comm, int c
   xProcP = rProcI;
   zProcM = rProcI;
   zProcP = rProcI;
+  setupCommunications();
   if(pcheck == 2) {
     output<<"In SerMG "<<mglevel<<"xNP="<<xNP<<"("<<zNP<<")"<< endl;
     for(int i = mglevel-1;i>=0;i--) {
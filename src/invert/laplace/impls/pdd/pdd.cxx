@@ -44,11 +44,7 @@ FieldPerp LaplacePDD::solve(const FieldPerp& b) {
 
   PDD_data data;
 
-  FieldPerp x{emptyFrom(b)};
-  
-  start(b, data);
-  next(data);
-  finish(data, x);
+  FieldPerp x = solveSlices({b}, data).front();
 
   checkData(x);
   
@@ -59,9 +55,12 @@ Field3D LaplacePDD::solve(const Field3D& b) {
   ASSERT1(localmesh == b.getMesh());
   ASSERT1(b.getLocation() == location);
 
+  if (!low_mem) {
+    // Overlap the inversions of all slices
+    return solve(std::vector<Field3D>{b}).front();
+  }
+
   Field3D x{emptyFrom(b)};
-  FieldPerp xperp(localmesh);
-  xperp.allocate();
   
   int ys = localmesh->ystart, ye = localmesh->yend;
   if(localmesh->hasBndryLowerY())
@@ -69,37 +68,69 @@ Field3D LaplacePDD::solve(const Field3D& b) {
   if(localmesh->hasBndryUpperY())
     ye = localmesh->LocalNy-1; // Contains upper boundary
   
-  if(low_mem) {
+  // Solve one slice at a time
+  for(int jy=ys; jy <= ye; jy++) {
+    x = solve(sliceXZ(b, jy));
+  }
+
+  x.setLocation(b.getLocation()); 
+
+  checkData(x);
+
+  return x;
+}
+
+std::vector<Field3D> LaplacePDD::solve(const std::vector<Field3D>& b) {
+  if (low_mem) {
     // Solve one slice at a time
-    for(int jy=ys; jy <= ye; jy++) {
-      x = solve(sliceXZ(b, jy));
-    }
-  }else {
-    // Overlap multiple inversions
+    return Laplacian::solve(b);
+  }
 
-    static PDD_data *data = nullptr;
+  int ys = localmesh->ystart, ye = localmesh->yend;
+  if(localmesh->hasBndryLowerY())
+    ys = 0; // Mesh contains a lower boundary
+  if(localmesh->hasBndryUpperY())
+    ye = localmesh->LocalNy-1; // Contains upper boundary
 
-    if (data == nullptr) {
-      data = new PDD_data[ye - ys + 1];
-      data -= ys; // Re-number indices to start at jstart
+  // Slices of all the right hand sides, which are solved together
+  std::vector<FieldPerp> bslices;
+  bslices.reserve(b.size() * (ye - ys + 1));
+  for (const auto& rhs : b) {
+    ASSERT1(localmesh == rhs.getMesh());
+    ASSERT1(rhs.getLocation() == location);
+    for (int jy = ys; jy <= ye; jy++) {
+      bslices.push_back(sliceXZ(rhs, jy));
     }
-    /// PDD algorithm communicates twice, so done in 3 stages
-      
-    for(int jy=ys; jy <= ye; jy++)
-      start(sliceXZ(b,jy), data[jy]);
-    
-    for(int jy=ys; jy <= ye; jy++)
-      next(data[jy]);
-    
-    for(int jy=ys; jy <= ye; jy++) {
-      finish(data[jy], xperp);
-      x = xperp;
+  }
+
+  auto xslices = solveSlices(bslices, data3d);
+
+  std::vector<Field3D> x;
+  x.reserve(b.size());
+  auto xslice = std::begin(xslices);
+  for (const auto& rhs : b) {
+    x.push_back(emptyFrom(rhs));
+    for (int jy = ys; jy <= ye; jy++) {
+      x.back() = *xslice++;
     }
+    checkData(x.back());
   }
+  return x;
+}
 
-  x.setLocation(b.getLocation()); 
+/// PDD algorithm communicates twice, so done in 3 stages. All the
+/// slices in \p b are sent together in each stage
+std::vector<FieldPerp> LaplacePDD::solveSlices(const std::vector<FieldPerp>& b,
+                                               PDD_data& data) {
+  std::vector<FieldPerp> x;
+  x.reserve(b.size());
+  for (const auto& slice : b) {
+    x.push_back(emptyFrom(slice));
+  }
 
-  checkData(x);
+  start(b, data);
+  next(data);
+  finish(data, x);
 
   return x;
 }
@@ -114,17 +145,22 @@ Field3D LaplacePDD::solve(const Field3D& b) {
 /// balanced against communication time i.e. faster communications can
 /// allow less memory use.
 ///
-/// @param[in]    b  RHS values (Ax = b)
+/// @param[in]    b  RHS values (Ax = b), one for each slice
 /// @param[in] data  Internal data used for multiple calls in parallel mode
-void LaplacePDD::start(const FieldPerp &b, PDD_data &data) {
-  ASSERT1(localmesh == b.getMesh());
-  ASSERT1(b.getLocation() == location);
-
-  int ix, kz;
+void LaplacePDD::start(const std::vector<FieldPerp> &b, PDD_data &data) {
+  int ix;
 
   int ncz = localmesh->LocalNz;
 
-  data.jy = b.getIndex();
+  const int nmode = maxmode + 1;
+  const int nsys = b.size() * nmode; // Number of systems, for all slices
+
+  data.jy.resize(b.size());
+  for (std::size_t i = 0; i < b.size(); i++) {
+    ASSERT1(localmesh == b[i].getMesh());
+    ASSERT1(b[i].getLocation() == location);
+    data.jy[i] = b[i].getIndex();
+  }
 
   if(localmesh->firstX() && localmesh->lastX())
     throw BoutException("Error: PDD method only works for NXPE > 1\n");
@@ -133,38 +169,40 @@ void LaplacePDD::start(const FieldPerp &b, PDD_data &data) {
       throw BoutException("LaplacePDD does not work with periodicity in the x direction (localmesh->PeriodicX == true). Change boundary conditions or use serial-tri or cyclic solver instead");
     }
 
-    if (data.bk.empty()) {
+    if (data.bk.empty() || std::get<0>(data.bk.shape()) != nsys) {
       // Need to allocate working memory
 
       // RHS vector
-      data.bk.reallocate(maxmode + 1, localmesh->LocalNx);
+      data.bk.reallocate(nsys, localmesh->LocalNx);
 
       // Matrix to be solved
-      data.avec.reallocate(maxmode + 1, localmesh->LocalNx);
-      data.bvec.reallocate(maxmode + 1, localmesh->LocalNx);
-      data.cvec.reallocate(maxmode + 1, localmesh->LocalNx);
+      data.avec.reallocate(nsys, localmesh->LocalNx);
+      data.bvec.reallocate(nsys, localmesh->LocalNx);
+      data.cvec.reallocate(nsys, localmesh->LocalNx);
 
       // Working vectors
-      data.v.reallocate(maxmode + 1, localmesh->LocalNx);
-      data.w.reallocate(maxmode + 1, localmesh->LocalNx);
+      data.v.reallocate(nsys, localmesh->LocalNx);
+      data.w.reallocate(nsys, localmesh->LocalNx);
 
       // Result
-      data.xk.reallocate(maxmode + 1, localmesh->LocalNx);
+      data.xk.reallocate(nsys, localmesh->LocalNx);
 
-      // Communication buffers. Space for 2 complex values for each kz
-      data.snd.reallocate(4 * (maxmode + 1));
-      data.rcv.reallocate(4 * (maxmode + 1));
+      // Communication buffers. Space for 2 complex values for each system
+      data.snd.reallocate(4 * nsys);
+      data.rcv.reallocate(4 * nsys);
 
-      data.y2i.reallocate(maxmode + 1);
+      data.y2i.reallocate(nsys);
   }
 
   /// Take FFTs of data
   Array<dcomplex> bk1d(ncz / 2 + 1); ///< 1D in Z for taking FFTs
 
-  for(ix=0; ix < localmesh->LocalNx; ix++) {
-    rfft(b[ix], ncz, std::begin(bk1d));
-    for(kz = 0; kz <= maxmode; kz++)
-      data.bk(kz, ix) = bk1d[kz];
+  for (std::size_t i = 0; i < b.size(); i++) {
+    for(ix=0; ix < localmesh->LocalNx; ix++) {
+      rfft(b[i][ix], ncz, std::begin(bk1d));
+      for(int kz = 0; kz <= maxmode; kz++)
+        data.bk(i * nmode + kz, ix) = bk1d[kz];
+    }
   }
 
   /// Create the matrices to be inverted (one for each z point)
@@ -172,17 +210,19 @@ void LaplacePDD::start(const FieldPerp &b, PDD_data &data) {
   BoutReal kwaveFactor = 2.0 * PI / coords->zlength();
 
   /// Set matrix elements
-  for (int kz = 0; kz <= maxmode; kz++) {
-    tridagMatrix(&data.avec(kz, 0), &data.bvec(kz, 0), &data.cvec(kz, 0), &data.bk(kz, 0),
-                 kz, kz * kwaveFactor, data.jy, global_flags, inner_boundary_flags,
-                 outer_boundary_flags, &Acoef, &Ccoef, &Dcoef);
+  for (int isys = 0; isys < nsys; isys++) {
+    const int kz = isys % nmode;
+    tridagMatrix(&data.avec(isys, 0), &data.bvec(isys, 0), &data.cvec(isys, 0),
+                 &data.bk(isys, 0), data.jy[isys / nmode], kz, kz * kwaveFactor,
+                 global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef, &Ccoef,
+                 &Dcoef);
   }
 
   Array<dcomplex> e(localmesh->LocalNx);
   for (ix = 0; ix < localmesh->LocalNx; ix++)
     e[ix] = 0.0; // Do we need this?
 
-  for(kz = 0; kz <= maxmode; kz++) {
+  for (int isys = 0; isys < nsys; isys++) {
     // Start PDD algorithm
 
     // Solve for xtilde, v and w (step 2)
@@ -191,56 +231,56 @@ void LaplacePDD::start(const FieldPerp &b, PDD_data &data) {
 
     if(localmesh->firstX()) {
       // Domain includes inner boundary
-      tridag(&data.avec(kz, 0), &data.bvec(kz, 0), &data.cvec(kz, 0), &data.bk(kz, 0),
-             &data.xk(kz, 0), localmesh->xend + 1);
+      tridag(&data.avec(isys, 0), &data.bvec(isys, 0), &data.cvec(isys, 0), &data.bk(isys, 0),
+             &data.xk(isys, 0), localmesh->xend + 1);
 
       // Add C (row m-1) from next processor
 
-      e[localmesh->xend] = data.cvec(kz, localmesh->xend);
-      tridag(&data.avec(kz, 0), &data.bvec(kz, 0), &data.cvec(kz, 0), std::begin(e),
-             &data.w(kz, 0), localmesh->xend + 1);
+      e[localmesh->xend] = data.cvec(isys, localmesh->xend);
+      tridag(&data.avec(isys, 0), &data.bvec(isys, 0), &data.cvec(isys, 0), std::begin(e),
+             &data.w(isys, 0), localmesh->xend + 1);
 
     }else if(localmesh->lastX()) {
       // Domain includes outer boundary
-      tridag(&data.avec(kz, localmesh->xstart), &data.bvec(kz, localmesh->xstart),
-             &data.cvec(kz, localmesh->xstart), &data.bk(kz, localmesh->xstart),
-             &data.xk(kz, localmesh->xstart), localmesh->xend - localmesh->xend + 1);
+      tridag(&data.avec(isys, localmesh->xstart), &data.bvec(isys, localmesh->xstart),
+             &data.cvec(isys, localmesh->xstart), &data.bk(isys, localmesh->xstart),
+             &data.xk(isys, localmesh->xstart), localmesh->xend - localmesh->xend + 1);
 
       // Add A (row 0) from previous processor
-      e[0] = data.avec(kz, localmesh->xstart);
-      tridag(&data.avec(kz, localmesh->xstart), &data.bvec(kz, localmesh->xstart),
-             &data.cvec(kz, localmesh->xstart), std::begin(e), &data.v(kz, localmesh->xstart),
+      e[0] = data.avec(isys, localmesh->xstart);
+      tridag(&data.avec(isys, localmesh->xstart), &data.bvec(isys, localmesh->xstart),
+             &data.cvec(isys, localmesh->xstart), std::begin(e), &data.v(isys, localmesh->xstart),
              localmesh->xend + 1);
 
-      x0 = data.xk(kz, localmesh->xstart);
-      v0 = data.v(kz, localmesh->xstart);
+      x0 = data.xk(isys, localmesh->xstart);
+      v0 = data.v(isys, localmesh->xstart);
 
     }else {
       // No boundaries
-      tridag(&data.avec(kz, localmesh->xstart), &data.bvec(kz, localmesh->xstart),
-             &data.cvec(kz, localmesh->xstart), &data.bk(kz, localmesh->xstart),
-             &data.xk(kz, localmesh->xstart), localmesh->xend - localmesh->xstart + 1);
+      tridag(&data.avec(isys, localmesh->xstart), &data.bvec(isys, localmesh->xstart),
+             &data.cvec(isys, localmesh->xstart), &data.bk(isys, localmesh->xstart),
+             &data.xk(isys, localmesh->xstart), localmesh->xend - localmesh->xstart + 1);
 
       // Add A (row 0) from previous processor
-      e[0] = data.avec(kz, localmesh->xstart);
-      tridag(&data.avec(kz, localmesh->xstart), &data.bvec(kz, localmesh->xstart),
-             &data.cvec(kz, localmesh->xstart), &e[localmesh->xstart], &data.v(kz, localmesh->xstart),
+      e[0] = data.avec(isys, localmesh->xstart);
+      tridag(&data.avec(isys, localmesh->xstart), &data.bvec(isys, localmesh->xstart),
+             &data.cvec(isys, localmesh->xstart), &e[localmesh->xstart], &data.v(isys, localmesh->xstart),
              localmesh->xend - localmesh->xstart + 1);
       e[0] = 0.0;
       
       // Add C (row m-1) from next processor
-      e[localmesh->xend] = data.cvec(kz, localmesh->xend);
-      tridag(&data.avec(kz, localmesh->xstart), &data.bvec(kz, localmesh->xstart),
-             &data.cvec(kz, localmesh->xstart), &e[localmesh->xstart], &data.v(kz, localmesh->xstart),
+      e[localmesh->xend] = data.cvec(isys, localmesh->xend);
+      tridag(&data.avec(isys, localmesh->xstart), &data.bvec(isys, localmesh->xstart),
+             &data.cvec(isys, localmesh->xstart), &e[localmesh->xstart], &data.v(isys, localmesh->xstart),
              localmesh->xend - localmesh->xstart + 1);
       e[localmesh->xend] = 0.0;
     }
     
     // Put values into communication buffers
-    data.snd[4*kz]   = x0.real();
-    data.snd[4*kz+1] = x0.imag();
-    data.snd[4*kz+2] = v0.real();
-    data.snd[4*kz+3] = v0.imag();
+    data.snd[4*isys]   = x0.real();
+    data.snd[4*isys+1] = x0.imag();
+    data.snd[4*isys+2] = v0.real();
+    data.snd[4*isys+3] = v0.imag();
   }
   
   // Stage 3: Communicate x0, v0 from node i to i-1
@@ -249,19 +289,21 @@ void LaplacePDD::start(const FieldPerp &b, PDD_data &data) {
     // All except the last processor expect to receive data
     // Post async receive
     data.recv_handle =
-        localmesh->irecvXOut(std::begin(data.rcv), 4 * (maxmode + 1), PDD_COMM_XV);
+        localmesh->irecvXOut(std::begin(data.rcv), 4 * nsys, PDD_COMM_XV);
   }
 
   if(!localmesh->firstX()) {
     // Send the data
 
-    localmesh->sendXIn(std::begin(data.snd), 4 * (maxmode + 1), PDD_COMM_XV);
+    localmesh->sendXIn(std::begin(data.snd), 4 * nsys, PDD_COMM_XV);
   }
 }
 
 
 /// Middle part of the PDD algorithm
 void LaplacePDD::next(PDD_data &data) {
+  const int nsys = data.y2i.size();
+
   // Wait for x0 and v0 to arrive from processor i+1
   
   if(!localmesh->lastX()) {
@@ -275,60 +317,58 @@ void LaplacePDD::next(PDD_data &data) {
      * Only interested in the value of y_2i however
      */
     
-    for(int kz = 0; kz <= maxmode; kz++) {
+    for(int isys = 0; isys < nsys; isys++) {
       dcomplex v0, x0;
       
       // Get x and v0 from processor
-      x0 = dcomplex(data.rcv[4*kz], data.rcv[4*kz+1]);
-      v0 = dcomplex(data.rcv[4*kz+2], data.rcv[4*kz+3]);
+      x0 = dcomplex(data.rcv[4*isys], data.rcv[4*isys+1]);
+      v0 = dcomplex(data.rcv[4*isys+2], data.rcv[4*isys+3]);
 
-      data.y2i[kz] = (data.xk(kz, localmesh->xend) - data.w(kz, localmesh->xend) * x0) /
-                     (1. - data.w(kz, localmesh->xend) * v0);
+      data.y2i[isys] = (data.xk(isys, localmesh->xend) - data.w(isys, localmesh->xend) * x0) /
+                       (1. - data.w(isys, localmesh->xend) * v0);
     }
   }
   
   if(!localmesh->firstX()) {
     // All except pe=0 receive values from i-1. Posting async receive
     data.recv_handle =
-        localmesh->irecvXIn(std::begin(data.rcv), 2 * (maxmode + 1), PDD_COMM_Y);
+        localmesh->irecvXIn(std::begin(data.rcv), 2 * nsys, PDD_COMM_Y);
   }
   
   if(!localmesh->lastX()) {
     // Send value to the (i+1)th processor
     
-    for(int kz = 0; kz <= maxmode; kz++) {
-      data.snd[2*kz]   = data.y2i[kz].real();
-      data.snd[2*kz+1] = data.y2i[kz].imag();
+    for(int isys = 0; isys < nsys; isys++) {
+      data.snd[2*isys]   = data.y2i[isys].real();
+      data.snd[2*isys+1] = data.y2i[isys].imag();
     }
 
-    localmesh->sendXOut(std::begin(data.snd), 2 * (maxmode + 1), PDD_COMM_Y);
+    localmesh->sendXOut(std::begin(data.snd), 2 * nsys, PDD_COMM_Y);
   }
 }
 
 /// Last part of the PDD algorithm
-void LaplacePDD::finish(PDD_data &data, FieldPerp &x) {
-  ASSERT1(x.getLocation() == location);
-
+void LaplacePDD::finish(PDD_data &data, std::vector<FieldPerp> &x) {
   int ix, kz;
 
-  x.allocate();
-  x.setIndex(data.jy);
-  
+  const int nmode = maxmode + 1;
+  const int nsys = data.y2i.size();
+
   if(!localmesh->lastX()) {
-    for(kz = 0; kz <= maxmode; kz++) {
+    for(int isys = 0; isys < nsys; isys++) {
       for(ix=0; ix < localmesh->LocalNx; ix++)
-        data.xk(kz, ix) -= data.w(kz, ix) * data.y2i[kz];
+        data.xk(isys, ix) -= data.w(isys, ix) * data.y2i[isys];
     }
   }
 
   if(!localmesh->firstX()) {
     localmesh->wait(data.recv_handle);
   
-    for(kz = 0; kz <= maxmode; kz++) {
-      dcomplex y2m = dcomplex(data.rcv[2*kz], data.rcv[2*kz+1]);
+    for(int isys = 0; isys < nsys; isys++) {
+      dcomplex y2m = dcomplex(data.rcv[2*isys], data.rcv[2*isys+1]);
       
       for(ix=0; ix < localmesh->LocalNx; ix++)
-        data.xk(kz, ix) -= data.v(kz, ix) * y2m;
+        data.xk(isys, ix) -= data.v(isys, ix) * y2m;
     }
   }
   
@@ -339,15 +379,22 @@ void LaplacePDD::finish(PDD_data &data, FieldPerp &x) {
   for (kz = maxmode; kz <= ncz / 2; kz++)
     xk1d[kz] = 0.0;
 
-  for(ix=0; ix<localmesh->LocalNx; ix++){
+  for (std::size_t i = 0; i < x.size(); i++) {
+    ASSERT1(x[i].getLocation() == location);
+
+    x[i].allocate();
+    x[i].setIndex(data.jy[i]);
+
+    for(ix=0; ix<localmesh->LocalNx; ix++){
     
-    for(kz = 0; kz <= maxmode; kz++) {
-      xk1d[kz] = data.xk(kz, ix);
-    }
+      for(kz = 0; kz <= maxmode; kz++) {
+        xk1d[kz] = data.xk(i * nmode + kz, ix);
+      }
 
-    if(global_flags & INVERT_ZERO_DC)
-      xk1d[0] = 0.0;
+      if(global_flags & INVERT_ZERO_DC)
+        xk1d[0] = 0.0;
 
-    irfft(std::begin(xk1d), ncz, x[ix]);
+      irfft(std::begin(xk1d), ncz, x[i][ix]);
+    }
   }
 }
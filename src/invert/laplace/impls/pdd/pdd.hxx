@@ -80,19 +80,21 @@ public:
   using Laplacian::solve;
   FieldPerp solve(const FieldPerp &b) override;
   Field3D solve(const Field3D &b) override;
+  std::vector<Field3D> solve(const std::vector<Field3D> &b) override;
 private:
   Field2D Acoef, Ccoef, Dcoef;
   
   const int PDD_COMM_XV; // First message tag
   const int PDD_COMM_Y;  // Second tag
   
-  /// Data structure for PDD algorithm
+  /// Data structure for PDD algorithm. Holds the systems for a set of
+  /// X-Z slices, which are all communicated together
   struct PDD_data {
-    Matrix<dcomplex> bk;  ///< b vector in Fourier space
+    Matrix<dcomplex> bk;  ///< b vector in Fourier space [slice * (maxmode + 1) + kz, x]
 
     Matrix<dcomplex> avec, bvec, cvec; ///< Diagonal bands of matrix
   
-    int jy; ///< Y index
+    std::vector<int> jy; ///< Y index of each slice
   
     Matrix<dcomplex> xk;
     Matrix<dcomplex> v, w;
@@ -105,9 +107,14 @@ private:
     Array<dcomplex> y2i;
   };
   
-  void start(const FieldPerp &b, PDD_data &data);
+  PDD_data data3d; ///< Working memory for solving many slices
+
+  /// Solve a set of slices, with one communication for each stage
+  std::vector<FieldPerp> solveSlices(const std::vector<FieldPerp> &b, PDD_data &data);
+
+  void start(const std::vector<FieldPerp> &b, PDD_data &data);
   void next(PDD_data &data);
-  void finish(PDD_data &data, FieldPerp &x);
+  void finish(PDD_data &data, std::vector<FieldPerp> &x);
 };
 
 #endif // __LAPLACE_PDD_H__
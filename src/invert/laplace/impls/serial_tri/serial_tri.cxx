@@ -34,6 +34,7 @@
 #include <lapack_routines.hxx>
 #include <bout/constants.hxx>
 #include <bout/openmpwrap.hxx>
+#include <bout/sys/timer.hxx>
 #include <cmath>
 
 #include <output.hxx>
@@ -51,34 +52,92 @@ LaplaceSerialTri::LaplaceSerialTri(Options *opt, CELL_LOC loc, Mesh *mesh_in)
 
 FieldPerp LaplaceSerialTri::solve(const FieldPerp& b) { return solve(b, b); }
 
+FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
+  return solveSlices({b}, {x0}).front();
+}
+
+std::vector<Field3D> LaplaceSerialTri::solve(const std::vector<Field3D>& b,
+                                             const std::vector<Field3D>& x0) {
+  TRACE("LaplaceSerialTri::solve(vector<Field3D>, vector<Field3D>)");
+
+  if (b.size() != x0.size()) {
+    throw BoutException("LaplaceSerialTri::solve: %d right hand sides but %d initial guesses",
+                        static_cast<int>(b.size()), static_cast<int>(x0.size()));
+  }
+
+  Timer timer("invert");
+
+  // Setting the start and end range of the y-slices
+  int ys = localmesh->ystart, ye = localmesh->yend;
+  if(localmesh->hasBndryLowerY() && include_yguards)
+    ys = 0; // Mesh contains a lower boundary
+  if(localmesh->hasBndryUpperY() && include_yguards)
+    ye = localmesh->LocalNy-1; // Contains upper boundary
+
+  std::vector<Field3D> x;
+  x.reserve(b.size());
+  for (const auto& rhs : b) {
+    x.push_back(emptyFrom(rhs));
+  }
+
+  std::vector<FieldPerp> bslices(b.size()), x0slices(b.size());
+  for (int jy = ys; jy <= ye; jy++) {
+    for (std::size_t i = 0; i < b.size(); i++) {
+      bslices[i] = sliceXZ(b[i], jy);
+      x0slices[i] = sliceXZ(x0[i], jy);
+    }
+    const auto xslices = solveSlices(bslices, x0slices);
+    for (std::size_t i = 0; i < b.size(); i++) {
+      x[i] = xslices[i];
+    }
+  }
+
+  return x;
+}
+
 /*!
  * Solve Ax=b for x given b
  *
  * This function will
- *      1. Take the fourier transform of the y-slice given in the input
+ *      1. Take the fourier transform of the y-slices given in the input
  *      2. For each fourier mode
  *          a) Set up the tridiagonal matrix
  *          b) Call the solver which inverts the matrix Ax_mode = b_mode
+ *             for each of the slices
  *      3. Collect all the modes in a 2D array
- *      4. Back transform the y-slice
+ *      4. Back transform the y-slices
  *
  * Input:
- * \param[in] b     A 2D variable that will be fourier decomposed, each fourier
- *                  mode of this variable is going to be the right hand side of
- *                  the equation Ax = b
- * \param[in] x0    Variable used to set BC (if the right flags are set, see
+ * \param[in] b     2D variables that will be fourier decomposed, each fourier
+ *                  mode of these variables is going to be the right hand side of
+ *                  the equation Ax = b. All must be at the same Y index
+ * \param[in] x0    Variables used to set BC (if the right flags are set, see
  *                  the user manual)
  *
- * \return          The inverted variable.
+ * \return          The inverted variables.
  */
-FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
-  ASSERT1(localmesh == b.getMesh() && localmesh == x0.getMesh());
-  ASSERT1(b.getLocation() == location);
-  ASSERT1(x0.getLocation() == location);
+std::vector<FieldPerp> LaplaceSerialTri::solveSlices(const std::vector<FieldPerp>& b,
+                                                     const std::vector<FieldPerp>& x0) {
+  ASSERT1(b.size() == x0.size());
+  const int nslice = b.size();
+
+  for (int i = 0; i < nslice; i++) {
+    ASSERT1(localmesh == b[i].getMesh() && localmesh == x0[i].getMesh());
+    ASSERT1(b[i].getLocation() == location);
+    ASSERT1(x0[i].getLocation() == location);
+    ASSERT1(b[i].getIndex() == b[0].getIndex());
+  }
 
-  FieldPerp x{emptyFrom(b)};
+  std::vector<FieldPerp> x;
+  x.reserve(nslice);
+  for (const auto& slice : b) {
+    x.push_back(emptyFrom(slice));
+  }
+  if (nslice == 0) {
+    return x;
+  }
 
-  int jy = b.getIndex();
+  int jy = b[0].getIndex();
 
   int ncz = localmesh->LocalNz; // No of z pnts
   int ncx = localmesh->LocalNx; // No of x pnts
@@ -106,15 +165,19 @@ FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
    *        LaplaceSerialTri::solve()
    * xk1d = The 1d array of xk
    */
-  auto bk = Matrix<dcomplex>(ncx, ncz / 2 + 1);
+  std::vector<Matrix<dcomplex>> bk(nslice), xk(nslice);
   auto bk1d = Array<dcomplex>(ncx);
-  auto xk = Matrix<dcomplex>(ncx, ncz / 2 + 1);
   auto xk1d = Array<dcomplex>(ncx);
 
-  // Initialise xk to 0 as we only visit 0<= kz <= maxmode in solve
-  for (int ix = 0; ix < ncx; ix++) {
-    for (int kz = maxmode + 1; kz < ncz / 2 + 1; kz++) {
-      xk(ix, kz) = 0.0;
+  for (int i = 0; i < nslice; i++) {
+    bk[i].reallocate(ncx, ncz / 2 + 1);
+    xk[i].reallocate(ncx, ncz / 2 + 1);
+
+    // Initialise xk to 0 as we only visit 0<= kz <= maxmode in solve
+    for (int ix = 0; ix < ncx; ix++) {
+      for (int kz = maxmode + 1; kz < ncz / 2 + 1; kz++) {
+        xk[i](ix, kz) = 0.0;
+      }
     }
   }
 
@@ -131,7 +194,9 @@ FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
   auto cvec = Array<dcomplex>(ncx);
 
   BOUT_OMP(parallel for)
-  for (int ix = 0; ix < ncx; ix++) {
+  for (int ind = 0; ind < nslice * ncx; ind++) {
+    const int i = ind / ncx;
+    const int ix = ind % ncx;
     /* This for loop will set the bk (initialized by the constructor)
      * bk is the z fourier modes of b in z
      * If the INVERT_SET flag is set (meaning that x0 will be used to set the
@@ -143,12 +208,12 @@ FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
 
       // x0 is the input
       // bk is the output
-      rfft(x0[ix], ncz, &bk(ix, 0));
+      rfft(x0[i][ix], ncz, &bk[i](ix, 0));
 
     } else {
       // b is the input
       // bk is the output
-      rfft(b[ix], ncz, &bk(ix, 0));
+      rfft(b[i][ix], ncz, &bk[i](ix, 0));
     }
   }
 
@@ -158,12 +223,6 @@ FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
    */
   for (int kz = 0; kz <= maxmode; kz++) {
 
-    // set bk1d
-    for (int ix = 0; ix < ncx; ix++) {
-      // Get bk of the current fourier mode
-      bk1d[ix] = bk(ix, kz);
-    }
-
     /* Set the matrix A used in the inversion of Ax=b
      * by calling tridagCoef and setting the BC
      *
@@ -175,6 +234,9 @@ FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
      * avec - the lower diagonal of the tridiagonal matrix
      * bvec - the main diagonal
      * cvec - the upper diagonal
+     *
+     * The boundary values of the right hand sides are set below, so
+     * bk1d is only used as workspace here
     */
     tridagMatrix(std::begin(avec), std::begin(bvec), std::begin(cvec), std::begin(bk1d),
                  jy,
@@ -185,59 +247,71 @@ FieldPerp LaplaceSerialTri::solve(const FieldPerp& b, const FieldPerp& x0) {
                  kz * kwaveFactor, global_flags, inner_boundary_flags,
                  outer_boundary_flags, &A, &C, &D);
 
-    ///////// PERFORM INVERSION /////////
-    if (!localmesh->periodicX) {
-      // Call tridiagonal solver
-      tridag(std::begin(avec), std::begin(bvec), std::begin(cvec), std::begin(bk1d),
-             std::begin(xk1d), ncx);
-
-    } else {
-      // Periodic in X, so cyclic tridiagonal
-
-      int xs = localmesh->xstart;
-      cyclic_tridag(&avec[xs], &bvec[xs], &cvec[xs], &bk1d[xs], &xk1d[xs], ncx - 2 * xs);
-
-      // Copy boundary regions
-      for (int ix = 0; ix < xs; ix++) {
-        xk1d[ix] = xk1d[ncx - 2 * xs + ix];
-        xk1d[ncx - xs + ix] = xk1d[xs + ix];
+    for (int i = 0; i < nslice; i++) {
+      // set bk1d
+      for (int ix = 0; ix < ncx; ix++) {
+        // Get bk of the current fourier mode
+        bk1d[ix] = bk[i](ix, kz);
       }
-    }
-
-    // If the global flag is set to INVERT_KX_ZERO
-    if ((global_flags & INVERT_KX_ZERO) && (kz == 0)) {
-      dcomplex offset(0.0);
-      for (int ix = localmesh->xstart; ix <= localmesh->xend; ix++) {
-        offset += xk1d[ix];
+      zeroBoundaryRHS(std::begin(bk1d), global_flags, inner_boundary_flags,
+                      outer_boundary_flags);
+
+      ///////// PERFORM INVERSION /////////
+      if (!localmesh->periodicX) {
+        // Call tridiagonal solver
+        tridag(std::begin(avec), std::begin(bvec), std::begin(cvec), std::begin(bk1d),
+               std::begin(xk1d), ncx);
+
+      } else {
+        // Periodic in X, so cyclic tridiagonal
+
+        int xs = localmesh->xstart;
+        cyclic_tridag(&avec[xs], &bvec[xs], &cvec[xs], &bk1d[xs], &xk1d[xs], ncx - 2 * xs);
+
+        // Copy boundary regions
+        for (int ix = 0; ix < xs; ix++) {
+          xk1d[ix] = xk1d[ncx - 2 * xs + ix];
+          xk1d[ncx - xs + ix] = xk1d[xs + ix];
+        }
       }
-      offset /= static_cast<BoutReal>(localmesh->xend - localmesh->xstart + 1);
-      for (int ix = localmesh->xstart; ix <= localmesh->xend; ix++) {
-        xk1d[ix] -= offset;
+
+      // If the global flag is set to INVERT_KX_ZERO
+      if ((global_flags & INVERT_KX_ZERO) && (kz == 0)) {
+        dcomplex offset(0.0);
+        for (int ix = localmesh->xstart; ix <= localmesh->xend; ix++) {
+          offset += xk1d[ix];
+        }
+        offset /= static_cast<BoutReal>(localmesh->xend - localmesh->xstart + 1);
+        for (int ix = localmesh->xstart; ix <= localmesh->xend; ix++) {
+          xk1d[ix] -= offset;
+        }
       }
-    }
 
-    // Store the solution xk for the current fourier mode in a 2D array
-    for (int ix = 0; ix < ncx; ix++) {
-      xk(ix, kz) = xk1d[ix];
+      // Store the solution xk for the current fourier mode in a 2D array
+      for (int ix = 0; ix < ncx; ix++) {
+        xk[i](ix, kz) = xk1d[ix];
+      }
     }
   }
 
   // Done inversion, transform back
-  for (int ix = 0; ix < ncx; ix++) {
+  for (int i = 0; i < nslice; i++) {
+    for (int ix = 0; ix < ncx; ix++) {
 
-    if(global_flags & INVERT_ZERO_DC)
-      xk(ix, 0) = 0.0;
+      if(global_flags & INVERT_ZERO_DC)
+        xk[i](ix, 0) = 0.0;
 
-    irfft(&xk(ix, 0), ncz, x[ix]);
+      irfft(&xk[i](ix, 0), ncz, x[i][ix]);
 
 #if CHECK > 2
-    for(int kz=0;kz<ncz;kz++)
-      if(!finite(x(ix,kz)))
-        throw BoutException("Non-finite at %d, %d, %d", ix, jy, kz);
+      for(int kz=0;kz<ncz;kz++)
+        if(!finite(x[i](ix,kz)))
+          throw BoutException("Non-finite at %d, %d, %d", ix, jy, kz);
 #endif
-  }
+    }
 
-  checkData(x);
+    checkData(x[i]);
+  }
 
   return x; // Result of the inversion
 }
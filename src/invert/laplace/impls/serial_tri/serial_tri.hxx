@@ -68,10 +68,21 @@ public:
   using Laplacian::solve;
   FieldPerp solve(const FieldPerp &b) override;
   FieldPerp solve(const FieldPerp &b, const FieldPerp &x0) override;
+
+  std::vector<Field3D> solve(const std::vector<Field3D> &b) override {
+    return solve(b, b);
+  }
+  std::vector<Field3D> solve(const std::vector<Field3D> &b,
+                             const std::vector<Field3D> &x0) override;
 private:
   // The coefficents in
   // D*grad_perp^2(x) + (1/C)*(grad_perp(C))*grad_perp(x) + A*x = b
   Field2D A, C, D;
+
+  /// Solve for several slices at the same Y index, so the matrix for
+  /// each mode is only calculated once
+  std::vector<FieldPerp> solveSlices(const std::vector<FieldPerp> &b,
+                                     const std::vector<FieldPerp> &x0);
 };
 
 #endif // __SERIAL_TRI_H__
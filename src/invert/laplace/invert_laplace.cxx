@@ -237,6 +237,30 @@ Field2D Laplacian::solve(const Field2D& b, const Field2D& x0) {
   return DC(f);
 }
 
+// Solvers which can't combine the right hand sides solve them one at a time
+std::vector<Field3D> Laplacian::solve(const std::vector<Field3D>& b) {
+  std::vector<Field3D> x;
+  x.reserve(b.size());
+  for (const auto& rhs : b) {
+    x.push_back(solve(rhs));
+  }
+  return x;
+}
+
+std::vector<Field3D> Laplacian::solve(const std::vector<Field3D>& b,
+                                      const std::vector<Field3D>& x0) {
+  if (b.size() != x0.size()) {
+    throw BoutException("Laplacian::solve: %d right hand sides but %d initial guesses",
+                        static_cast<int>(b.size()), static_cast<int>(x0.size()));
+  }
+  std::vector<Field3D> x;
+  x.reserve(b.size());
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    x.push_back(solve(b[i], x0[i]));
+  }
+  return x;
+}
+
 /**********************************************************************************
  *                              MATRIX ELEMENTS
  **********************************************************************************/
@@ -463,16 +487,14 @@ void Laplacian::tridagMatrix(dcomplex *avec, dcomplex *bvec, dcomplex *cvec,
 
   // Set the boundary conditions if x is not periodic
   if(!localmesh->periodicX) {
+    // If no user specified value is set on the boundaries, set the
+    // boundary elements in b (in the equation AX=b) to 0
+    zeroBoundaryRHS(bk, global_flags, inner_boundary_flags, outer_boundary_flags,
+                    includeguards);
+
     if(localmesh->firstX()) {
       // INNER BOUNDARY ON THIS PROCESSOR
 
-      // If no user specified value is set on inner boundary, set the first
-      // element in b (in the equation AX=b) to 0
-      if(!(inner_boundary_flags & (INVERT_RHS | INVERT_SET))) {
-        for(int ix=0;ix<inbndry;ix++)
-          bk[ix] = 0.;
-      }
-
       // DC i.e. kz = 0 (the offset mode)
       if(kz == 0) {
 
@@ -629,14 +651,6 @@ void Laplacian::tridagMatrix(dcomplex *avec, dcomplex *bvec, dcomplex *cvec,
     if(localmesh->lastX()) {
       // OUTER BOUNDARY ON THIS PROCESSOR
 
-      // If no user specified value is set on outer boundary, set the last
-      // element in b (in the equation AX=b) to 0
-      if(!(outer_boundary_flags & (INVERT_RHS | INVERT_SET))) {
-        for (int ix=0;ix<outbndry;ix++) {
-          bk[ncx-ix] = 0.;
-        }
-      }
-
       // DC i.e. kz = 0 (the offset mode)
       if(kz==0) {
 
@@ -736,6 +750,49 @@ void Laplacian::tridagMatrix(dcomplex *avec, dcomplex *bvec, dcomplex *cvec,
   }
 }
 
+/*!
+ * Set the boundary elements of the right hand side to zero, unless the
+ * flags say that the boundary values are given in the right hand side
+ * (INVERT_RHS) or in x0 (INVERT_SET). This is the same as tridagMatrix
+ * does, and is for solvers which reuse the matrix with a new right hand side
+ *
+ * \param[inout] bk  The b in Ax = b, with the same size as given to tridagMatrix
+ */
+void Laplacian::zeroBoundaryRHS(dcomplex *bk, int global_flags, int inner_boundary_flags,
+                                int outer_boundary_flags, bool includeguards) const {
+  if (localmesh->periodicX) {
+    return;
+  }
+
+  int xs = 0;
+  int xe = localmesh->LocalNx - 1;
+  if (!includeguards) {
+    if (!localmesh->firstX())
+      xs = localmesh->xstart;
+    if (!localmesh->lastX())
+      xe = localmesh->xend;
+  }
+  const int ncx = xe - xs;
+
+  int inbndry = localmesh->xstart, outbndry = localmesh->xstart;
+  if ((global_flags & INVERT_BOTH_BNDRY_ONE) || (localmesh->xstart < 2)) {
+    inbndry = outbndry = 1;
+  }
+  if (inner_boundary_flags & INVERT_BNDRY_ONE)
+    inbndry = 1;
+  if (outer_boundary_flags & INVERT_BNDRY_ONE)
+    outbndry = 1;
+
+  if (localmesh->firstX() && !(inner_boundary_flags & (INVERT_RHS | INVERT_SET))) {
+    for (int ix = 0; ix < inbndry; ix++)
+      bk[ix] = 0.;
+  }
+  if (localmesh->lastX() && !(outer_boundary_flags & (INVERT_RHS | INVERT_SET))) {
+    for (int ix = 0; ix < outbndry; ix++)
+      bk[ncx - ix] = 0.;
+  }
+}
+
 /**********************************************************************************
  *                              LEGACY INTERFACE
  *
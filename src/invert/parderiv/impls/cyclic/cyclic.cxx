@@ -47,6 +47,7 @@
 
 #include <bout/surfaceiter.hxx>
 
+#include <algorithm>
 #include <cmath>
 
 InvertParCR::InvertParCR(Options *opt, CELL_LOC location, Mesh *mesh_in)
@@ -58,83 +59,106 @@ InvertParCR::InvertParCR(Options *opt, CELL_LOC location, Mesh *mesh_in)
   sg = DDY(1. / sg) / sg;
 }
 
-const Field3D InvertParCR::solve(const Field3D &f) {
-  TRACE("InvertParCR::solve(Field3D)");
-  ASSERT1(localmesh == f.getMesh());
-  ASSERT1(location == f.getLocation());
+void InvertParCR::setupSurfaces() {
+  TRACE("InvertParCR::setupSurfaces");
 
-  Field3D result = emptyFrom(f).setDirectionY(YDirectionType::Aligned);
-  
-  Coordinates *coord = f.getCoordinates();
+  Coordinates *coord = localmesh->getCoordinates(location);
 
-  Field3D alignedField = toFieldAligned(f, "RGN_NOX");
+  int maxsize = localmesh->LocalNy - 2 * localmesh->ystart;
 
-  // Create cyclic reduction object
-  auto cr = bout::utils::make_unique<CyclicReduce<dcomplex>>();
-
-  // Find out if we are on a boundary
-  int size = localmesh->LocalNy - 2 * localmesh->ystart;
   SurfaceIter surf(localmesh);
   for (surf.first(); !surf.isDone(); surf.next()) {
-    int n = localmesh->LocalNy - 2 * localmesh->ystart;
-    if (!surf.closed()) {
-      // Open field line
-      if (surf.firstY()) {
-        if (location == CELL_YLOW) {
-          // The 'boundary' includes the grid point at mesh->ystart
-          n += localmesh->ystart - 1;
-        } else {
-          n += localmesh->ystart;
-        }
-      }
-      if (surf.lastY()) {
-        n += localmesh->ystart;
-      }
+    Surface surface;
+    surface.xpos = surf.xpos;
 
-      if (n > size)
-        size = n; // Maximum size
-    }
-  }
-
-  auto rhs = Matrix<dcomplex>(localmesh->LocalNy, nsys);
-  auto rhsk = Matrix<dcomplex>(nsys, size);
-  auto xk = Matrix<dcomplex>(nsys, size);
-  auto a = Matrix<dcomplex>(nsys, size);
-  auto b = Matrix<dcomplex>(nsys, size);
-  auto c = Matrix<dcomplex>(nsys, size);
-
-  // Loop over flux-surfaces
-  for (surf.first(); !surf.isDone(); surf.next()) {
-    int x = surf.xpos;
-    
     // Test if open or closed field-lines
     BoutReal ts;
-    bool closed = surf.closed(ts);
+    surface.closed = surf.closed(ts);
 
     // Number of rows
-    int y0 = 0;
-    int local_ystart = localmesh->ystart;
-    size = localmesh->LocalNy - 2 * localmesh->ystart; // If no boundaries
-    if (!closed) {
-      if (surf.firstY()) {
+    surface.y0 = 0;
+    surface.local_ystart = localmesh->ystart;
+    surface.size = localmesh->LocalNy - 2 * localmesh->ystart; // If no boundaries
+    surface.lower_bndry = surface.upper_bndry = false;
+    surface.first_proc = surface.last_proc = false;
+    if (!surface.closed) {
+      surface.lower_bndry = surf.firstY();
+      surface.upper_bndry = surf.lastY();
+      if (surface.lower_bndry) {
         if (location == CELL_YLOW) {
           // The 'boundary' includes the grid point at mesh->ystart
-          y0 += localmesh->ystart;
-          size += localmesh->ystart - 1;
-          local_ystart = localmesh->ystart + 1;
+          surface.y0 += localmesh->ystart;
+          surface.size += localmesh->ystart - 1;
+          surface.local_ystart = localmesh->ystart + 1;
         } else {
-          y0 += localmesh->ystart;
-          size += localmesh->ystart;
+          surface.y0 += localmesh->ystart;
+          surface.size += localmesh->ystart;
         }
       }
-      if (surf.lastY()) {
-        size += localmesh->ystart;
+      if (surface.upper_bndry) {
+        surface.size += localmesh->ystart;
+      }
+    } else {
+      // Twist-shift
+      int rank, np;
+      MPI_Comm_rank(surf.communicator(), &rank);
+      MPI_Comm_size(surf.communicator(), &np);
+      surface.first_proc = (rank == 0);
+      surface.last_proc = (rank == np - 1);
+
+      if (surface.first_proc || surface.last_proc) {
+        // Phase applied on the first processor. Conjugate on the last
+        surface.phase.reallocate(nsys);
+        for (int k = 0; k < nsys; k++) {
+          BoutReal kwave=k*2.0*PI/coord->zlength(); // wave number is 1/[rad]
+          surface.phase[k] = dcomplex(cos(kwave*ts) , -sin(kwave*ts));
+        }
       }
     }
+    maxsize = std::max(maxsize, surface.size);
 
     // Setup CyclicReduce object
-    cr->setup(surf.communicator(), size);
-    cr->setPeriodic(closed);
+    surface.cr = bout::utils::make_unique<CyclicReduce<dcomplex>>(surf.communicator(),
+                                                                  surface.size);
+    surface.cr->setPeriodic(surface.closed);
+
+    surface.rhsk.reallocate(nsys, surface.size);
+    surface.xk.reallocate(nsys, surface.size);
+
+    surfaces.push_back(std::move(surface));
+  }
+
+  rhs.reallocate(localmesh->LocalNy, nsys);
+  a.reallocate(nsys, maxsize);
+  b.reallocate(nsys, maxsize);
+  c.reallocate(nsys, maxsize);
+
+  surfaces_setup = true;
+}
+
+const Field3D InvertParCR::solve(const Field3D &f) {
+  TRACE("InvertParCR::solve(Field3D)");
+  ASSERT1(localmesh == f.getMesh());
+  ASSERT1(location == f.getLocation());
+
+  Field3D result = emptyFrom(f).setDirectionY(YDirectionType::Aligned);
+  
+  Coordinates *coord = f.getCoordinates();
+
+  Field3D alignedField = toFieldAligned(f, "RGN_NOX");
+
+  if (!surfaces_setup) {
+    setupSurfaces();
+  }
+
+  // Loop over flux-surfaces
+  for (auto &surface : surfaces) {
+    const int x = surface.xpos;
+    const int y0 = surface.y0;
+    const int local_ystart = surface.local_ystart;
+    const int size = surface.size;
+    auto &rhsk = surface.rhsk;
+    auto &xk = surface.xk;
     
     // Take Fourier transform
     for (int y = 0; y < localmesh->LocalNy - localmesh->ystart - local_ystart; y++)
@@ -172,28 +196,21 @@ const Field3D InvertParCR::solve(const Field3D &f) {
       }
     }
 
-    if (closed) {
+    if (surface.closed) {
       // Twist-shift
-      int rank, np;
-      MPI_Comm_rank(surf.communicator(), &rank);
-      MPI_Comm_size(surf.communicator(), &np);
-      if (rank == 0) {
+      if (surface.first_proc) {
         for (int k = 0; k < nsys; k++) {
-          BoutReal kwave=k*2.0*PI/coord->zlength(); // wave number is 1/[rad]
-          dcomplex phase(cos(kwave*ts) , -sin(kwave*ts));
-          a(k, 0) *= phase;
+          a(k, 0) *= surface.phase[k];
         }
       }
-      if (rank == np - 1) {
+      if (surface.last_proc) {
         for (int k = 0; k < nsys; k++) {
-          BoutReal kwave=k*2.0*PI/coord->zlength(); // wave number is 1/[rad]
-          dcomplex phase(cos(kwave*ts) , sin(kwave*ts));
-          c(k, localmesh->LocalNy - 2 * localmesh->ystart - 1) *= phase;
+          c(k, localmesh->LocalNy - 2 * localmesh->ystart - 1) *= conj(surface.phase[k]);
         }
       }
     } else {
       // Open surface, so may have boundaries
-      if (surf.firstY()) {
+      if (surface.lower_bndry) {
         for (int k = 0; k < nsys; k++) {
           for (int y = 0; y < localmesh->ystart; y++) {
             a(k, y) = 0.;
@@ -204,7 +221,7 @@ const Field3D InvertParCR::solve(const Field3D &f) {
           }
         }
       }
-      if (surf.lastY()) {
+      if (surface.upper_bndry) {
         for (int k = 0; k < nsys; k++) {
           for (int y = size - localmesh->ystart; y < size; y++) {
             a(k, y) = -1.;
@@ -218,8 +235,8 @@ const Field3D InvertParCR::solve(const Field3D &f) {
     }
 
     // Solve cyclic tridiagonal system for each k
-    cr->setCoefs(a, b, c);
-    cr->solve(rhsk, xk);
+    surface.cr->setCoefs(a, b, c);
+    surface.cr->solve(rhsk, xk);
 
     // Put back into rhs array
     for (int k = 0; k < nsys; k++) {
@@ -234,4 +251,3 @@ const Field3D InvertParCR::solve(const Field3D &f) {
 
   return fromFieldAligned(result, "RGN_NOBNDRY");
 }
-
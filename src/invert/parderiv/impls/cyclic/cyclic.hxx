@@ -44,9 +44,13 @@
 
 #include "invert_parderiv.hxx"
 #include "dcomplex.hxx"
+#include <cyclic_reduction.hxx>
 #include <globals.hxx>
 #include "utils.hxx"
 
+#include <memory>
+#include <vector>
+
 class InvertParCR : public InvertPar {
 public:
   InvertParCR(Options *opt, CELL_LOC location = CELL_CENTRE,
@@ -91,6 +95,32 @@ private:
   Field2D sg; // Coefficient of DDY contribution to Grad2_par2
   
   int nsys;
+
+  /// Layout and solver for one flux surface, which don't change
+  /// between solves
+  struct Surface {
+    int xpos;          ///< X index of the surface
+    bool closed;       ///< Periodic in Y?
+    int y0;            ///< Row of the first point on this processor
+    int local_ystart;  ///< First Y index on this processor
+    int size;          ///< Number of rows on this processor
+    bool lower_bndry;  ///< Open surface, and has a lower Y boundary here
+    bool upper_bndry;  ///< Open surface, and has an upper Y boundary here
+    bool first_proc;   ///< Closed surface, and first processor on it
+    bool last_proc;    ///< Closed surface, and last processor on it
+    Array<dcomplex> phase; ///< Twist-shift phase for each mode, if closed
+
+    std::unique_ptr<CyclicReduce<dcomplex>> cr; ///< Solver for this surface
+    Matrix<dcomplex> rhsk, xk; ///< Right hand side and result [nsys, size]
+  };
+  std::vector<Surface> surfaces;
+  bool surfaces_setup{false}; ///< Have surfaces been set up?
+
+  /// Find the surfaces on this processor and create their solvers
+  void setupSurfaces();
+
+  /// Working arrays, sized for the largest surface
+  Matrix<dcomplex> rhs, a, b, c;
 };
 
 
@@ -7,6 +7,7 @@
 #include <bout/assert.hxx>
 #include <bout/constants.hxx>
 #include <bout/coordinates.hxx>
+#include <bout/openmpwrap.hxx>
 #include <msg_stack.hxx>
 #include <output.hxx>
 #include <utils.hxx>
@@ -19,6 +20,8 @@
 
 #include "parallel/fci.hxx"
 
+#include <algorithm>
+
 // use anonymous namespace so this utility function is not available outside this file
 namespace {
 /// Interpolate a Field2D to a new CELL_LOC with interp_to.
@@ -969,6 +972,13 @@ int Coordinates::geometry(bool recalculate_staggered,
     localmesh->recalculateStaggeredCoordinates();
   }
 
+  // Metric has changed, so Delp2 coefficients must be recalculated
+  delp2_a.clear();
+  delp2_b.clear();
+  delp2_c.clear();
+  fv_factors.reset();
+  ++generation;
+
   return 0;
 }
 
@@ -1190,8 +1200,13 @@ void Coordinates::setParallelTransform(Options* options) {
 
     fixZShiftGuards(zShift);
 
+    const bool compact_phases =
+        Options::root()["shiftedmetric"]["compact_phases"]
+            .doc("Store only the shift angle of each parallel slice, computing phases "
+                 "when needed. Saves memory at large nz")
+            .withDefault(false);
     transform = bout::utils::make_unique<ShiftedMetric>(*localmesh, location, zShift,
-        zlength());
+        zlength(), compact_phases);
 
   } else if (ptstr == "fci") {
 
@@ -1366,6 +1381,30 @@ Field2D Coordinates::Delp2(const Field2D& f, CELL_LOC outloc, bool UNUSED(useFFT
   return result;
 }
 
+void Coordinates::calcDelp2Coefs() {
+  TRACE("Coordinates::calcDelp2Coefs");
+
+  const int ny = localmesh->LocalNy;
+  const int nmodes = localmesh->LocalNz / 2 + 1;
+  const int size = localmesh->LocalNx * ny * nmodes;
+
+  delp2_a.reallocate(size);
+  delp2_b.reallocate(size);
+  delp2_c.reallocate(size);
+
+  // Note: should not include y-guard or y-boundary points here as that would
+  // use values from corner cells in dx, which may not be initialised.
+  for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
+    for (int jy = localmesh->ystart; jy <= localmesh->yend; jy++) {
+      for (int jz = 0; jz < nmodes; jz++) {
+        const int ind = (jx * ny + jy) * nmodes + jz;
+        laplace_tridag_coefs(jx, jy, jz, delp2_a[ind], delp2_b[ind], delp2_c[ind],
+                             nullptr, nullptr, location);
+      }
+    }
+  }
+}
+
 Field3D Coordinates::Delp2(const Field3D& f, CELL_LOC outloc, bool useFFT) {
   TRACE("Coordinates::Delp2( Field3D )");
 
@@ -1385,42 +1424,49 @@ Field3D Coordinates::Delp2(const Field3D& f, CELL_LOC outloc, bool useFFT) {
   Field3D result{emptyFrom(f).setLocation(outloc)};
 
   if (useFFT) {
-    int ncz = localmesh->LocalNz;
+    const int ncz = localmesh->LocalNz;
+    const int ny = localmesh->LocalNy;
+    const int nmodes = ncz / 2 + 1;
 
-    // Allocate memory
-    auto ft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
-    auto delft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
-
-    // Loop over y indices
-    // Note: should not include y-guard or y-boundary points here as that would
-    // use values from corner cells in dx, which may not be initialised.
-    for (int jy = localmesh->ystart; jy <= localmesh->yend; jy++) {
-
-      // Take forward FFT
-
-      for (int jx = 0; jx < localmesh->LocalNx; jx++)
-        rfft(&f(jx, jy, 0), ncz, &ft(jx, 0));
+    if (delp2_a.empty()) {
+      calcDelp2Coefs();
+    }
 
-      // Loop over kz
-      for (int jz = 0; jz <= ncz / 2; jz++) {
+    // Every (x, y) line of f is stored one after another, so all of
+    // them can be transformed in one batch. ft and delft are indexed in
+    // the same way as the coefficients
+    Array<dcomplex> ft(localmesh->LocalNx * ny * nmodes);
+    Array<dcomplex> delft(ft.size());
 
-        // No smoothing in the x direction
-        for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
-          // Perform x derivative
+    rfft_many(&f(0, 0, 0), localmesh->LocalNx * ny, ncz, ft.begin());
 
-          dcomplex a, b, c;
-          laplace_tridag_coefs(jx, jy, jz, a, b, c, nullptr, nullptr, outloc);
+    const dcomplex* a = delp2_a.begin();
+    const dcomplex* b = delp2_b.begin();
+    const dcomplex* c = delp2_c.begin();
+    const dcomplex* fk = ft.begin();
+    dcomplex* dk = delft.begin();
+    const int xstride = ny * nmodes;
 
-          delft(jx, jz) = a * ft(jx - 1, jz) + b * ft(jx, jz) + c * ft(jx + 1, jz);
+    // No smoothing in the x direction. Points outside the interior of
+    // y are set to zero, so they are well defined after the inverse FFT
+    BOUT_OMP(parallel for collapse(2))
+    for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
+      for (int jy = 0; jy < ny; jy++) {
+        const int ind0 = (jx * ny + jy) * nmodes;
+        if (jy < localmesh->ystart || jy > localmesh->yend) {
+          std::fill(dk + ind0, dk + ind0 + nmodes, 0.0);
+          continue;
+        }
+        for (int ind = ind0; ind < ind0 + nmodes; ind++) {
+          dk[ind] = a[ind] * fk[ind - xstride] + b[ind] * fk[ind] + c[ind] * fk[ind + xstride];
         }
-      }
-
-      // Reverse FFT
-      for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
-
-        irfft(&delft(jx, 0), ncz, &result(jx, jy, 0));
       }
     }
+
+    // Reverse FFT of the x-interior, which is again one contiguous block
+    const int nlines = (localmesh->xend - localmesh->xstart + 1) * ny;
+    irfft_many(&delft[localmesh->xstart * xstride], nlines, ncz,
+               &result(localmesh->xstart, 0, 0));
   } else {
     result = G1 * ::DDX(f, outloc) + G3 * ::DDZ(f, outloc) + g11 * ::D2DX2(f, outloc)
              + g33 * ::D2DZ2(f, outloc) + 2 * g13 * ::D2DXDZ(f, outloc);
@@ -1453,34 +1499,42 @@ FieldPerp Coordinates::Delp2(const FieldPerp& f, CELL_LOC outloc, bool useFFT) {
   result.setIndex(jy);
 
   if (useFFT) {
-    int ncz = localmesh->LocalNz;
+    const int ncz = localmesh->LocalNz;
+    const int nmodes = ncz / 2 + 1;
+    const bool cached = (jy >= localmesh->ystart) && (jy <= localmesh->yend);
+
+    if (cached && delp2_a.empty()) {
+      calcDelp2Coefs();
+    }
 
     // Allocate memory
-    auto ft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
-    auto delft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
+    auto ft = Matrix<dcomplex>(localmesh->LocalNx, nmodes);
+    auto delft = Matrix<dcomplex>(localmesh->LocalNx, nmodes);
 
     // Take forward FFT
-    for (int jx = 0; jx < localmesh->LocalNx; jx++)
-      rfft(&f(jx, 0), ncz, &ft(jx, 0));
-
-    // Loop over kz
-    for (int jz = 0; jz <= ncz / 2; jz++) {
-
-      // No smoothing in the x direction
-      for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
-        // Perform x derivative
+    rfft_many(&f(0, 0), localmesh->LocalNx, ncz, &ft(0, 0));
 
+    // No smoothing in the x direction
+    for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
+      // Perform x derivative
+      const int ind0 = (jx * localmesh->LocalNy + jy) * nmodes;
+      for (int jz = 0; jz < nmodes; jz++) {
         dcomplex a, b, c;
-        laplace_tridag_coefs(jx, jy, jz, a, b, c);
+        if (cached) {
+          a = delp2_a[ind0 + jz];
+          b = delp2_b[ind0 + jz];
+          c = delp2_c[ind0 + jz];
+        } else {
+          laplace_tridag_coefs(jx, jy, jz, a, b, c, nullptr, nullptr, location);
+        }
 
         delft(jx, jz) = a * ft(jx - 1, jz) + b * ft(jx, jz) + c * ft(jx + 1, jz);
       }
     }
 
     // Reverse FFT
-    for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
-      irfft(&delft(jx, 0), ncz, &result(jx, 0));
-    }
+    const int nlines = localmesh->xend - localmesh->xstart + 1;
+    irfft_many(&delft(localmesh->xstart, 0), nlines, ncz, &result(localmesh->xstart, 0));
 
   } else {
     throw BoutException("Non-fourier Delp2 not currently implented for FieldPerp.");
@@ -1527,3 +1581,78 @@ Field3D Coordinates::Laplace(const Field3D& f, CELL_LOC outloc) {
 
   return result;
 }
+
+const Coordinates::FVFactors& Coordinates::getFVFactors() {
+  if (fv_factors) {
+    return *fv_factors;
+  }
+  TRACE("Coordinates::getFVFactors");
+
+  fv_factors = bout::utils::make_unique<FVFactors>();
+  FVFactors& fv = *fv_factors;
+
+  for (Field2D* f : {&fv.par_upper_c, &fv.par_upper_p, &fv.par_lower_c, &fv.par_lower_m,
+                     &fv.grad_par_upper, &fv.grad_par_lower, &fv.perp_x_flux,
+                     &fv.perp_x_inv_vol, &fv.perp_y_upper_g, &fv.perp_y_upper_dy,
+                     &fv.perp_y_lower_g, &fv.perp_y_lower_dy, &fv.perp_y_coef,
+                     &fv.perp_z_coef, &fv.perp_y_inv_vol}) {
+    *f = zeroFrom(dx);
+  }
+
+  // Div_par calculates in the y guard cells next to processor boundaries
+  // and Div_a_Laplace_perp in the x guard cells either side
+  for (int i = localmesh->xstart - 1; i <= localmesh->xend + 1; i++) {
+    for (int j = localmesh->ystart - 1; j <= localmesh->yend + 1; j++) {
+      const bool x_interior = (i >= localmesh->xstart) && (i <= localmesh->xend);
+      const bool y_interior = (j >= localmesh->ystart) && (j <= localmesh->yend);
+
+      if (x_interior && j > 0 && j < localmesh->LocalNy - 1) {
+        // For right cell boundaries
+        BoutReal common_factor =
+            (J(i, j) + J(i, j + 1)) / (sqrt(g_22(i, j)) + sqrt(g_22(i, j + 1)));
+
+        fv.par_upper_c(i, j) = common_factor / (dy(i, j) * J(i, j));
+        fv.par_upper_p(i, j) = common_factor / (dy(i, j + 1) * J(i, j + 1));
+
+        // For left cell boundaries
+        common_factor =
+            (J(i, j) + J(i, j - 1)) / (sqrt(g_22(i, j)) + sqrt(g_22(i, j - 1)));
+
+        fv.par_lower_c(i, j) = common_factor / (dy(i, j) * J(i, j));
+        fv.par_lower_m(i, j) = common_factor / (dy(i, j - 1) * J(i, j - 1));
+      }
+
+      if (!y_interior) {
+        continue;
+      }
+
+      fv.perp_x_inv_vol(i, j) = 1. / (dx(i, j) * J(i, j));
+      if (i <= localmesh->xend) {
+        fv.perp_x_flux(i, j) = (J(i, j) * g11(i, j) + J(i + 1, j) * g11(i + 1, j))
+                               / (dx(i, j) + dx(i + 1, j));
+      }
+
+      if (!x_interior) {
+        continue;
+      }
+
+      fv.grad_par_upper(i, j) = (J(i, j) + J(i, j + 1)) / (g_22(i, j) + g_22(i, j + 1))
+                                * 2. / (dy(i, j) + dy(i, j + 1)) / (dy(i, j) * J(i, j));
+      fv.grad_par_lower(i, j) = (J(i, j) + J(i, j - 1)) / (g_22(i, j) + g_22(i, j - 1))
+                                * 2. / (dy(i, j) + dy(i, j - 1)) / (dy(i, j) * J(i, j));
+
+      fv.perp_y_upper_g(i, j) = 0.25 * (J(i, j) * g23(i, j) + J(i, j + 1) * g23(i, j + 1));
+      fv.perp_y_upper_dy(i, j) = 2. / (dy(i, j + 1) + dy(i, j));
+      fv.perp_y_lower_g(i, j) = 0.25 * (J(i, j) * g23(i, j) + J(i, j - 1) * g23(i, j - 1));
+      fv.perp_y_lower_dy(i, j) = 2. / (dy(i, j) + dy(i, j - 1));
+      fv.perp_y_coef(i, j) =
+          0.5 * (g_23(i, j) / SQ(J(i, j) * Bxy(i, j))
+                 + g_23(i, j + 1) / SQ(J(i, j + 1) * Bxy(i, j + 1)));
+      fv.perp_z_coef(i, j) =
+          g_23(i, j) / (dy(i, j + 1) + 2. * dy(i, j) + dy(i, j - 1)) / SQ(J(i, j) * Bxy(i, j));
+      fv.perp_y_inv_vol(i, j) = 1. / (dy(i, j) * J(i, j));
+    }
+  }
+
+  return *fv_factors;
+}
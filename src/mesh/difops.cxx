@@ -32,6 +32,7 @@
 #include <fft.hxx>
 #include <msg_stack.hxx>
 #include <bout/assert.hxx>
+#include <bout/zpadded.hxx>
 
 #include <invert_laplace.hxx> // Delp2 uses same coefficients as inversion code
 
@@ -611,65 +612,38 @@ const Field3D bracket(const Field3D &f, const Field2D &g, BRACKET_METHOD method,
     const BoutReal fac = 1.0 / (12 * metric->dz);
     const int ncz = mesh->LocalNz;
 
-    BOUT_FOR(j2D, result.getRegion2D("RGN_NOBNDRY")) {
-      // Get constants for this iteration
-      const BoutReal spacingFactor = fac / metric->dx[j2D];
-      const int jy = j2D.y(), jx = j2D.x();
-      const int xm = jx - 1, xp = jx + 1;
+    BOUT_OMP(parallel) {
+      bout::ZPaddedLine fxm_line(ncz, 1), fc_line(ncz, 1), fxp_line(ncz, 1);
 
-      // Extract relevant Field2D values
-      const BoutReal gxm = g(xm, jy), gc = g(jx, jy), gxp = g(xp, jy);
+      BOUT_FOR_INNER(j2D, result.getRegion2D("RGN_NOBNDRY")) {
+        // Get constants for this iteration
+        const BoutReal spacingFactor = fac / metric->dx[j2D];
+        const int jy = j2D.y(), jx = j2D.x();
+        const int xm = jx - 1, xp = jx + 1;
 
-      // Index Field3D as 2D to get start of z data block
-      const auto fxm = f(xm, jy), fc = f(jx, jy), fxp = f(xp, jy);
+        // Extract relevant Field2D values
+        const BoutReal gxm = g(xm, jy), gc = g(jx, jy), gxp = g(xp, jy);
 
-      // Here we split the loop over z into three parts; the first value, the middle block
-      // and the last value
-      // this is to allow the loop used in the middle block to vectorise.
+        // Copies of the z-lines with periodic guard cells, so that the
+        // loop over z needs no special cases at the ends and can vectorise
+        const BoutReal* fxm = fxm_line.load(f(xm, jy));
+        const BoutReal* fc = fc_line.load(f(jx, jy));
+        const BoutReal* fxp = fxp_line.load(f(xp, jy));
+        BoutReal* res = result(jx, jy);
 
-      // The first value
-      {
-        const int jzp = 1;
-        const int jzm = ncz - 1;
+        for (int jz = 0; jz < ncz; jz++) {
+          const int jzp = jz + 1;
+          const int jzm = jz - 1;
 
-        // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
-        const BoutReal Jpp = 2 * (fc[jzp] - fc[jzm]) * (gxp - gxm);
-
-        // J+x
-        const BoutReal Jpx = gxp * (fxp[jzp] - fxp[jzm]) - gxm * (fxm[jzp] - fxm[jzm]) +
-                             gc * (fxp[jzm] - fxp[jzp] - fxm[jzm] + fxm[jzp]);
-
-        result(jx, jy, 0) = (Jpp + Jpx) * spacingFactor;
-      }
-
-      // The middle block
-      for (int jz = 1; jz < mesh->LocalNz - 1; jz++) {
-        const int jzp = jz + 1;
-        const int jzm = jz - 1;
-
-        // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
-        const BoutReal Jpp = 2 * (fc[jzp] - fc[jzm]) * (gxp - gxm);
-
-        // J+x
-        const BoutReal Jpx = gxp * (fxp[jzp] - fxp[jzm]) - gxm * (fxm[jzp] - fxm[jzm]) +
-                             gc * (fxp[jzm] - fxp[jzp] - fxm[jzm] + fxm[jzp]);
-
-        result(jx, jy, jz) = (Jpp + Jpx) * spacingFactor;
-      }
-
-      // The last value
-      {
-        const int jzp = 0;
-        const int jzm = ncz - 2;
-
-        // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
-        const BoutReal Jpp = 2 * (fc[jzp] - fc[jzm]) * (gxp - gxm);
+          // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
+          const BoutReal Jpp = 2 * (fc[jzp] - fc[jzm]) * (gxp - gxm);
 
-        // J+x
-        const BoutReal Jpx = gxp * (fxp[jzp] - fxp[jzm]) - gxm * (fxm[jzp] - fxm[jzm]) +
-                             gc * (fxp[jzm] - fxp[jzp] - fxm[jzm] + fxm[jzp]);
+          // J+x
+          const BoutReal Jpx = gxp * (fxp[jzp] - fxp[jzm]) - gxm * (fxm[jzp] - fxm[jzm]) +
+                               gc * (fxp[jzm] - fxp[jzp] - fxm[jzm] + fxm[jzp]);
 
-        result(jx, jy, ncz - 1) = (Jpp + Jpx) * spacingFactor;
+          res[jz] = (Jpp + Jpx) * spacingFactor;
+        }
       }
     }
 
@@ -889,86 +863,45 @@ const Field3D bracket(const Field3D &f, const Field3D &g, BRACKET_METHOD method,
     const int ncz = mesh->LocalNz;
     const BoutReal partialFactor = 1.0/(12 * metric->dz);
 
-    // We need to discard const qualifier in order to manipulate
-    // storage array directly
-    Field3D f_temp = f;
-    Field3D g_temp = g;
-
-    BOUT_FOR(j2D, result.getRegion2D("RGN_NOBNDRY")) {
-      const BoutReal spacingFactor = partialFactor / metric->dx[j2D];
-      const int jy = j2D.y(), jx = j2D.x();
-      const int xm = jx - 1, xp = jx + 1;
-
-      const auto Fxm = f_temp(xm, jy), Fx = f_temp(jx, jy), Fxp = f_temp(xp, jy);
-      const auto Gxm = g_temp(xm, jy), Gx = g_temp(jx, jy), Gxp = g_temp(xp, jy);
+    BOUT_OMP(parallel) {
+      bout::ZPaddedLine fxm_line(ncz, 1), fx_line(ncz, 1), fxp_line(ncz, 1);
+      bout::ZPaddedLine gxm_line(ncz, 1), gx_line(ncz, 1), gxp_line(ncz, 1);
+
+      BOUT_FOR_INNER(j2D, result.getRegion2D("RGN_NOBNDRY")) {
+        const BoutReal spacingFactor = partialFactor / metric->dx[j2D];
+        const int jy = j2D.y(), jx = j2D.x();
+        const int xm = jx - 1, xp = jx + 1;
+
+        // Copies of the z-lines with periodic guard cells, so that the
+        // loop over z needs no special cases at the ends and can vectorise
+        const BoutReal* Fxm = fxm_line.load(f(xm, jy));
+        const BoutReal* Fx = fx_line.load(f(jx, jy));
+        const BoutReal* Fxp = fxp_line.load(f(xp, jy));
+        const BoutReal* Gxm = gxm_line.load(g(xm, jy));
+        const BoutReal* Gx = gx_line.load(g(jx, jy));
+        const BoutReal* Gxp = gxp_line.load(g(xp, jy));
+        BoutReal* res = result(jx, jy);
+
+        for (int jz = 0; jz < ncz; jz++) {
+          const int jzp = jz + 1;
+          const int jzm = jz - 1;
 
-      // Here we split the loop over z into three parts; the first value, the middle block
-      // and the last value
-      // this is to allow the loop used in the middle block to vectorise.
-
-      {
-        const int jz = 0;
-        const int jzp = 1;
-        const int jzm = ncz - 1;
-
-        // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
-        const BoutReal Jpp = ((Fx[jzp] - Fx[jzm]) * (Gxp[jz] - Gxm[jz]) -
-                              (Fxp[jz] - Fxm[jz]) * (Gx[jzp] - Gx[jzm]));
-
-        // J+x
-        const BoutReal Jpx =
-            (Gxp[jz] * (Fxp[jzp] - Fxp[jzm]) - Gxm[jz] * (Fxm[jzp] - Fxm[jzm]) -
-             Gx[jzp] * (Fxp[jzp] - Fxm[jzp]) + Gx[jzm] * (Fxp[jzm] - Fxm[jzm]));
-
-        // Jx+
-        const BoutReal Jxp =
-            (Gxp[jzp] * (Fx[jzp] - Fxp[jz]) - Gxm[jzm] * (Fxm[jz] - Fx[jzm]) -
-             Gxm[jzp] * (Fx[jzp] - Fxm[jz]) + Gxp[jzm] * (Fxp[jz] - Fx[jzm]));
-
-        result(jx, jy, jz) = (Jpp + Jpx + Jxp) * spacingFactor;
-      }
-
-      for (int jz = 1; jz < mesh->LocalNz - 1; jz++) {
-        const int jzp = jz + 1;
-        const int jzm = jz - 1;
-
-        // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
-        const BoutReal Jpp = ((Fx[jzp] - Fx[jzm]) * (Gxp[jz] - Gxm[jz]) -
-                              (Fxp[jz] - Fxm[jz]) * (Gx[jzp] - Gx[jzm]));
-
-        // J+x
-        const BoutReal Jpx =
-            (Gxp[jz] * (Fxp[jzp] - Fxp[jzm]) - Gxm[jz] * (Fxm[jzp] - Fxm[jzm]) -
-             Gx[jzp] * (Fxp[jzp] - Fxm[jzp]) + Gx[jzm] * (Fxp[jzm] - Fxm[jzm]));
-
-        // Jx+
-        const BoutReal Jxp =
-            (Gxp[jzp] * (Fx[jzp] - Fxp[jz]) - Gxm[jzm] * (Fxm[jz] - Fx[jzm]) -
-             Gxm[jzp] * (Fx[jzp] - Fxm[jz]) + Gxp[jzm] * (Fxp[jz] - Fx[jzm]));
-
-        result(jx, jy, jz) = (Jpp + Jpx + Jxp) * spacingFactor;
-      }
-
-      {
-        const int jz = ncz - 1;
-        const int jzp = 0;
-        const int jzm = ncz - 2;
-
-        // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
-        const BoutReal Jpp = ((Fx[jzp] - Fx[jzm]) * (Gxp[jz] - Gxm[jz]) -
-                              (Fxp[jz] - Fxm[jz]) * (Gx[jzp] - Gx[jzm]));
+          // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
+          const BoutReal Jpp = ((Fx[jzp] - Fx[jzm]) * (Gxp[jz] - Gxm[jz]) -
+                                (Fxp[jz] - Fxm[jz]) * (Gx[jzp] - Gx[jzm]));
 
-        // J+x
-        const BoutReal Jpx =
-            (Gxp[jz] * (Fxp[jzp] - Fxp[jzm]) - Gxm[jz] * (Fxm[jzp] - Fxm[jzm]) -
-             Gx[jzp] * (Fxp[jzp] - Fxm[jzp]) + Gx[jzm] * (Fxp[jzm] - Fxm[jzm]));
+          // J+x
+          const BoutReal Jpx =
+              (Gxp[jz] * (Fxp[jzp] - Fxp[jzm]) - Gxm[jz] * (Fxm[jzp] - Fxm[jzm]) -
+               Gx[jzp] * (Fxp[jzp] - Fxm[jzp]) + Gx[jzm] * (Fxp[jzm] - Fxm[jzm]));
 
-        // Jx+
-        const BoutReal Jxp =
-            (Gxp[jzp] * (Fx[jzp] - Fxp[jz]) - Gxm[jzm] * (Fxm[jz] - Fx[jzm]) -
-             Gxm[jzp] * (Fx[jzp] - Fxm[jz]) + Gxp[jzm] * (Fxp[jz] - Fx[jzm]));
+          // Jx+
+          const BoutReal Jxp =
+              (Gxp[jzp] * (Fx[jzp] - Fxp[jz]) - Gxm[jzm] * (Fxm[jz] - Fx[jzm]) -
+               Gxm[jzp] * (Fx[jzp] - Fxm[jz]) + Gxp[jzm] * (Fxp[jz] - Fx[jzm]));
 
-        result(jx, jy, jz) = (Jpp + Jpx + Jxp) * spacingFactor;
+          res[jz] = (Jpp + Jpx + Jxp) * spacingFactor;
+        }
       }
     }
 
@@ -1,5 +1,6 @@
 
 #include <bout/fv_ops.hxx>
+#include <bout/openmpwrap.hxx>
 #include <globals.hxx>
 #include <utils.hxx>
 #include <msg_stack.hxx>
@@ -17,6 +18,9 @@ namespace FV {
     Field3D result{zeroFrom(f)};
 
     Coordinates *coord = f.getCoordinates();
+    const auto& fv = coord->getFVFactors();
+
+    const int nz = mesh->LocalNz;
     
     // Flux in x
   
@@ -32,18 +36,31 @@ namespace FV {
       xe -= 1;
     */
 
-    for(int i=xs;i<=xe;i++)
-      for(int j=mesh->ystart;j<=mesh->yend;j++) {
-	for(int k=0;k<mesh->LocalNz;k++) {
-	  // Calculate flux from i to i+1
-	
-	  BoutReal fout = 0.5*(a(i,j,k) + a(i+1,j,k)) * (coord->J(i,j)*coord->g11(i,j) + coord->J(i+1,j)*coord->g11(i+1,j)) *
-	    (f(i+1,j,k) - f(i,j,k))/(coord->dx(i,j) + coord->dx(i+1,j));
-                     
-	  result(i,j,k) += fout / (coord->dx(i,j)*coord->J(i,j));
-	  result(i+1,j,k) -= fout / (coord->dx(i+1,j)*coord->J(i+1,j));
-	}
+    // Each flux is added to cells i and i+1, so loop over x in order
+    // within each y, and in parallel over y
+    BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+    for (int j = mesh->ystart; j <= mesh->yend; j++) {
+      for (int i = xs; i <= xe; i++) {
+        const BoutReal flux_factor = fv.perp_x_flux(i, j);
+        const BoutReal inv_vol_c = fv.perp_x_inv_vol(i, j);
+        const BoutReal inv_vol_p = fv.perp_x_inv_vol(i + 1, j);
+
+        const BoutReal* ac = &a(i, j, 0);
+        const BoutReal* ap = &a(i + 1, j, 0);
+        const BoutReal* fc = &f(i, j, 0);
+        const BoutReal* fp = &f(i + 1, j, 0);
+        BoutReal* rc = &result(i, j, 0);
+        BoutReal* rp = &result(i + 1, j, 0);
+
+        for (int k = 0; k < nz; k++) {
+          // Calculate flux from i to i+1
+          BoutReal fout = 0.5 * (ac[k] + ap[k]) * flux_factor * (fp[k] - fc[k]);
+
+          rc[k] += fout * inv_vol_c;
+          rp[k] -= fout * inv_vol_p;
+        }
       }
+    }
 
 
     // Y and Z fluxes require Y derivatives
@@ -80,48 +97,49 @@ namespace FV {
 
     // Y flux
 
+    BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE) collapse(2))
     for (int i = mesh->xstart; i <= mesh->xend; i++) {
       for (int j = mesh->ystart; j <= mesh->yend; j++) {
 
-        BoutReal coef =
-            0.5 * (coord->g_23(i, j) / SQ(coord->J(i, j) * coord->Bxy(i, j)) +
-                   coord->g_23(i, j + 1) / SQ(coord->J(i, j + 1) * coord->Bxy(i, j + 1)));
-
-        for (int k = 0; k < mesh->LocalNz; k++) {
+        const BoutReal coef = fv.perp_y_coef(i, j);
+        const BoutReal upper_g = fv.perp_y_upper_g(i, j);
+        const BoutReal upper_dy = fv.perp_y_upper_dy(i, j);
+        const BoutReal lower_g = fv.perp_y_lower_g(i, j);
+        const BoutReal lower_dy = fv.perp_y_lower_dy(i, j);
+        const BoutReal inv_vol = fv.perp_y_inv_vol(i, j);
+
+        const BoutReal* f_c = &fc(i, j, 0);
+        const BoutReal* f_up = &fup(i, j + 1, 0);
+        const BoutReal* f_down = &fdown(i, j - 1, 0);
+        const BoutReal* a_c = &ac(i, j, 0);
+        const BoutReal* a_up = &aup(i, j + 1, 0);
+        const BoutReal* a_down = &adown(i, j - 1, 0);
+        BoutReal* res = &yzresult(i, j, 0);
+
+        for (int k = 0; k < nz; k++) {
           // Calculate flux between j and j+1
-          int kp = (k + 1) % mesh->LocalNz;
-          int km = (k - 1 + mesh->LocalNz) % mesh->LocalNz;
+          int kp = (k + 1) % nz;
+          int km = (k - 1 + nz) % nz;
 
           // Calculate Z derivative at y boundary
-          BoutReal dfdz = 0.25 * (fc(i, j, kp) - fc(i, j, km) + fup(i, j + 1, kp) -
-                                  fup(i, j + 1, km)) /
-                          coord->dz;
+          BoutReal dfdz =
+              0.25 * (f_c[kp] - f_c[km] + f_up[kp] - f_up[km]) / coord->dz;
 
           // Y derivative
-          BoutReal dfdy = 2. * (fup(i, j + 1, k) - fc(i, j, k)) /
-                          (coord->dy(i, j + 1) + coord->dy(i, j));
+          BoutReal dfdy = (f_up[k] - f_c[k]) * upper_dy;
 
-          BoutReal fout = 0.25 * (ac(i, j, k) + aup(i, j + 1, k)) * 
-                          (coord->J(i, j) * coord->g23(i, j) +
-                           coord->J(i, j + 1) * coord->g23(i, j + 1)) *
-                          (dfdz - coef * dfdy);
+          BoutReal fout = (a_c[k] + a_up[k]) * upper_g * (dfdz - coef * dfdy);
 
-          yzresult(i, j, k) = fout / (coord->dy(i, j) * coord->J(i, j));
+          res[k] = fout * inv_vol;
 
           // Calculate flux between j and j-1
-          dfdz = 0.25 * (fc(i, j, kp) - fc(i, j, km) + fdown(i, j - 1, kp) -
-                         fdown(i, j - 1, km)) /
-                 coord->dz;
+          dfdz = 0.25 * (f_c[kp] - f_c[km] + f_down[kp] - f_down[km]) / coord->dz;
 
-          dfdy = 2. * (fc(i, j, k) - fdown(i, j - 1, k)) /
-                 (coord->dy(i, j) + coord->dy(i, j - 1));
+          dfdy = (f_c[k] - f_down[k]) * lower_dy;
 
-          fout = 0.25 * (ac(i, j, k) + adown(i, j - 1, k)) * 
-                        (coord->J(i, j) * coord->g23(i, j) +
-                         coord->J(i, j - 1) * coord->g23(i, j - 1)) *
-                 (dfdz - coef * dfdy);
+          fout = (a_c[k] + a_down[k]) * lower_g * (dfdz - coef * dfdy);
 
-          yzresult(i, j, k) -= fout / (coord->dy(i, j) * coord->J(i, j));
+          res[k] -= fout * inv_vol;
         }
       }
     }
@@ -129,29 +147,34 @@ namespace FV {
     // Z flux
     // Easier since all metrics constant in Z
 
+    BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE) collapse(2))
     for (int i = mesh->xstart; i <= mesh->xend; i++) {
       for (int j = mesh->ystart; j <= mesh->yend; j++) {
         // Coefficient in front of df/dy term
-        BoutReal coef = coord->g_23(i, j) / (coord->dy(i, j + 1) + 2. * coord->dy(i, j) +
-                                             coord->dy(i, j - 1)) /
-                        SQ(coord->J(i, j) * coord->Bxy(i, j));
+        const BoutReal coef = fv.perp_z_coef(i, j);
+        const BoutReal g33 = coord->g33(i, j);
+
+        const BoutReal* f_c = &fc(i, j, 0);
+        const BoutReal* f_up = &fup(i, j + 1, 0);
+        const BoutReal* f_down = &fdown(i, j - 1, 0);
+        const BoutReal* a_c = &ac(i, j, 0);
+        BoutReal* res = &yzresult(i, j, 0);
 
-        for (int k = 0; k < mesh->LocalNz; k++) {
+        for (int k = 0; k < nz; k++) {
           // Calculate flux between k and k+1
-          int kp = (k + 1) % mesh->LocalNz;
+          int kp = (k + 1) % nz;
 
-          BoutReal fout = 0.5 * (ac(i, j, k) + ac(i, j, kp)) * coord->g33(i, j) *
+          BoutReal fout = 0.5 * (a_c[k] + a_c[kp]) * g33 *
                           (
                               // df/dz
-                              (fc(i, j, kp) - fc(i, j, k)) / coord->dz
+                              (f_c[kp] - f_c[k]) / coord->dz
 
                               // - g_yz * df/dy / SQ(J*B)
                               -
-                              coef * (fup(i, j + 1, k) + fup(i, j + 1, kp) -
-                                      fdown(i, j - 1, k) - fdown(i, j - 1, kp)));
+                              coef * (f_up[k] + f_up[kp] - f_down[k] - f_down[kp]));
 
-          yzresult(i, j, k) += fout / coord->dz;
-          yzresult(i, j, kp) -= fout / coord->dz;
+          res[k] += fout / coord->dz;
+          res[kp] -= fout / coord->dz;
         }
       }
     }
@@ -186,38 +209,40 @@ namespace FV {
     const auto& fdown = use_parallel_slices ? fin.ydown() : f;
     
     Coordinates *coord = fin.getCoordinates();
+    const auto& fv = coord->getFVFactors();
 
-    BOUT_FOR(i, result.getRegion("RGN_NOBNDRY")) {
-      // Calculate flux at upper surface
-      
-      const auto iyp = i.yp();
-      const auto iym = i.ym();
+    const int nz = mesh->LocalNz;
 
-      if (bndry_flux || !mesh->lastY() || (i.y() != mesh->yend)) {
+    BOUT_FOR(i, coord->J.getRegion("RGN_NOBNDRY")) {
+      const int x = i.x();
+      const int y = i.y();
 
-        BoutReal c = 0.5*(K[i] + Kup[iyp]); // K at the upper boundary
-        BoutReal J = 0.5*(coord->J[i] + coord->J[iyp]); // Jacobian at boundary
-        BoutReal g_22 = 0.5*(coord->g_22[i] + coord->g_22[iyp]);
-        
-        BoutReal gradient = 2.*(fup[iyp] - f[i]) / (coord->dy[i] + coord->dy[iyp]);
-        
-        BoutReal flux = c * J * gradient / g_22;
-            
-        result[i] += flux / (coord->dy[i] * coord->J[i]);
+      const BoutReal* Kc = &K(x, y, 0);
+      const BoutReal* fc = &f(x, y, 0);
+      BoutReal* res = &result(x, y, 0);
+
+      // Calculate flux at upper surface
+      if (bndry_flux || !mesh->lastY() || (y != mesh->yend)) {
+        const BoutReal factor = fv.grad_par_upper[i];
+        const BoutReal* Kp = &Kup(x, y + 1, 0);
+        const BoutReal* fp = &fup(x, y + 1, 0);
+
+        for (int k = 0; k < nz; k++) {
+          BoutReal c = 0.5 * (Kc[k] + Kp[k]); // K at the upper boundary
+          res[k] += c * (fp[k] - fc[k]) * factor;
+        }
       }
-      
+
       // Calculate flux at lower surface
-      if (bndry_flux || !mesh->firstY() || (i.y() != mesh->ystart)) {
-        BoutReal c = 0.5*(K[i] + Kdown[iym]); // K at the lower boundary
-        BoutReal J = 0.5*(coord->J[i] + coord->J[iym]); // Jacobian at boundary
-        
-        BoutReal g_22 = 0.5*(coord->g_22[i] + coord->g_22[iym]);
-        
-        BoutReal gradient = 2.*(f[i] - fdown[iym]) / (coord->dy[i] + coord->dy[iym]);
-        
-        BoutReal flux = c * J * gradient / g_22;
-        
-        result[i] -= flux / (coord->dy[i] * coord->J[i]);
+      if (bndry_flux || !mesh->firstY() || (y != mesh->ystart)) {
+        const BoutReal factor = fv.grad_par_lower[i];
+        const BoutReal* Km = &Kdown(x, y - 1, 0);
+        const BoutReal* fm = &fdown(x, y - 1, 0);
+
+        for (int k = 0; k < nz; k++) {
+          BoutReal c = 0.5 * (Kc[k] + Km[k]); // K at the lower boundary
+          res[k] -= c * (fc[k] - fm[k]) * factor;
+        }
       }
     }
     
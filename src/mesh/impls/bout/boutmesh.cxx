@@ -36,6 +36,7 @@
 #include "boutmesh.hxx"
 
 #include <bout/constants.hxx>
+#include <bout/openmpwrap.hxx>
 #include <bout/sys/timer.hxx>
 #include <boutcomm.hxx>
 #include <boutexception.hxx>
@@ -47,6 +48,8 @@
 #include <output.hxx>
 #include <utils.hxx>
 
+#include <algorithm>
+
 /// MPI type of BoutReal for communications
 #define PVEC_REAL_MPI_TYPE MPI_DOUBLE
 
@@ -69,6 +72,7 @@ If you want the old setting, you have to specify mesh:symmetricGlobalY=false in
 BoutMesh::~BoutMesh() {
   // Delete the communication handles
   clear_handles();
+  clear_plans();
 
   // Delete the boundary regions
   for (const auto &bndry : boundary)
@@ -435,6 +439,11 @@ int BoutMesh::load() {
                    .doc("Whether to use asyncronous MPI sends")
                    .withDefault(false);
 
+  persistent_comms = options["persistent_comms"]
+                         .doc("Reuse communication plans with persistent MPI requests "
+                              "for guard cell exchanges")
+                         .withDefault(false);
+
   // Set global offsets
 
   OffsetX = PE_XIND * MXSUB;
@@ -950,6 +959,37 @@ comm_handle BoutMesh::send(FieldGroup &g) {
   /// Start timer
   Timer timer("comms");
 
+  if (persistent_comms and not g.empty()) {
+    // Use a pre-built plan if one is available
+    CommPlan *plan = get_plan(g);
+    if (plan != nullptr) {
+      CommHandle &ch = plan->handle;
+      ch.var_list = g;
+
+      /// Start receives
+      for (auto &req : ch.request) {
+        if (req != MPI_REQUEST_NULL) {
+          MPI_Start(&req);
+        }
+      }
+
+      /// Pack and start sends
+      for (int i = 0; i < 6; i++) {
+        if (ch.sendreq[i] == MPI_REQUEST_NULL) {
+          continue;
+        }
+        const auto &range = plan->send_range[i];
+        pack_data(ch.var_list.get(), range[0], range[1], range[2], range[3],
+                  plan->send_buffer[i]);
+        MPI_Start(&ch.sendreq[i]);
+      }
+
+      ch.in_progress = true;
+
+      return static_cast<void *>(&ch);
+    }
+  }
+
   /// Work out length of buffer needed
   int xlen = msg_len(g.get(), 0, MXG, 0, MYSUB);
   int ylen = msg_len(g.get(), 0, LocalNx, 0, MYG);
@@ -1122,11 +1162,12 @@ int BoutMesh::wait(comm_handle handle) {
       break;
     }
     }
-    if (ind != MPI_UNDEFINED)
+    // Persistent requests are left inactive, to be restarted by the next send
+    if (ind != MPI_UNDEFINED and not ch->persistent)
       ch->request[ind] = MPI_REQUEST_NULL;
   } while (ind != MPI_UNDEFINED);
 
-  if (async_send) {
+  if (async_send or ch->persistent) {
     /// Asyncronous sending: Need to check if sends have completed (frees MPI memory)
     MPI_Status async_status;
 
@@ -2000,6 +2041,11 @@ BoutMesh::CommHandle *BoutMesh::get_handle(int xlen, int ylen) {
 
 void BoutMesh::free_handle(CommHandle *h) {
   h->var_list.clear();
+  if (h->persistent) {
+    // Owned by a CommPlan, so just mark as available again
+    h->in_progress = false;
+    return;
+  }
   comm_list.push_front(h);
 }
 
@@ -2013,72 +2059,246 @@ void BoutMesh::clear_handles() {
   }
 }
 
+/****************************************************************
+ *                     Communication plans
+ ****************************************************************/
+
+BoutMesh::CommPlan *BoutMesh::get_plan(const FieldGroup &g) {
+  // Message lengths only depend on the number of BoutReals per point
+  // in the 3D and 2D fields
+  int n3d = 0, n2d = 0;
+  for (const auto &var : g) {
+    if (var->is3D()) {
+      n3d += var->BoutRealSize();
+    } else {
+      n2d += var->BoutRealSize();
+    }
+  }
+  const auto key = std::make_pair(n3d, n2d);
+
+  auto existing = comm_plans.find(key);
+  if (existing != comm_plans.end()) {
+    if (existing->second.handle.in_progress) {
+      // Another send with the same shape is still going
+      return nullptr;
+    }
+    return &existing->second;
+  }
+
+  CommPlan &plan = comm_plans[key];
+  CommHandle &ch = plan.handle;
+  const auto &vars = g.get();
+
+  for (int i = 0; i < 6; i++) {
+    ch.request[i] = MPI_REQUEST_NULL;
+    ch.sendreq[i] = MPI_REQUEST_NULL;
+    plan.send_buffer[i] = nullptr;
+  }
+
+  ch.xbufflen = msg_len(vars, 0, MXG, 0, MYSUB);
+  ch.ybufflen = msg_len(vars, 0, LocalNx, 0, MYG);
+
+  if (ch.ybufflen > 0) {
+    ch.umsg_sendbuff.reallocate(ch.ybufflen);
+    ch.dmsg_sendbuff.reallocate(ch.ybufflen);
+    ch.umsg_recvbuff.reallocate(ch.ybufflen);
+    ch.dmsg_recvbuff.reallocate(ch.ybufflen);
+  }
+  if (ch.xbufflen > 0) {
+    ch.imsg_sendbuff.reallocate(ch.xbufflen);
+    ch.omsg_sendbuff.reallocate(ch.xbufflen);
+    ch.imsg_recvbuff.reallocate(ch.xbufflen);
+    ch.omsg_recvbuff.reallocate(ch.xbufflen);
+  }
+
+  ch.persistent = true;
+  ch.in_progress = false;
+
+  /// Receives, with the same layout as post_receive()
+
+  int len = 0;
+  if (UDATA_INDEST != -1) {
+    len = msg_len(vars, 0, UDATA_XSPLIT, 0, MYG);
+    MPI_Recv_init(std::begin(ch.umsg_recvbuff), len, PVEC_REAL_MPI_TYPE, UDATA_INDEST,
+                  IN_SENT_DOWN, BoutComm::get(), &ch.request[0]);
+  }
+  if (UDATA_OUTDEST != -1) {
+    MPI_Recv_init(&ch.umsg_recvbuff[len], msg_len(vars, UDATA_XSPLIT, LocalNx, 0, MYG),
+                  PVEC_REAL_MPI_TYPE, UDATA_OUTDEST, OUT_SENT_DOWN, BoutComm::get(),
+                  &ch.request[1]);
+  }
+
+  len = 0;
+  if (DDATA_INDEST != -1) {
+    len = msg_len(vars, 0, DDATA_XSPLIT, 0, MYG);
+    MPI_Recv_init(std::begin(ch.dmsg_recvbuff), len, PVEC_REAL_MPI_TYPE, DDATA_INDEST,
+                  IN_SENT_UP, BoutComm::get(), &ch.request[2]);
+  }
+  if (DDATA_OUTDEST != -1) {
+    MPI_Recv_init(&ch.dmsg_recvbuff[len], msg_len(vars, DDATA_XSPLIT, LocalNx, 0, MYG),
+                  PVEC_REAL_MPI_TYPE, DDATA_OUTDEST, OUT_SENT_UP, BoutComm::get(),
+                  &ch.request[3]);
+  }
+
+  if (IDATA_DEST != -1) {
+    MPI_Recv_init(std::begin(ch.imsg_recvbuff), msg_len(vars, 0, MXG, 0, MYSUB),
+                  PVEC_REAL_MPI_TYPE, IDATA_DEST, OUT_SENT_IN, BoutComm::get(),
+                  &ch.request[4]);
+  }
+  if (ODATA_DEST != -1) {
+    MPI_Recv_init(std::begin(ch.omsg_recvbuff), msg_len(vars, 0, MXG, 0, MYSUB),
+                  PVEC_REAL_MPI_TYPE, ODATA_DEST, IN_SENT_OUT, BoutComm::get(),
+                  &ch.request[5]);
+  }
+
+  /// Sends, with the same layout as send()
+
+  auto send_init = [&](int index, int dest, int tag, int xge, int xlt, int yge, int ylt,
+                       BoutReal *buffer) {
+    plan.send_range[index] = {{xge, xlt, yge, ylt}};
+    plan.send_buffer[index] = buffer;
+    MPI_Send_init(buffer, msg_len(vars, xge, xlt, yge, ylt), PVEC_REAL_MPI_TYPE, dest,
+                  tag, BoutComm::get(), &ch.sendreq[index]);
+  };
+
+  len = 0;
+  if (UDATA_INDEST != -1) {
+    len = msg_len(vars, 0, UDATA_XSPLIT, MYSUB, MYSUB + MYG);
+    send_init(0, UDATA_INDEST, IN_SENT_UP, 0, UDATA_XSPLIT, MYSUB, MYSUB + MYG,
+              std::begin(ch.umsg_sendbuff));
+  }
+  if (UDATA_OUTDEST != -1) {
+    send_init(1, UDATA_OUTDEST, OUT_SENT_UP, UDATA_XSPLIT, LocalNx, MYSUB, MYSUB + MYG,
+              &ch.umsg_sendbuff[len]);
+  }
+
+  len = 0;
+  if (DDATA_INDEST != -1) {
+    len = msg_len(vars, 0, DDATA_XSPLIT, MYG, 2 * MYG);
+    send_init(2, DDATA_INDEST, IN_SENT_DOWN, 0, DDATA_XSPLIT, MYG, 2 * MYG,
+              std::begin(ch.dmsg_sendbuff));
+  }
+  if (DDATA_OUTDEST != -1) {
+    send_init(3, DDATA_OUTDEST, OUT_SENT_DOWN, DDATA_XSPLIT, LocalNx, MYG, 2 * MYG,
+              &ch.dmsg_sendbuff[len]);
+  }
+
+  if (IDATA_DEST != -1) {
+    send_init(4, IDATA_DEST, IN_SENT_OUT, MXG, 2 * MXG, MYG, MYG + MYSUB,
+              std::begin(ch.imsg_sendbuff));
+  }
+  if (ODATA_DEST != -1) {
+    send_init(5, ODATA_DEST, OUT_SENT_IN, MXSUB, MXSUB + MXG, MYG, MYG + MYSUB,
+              std::begin(ch.omsg_sendbuff));
+  }
+
+  return &plan;
+}
+
+void BoutMesh::clear_plans() {
+  for (auto &it : comm_plans) {
+    CommHandle &ch = it.second.handle;
+    for (int i = 0; i < 6; i++) {
+      if (ch.request[i] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&ch.request[i]);
+      }
+      if (ch.sendreq[i] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&ch.sendreq[i]);
+      }
+    }
+  }
+  comm_plans.clear();
+}
+
 /****************************************************************
  *                   Communication utilities
  ****************************************************************/
 
+namespace {
+/// Start of each variable's data in a buffer holding \p nx by \p ny
+/// points of each of \p var_list, with the total length at the end
+std::vector<int> bufferOffsets(const std::vector<FieldData *> &var_list, int nx, int ny,
+                               int nz) {
+  std::vector<int> offsets(var_list.size() + 1, 0);
+  for (std::size_t i = 0; i < var_list.size(); i++) {
+    offsets[i + 1] = offsets[i] + nx * ny * (var_list[i]->is3D() ? nz : 1);
+  }
+  return offsets;
+}
+} // namespace
+
 int BoutMesh::pack_data(const std::vector<FieldData *> &var_list, int xge, int xlt, int yge,
                         int ylt, BoutReal *buffer) {
 
-  int len = 0;
+  if ((xlt <= xge) or (ylt <= yge)) {
+    return 0;
+  }
 
-  /// Loop over variables
   for (const auto &var : var_list) {
-    if (var->is3D()) {
+    ASSERT2(var->is3D() ? static_cast<Field3D *>(var)->isAllocated()
+                        : static_cast<Field2D *>(var)->isAllocated());
+  }
+
+  const auto offsets = bufferOffsets(var_list, xlt - xge, ylt - yge, LocalNz);
+  const int nvars = static_cast<int>(var_list.size());
+
+  // Data is contiguous in Y and Z for each X, so copy a whole Y-Z
+  // block at a time. Variables are independent, so can be packed in
+  // parallel
+  BOUT_OMP(parallel for if (nvars > 1))
+  for (int i = 0; i < nvars; i++) {
+    BoutReal *out = buffer + offsets[i];
+    if (var_list[i]->is3D()) {
       // 3D variable
-      ASSERT2(static_cast<Field3D *>(var)->isAllocated());
-      auto& var3d_ref = *static_cast<Field3D *>(var);
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++) {
-          for (int jz = 0; jz < LocalNz; jz++, len++) {
-            buffer[len] = var3d_ref(jx, jy, jz);
-          }
-        }
+      const auto &var3d_ref = *static_cast<const Field3D *>(var_list[i]);
+      const int blocksize = (ylt - yge) * LocalNz;
+      for (int jx = xge; jx < xlt; jx++, out += blocksize) {
+        std::copy_n(var3d_ref(jx, yge), blocksize, out);
       }
     } else {
       // 2D variable
-      ASSERT2(static_cast<Field2D *>(var)->isAllocated());
-      auto& var2d_ref = *static_cast<Field2D *>(var);
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++, len++) {
-          buffer[len] = var2d_ref(jx, jy);
-        }
+      const auto &var2d_ref = *static_cast<const Field2D *>(var_list[i]);
+      const int blocksize = ylt - yge;
+      for (int jx = xge; jx < xlt; jx++, out += blocksize) {
+        std::copy_n(&var2d_ref(jx, yge), blocksize, out);
       }
     }
   }
 
-  return (len);
+  return offsets[nvars];
 }
 
 int BoutMesh::unpack_data(const std::vector<FieldData *> &var_list, int xge, int xlt, int yge,
                           int ylt, BoutReal *buffer) {
 
-  int len = 0;
+  if ((xlt <= xge) or (ylt <= yge)) {
+    return 0;
+  }
 
-  /// Loop over variables
-  for (const auto &var : var_list) {
-    if (var->is3D()) {
+  const auto offsets = bufferOffsets(var_list, xlt - xge, ylt - yge, LocalNz);
+  const int nvars = static_cast<int>(var_list.size());
+
+  BOUT_OMP(parallel for if (nvars > 1))
+  for (int i = 0; i < nvars; i++) {
+    const BoutReal *in = buffer + offsets[i];
+    if (var_list[i]->is3D()) {
       // 3D variable
-      auto& var3d_ref = *static_cast<Field3D *>(var);
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++) {
-          for (int jz = 0; jz < LocalNz; jz++, len++) {
-            var3d_ref(jx, jy, jz) = buffer[len];
-          }
-        }
+      auto &var3d_ref = *static_cast<Field3D *>(var_list[i]);
+      const int blocksize = (ylt - yge) * LocalNz;
+      for (int jx = xge; jx < xlt; jx++, in += blocksize) {
+        std::copy_n(in, blocksize, var3d_ref(jx, yge));
       }
     } else {
       // 2D variable
-      auto& var2d_ref = *static_cast<Field2D *>(var);
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++, len++) {
-          var2d_ref(jx, jy) = buffer[len];
-        }
+      auto &var2d_ref = *static_cast<Field2D *>(var_list[i]);
+      const int blocksize = ylt - yge;
+      for (int jx = xge; jx < xlt; jx++, in += blocksize) {
+        std::copy_n(in, blocksize, &var2d_ref(jx, yge));
       }
     }
   }
 
-  return (len);
+  return offsets[nvars];
 }
 
 /****************************************************************
@@ -2680,6 +2900,30 @@ void BoutMesh::outputVars(Datafile &file) {
   file.add(jyseps2_2, "jyseps2_2", false);
   file.add(ny_inner, "ny_inner", false);
 
+  // When processors share files, the processor layout is that of a run
+  // with each block of processors as one processor, so that collect can
+  // read the files
+  using Group = Datafile::Group;
+  file.setGroupValue("NXPE", [](int value, const Group& group) {
+    return value / group.aggregate_x;
+  });
+  file.setGroupValue("PE_XIND", [](int value, const Group& group) {
+    return value / group.aggregate_x;
+  });
+  file.setGroupValue("NYPE", [](int value, const Group& group) {
+    return value / group.aggregate_y;
+  });
+  file.setGroupValue("PE_YIND", [](int value, const Group& group) {
+    return value / group.aggregate_y;
+  });
+  file.setGroupValue("MXSUB", [](int value, const Group& group) {
+    return value * group.aggregate_x;
+  });
+  file.setGroupValue("MYSUB", [](int value, const Group& group) {
+    return value * group.aggregate_y;
+  });
+  file.setGroupValue("MYPE", [](int, const Group& group) { return group.file_index; });
+
   getCoordinates()->outputVars(file);
 
   // Try and save some provenance tracking info that new enough versions of
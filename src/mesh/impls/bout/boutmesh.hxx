@@ -7,7 +7,9 @@
 #include <bout/mesh.hxx>
 #include "unused.hxx"
 
+#include <array>
 #include <list>
+#include <map>
 #include <vector>
 #include <cmath>
 
@@ -262,6 +264,7 @@ private:
   // Communications
 
   bool async_send; ///< Switch to asyncronous sends (ISend, not Send)
+  bool persistent_comms; ///< Reuse pre-built communication plans with persistent requests
 
   /// Communication handle
   /// Used to keep track of communications between send and receive
@@ -282,12 +285,35 @@ private:
     bool in_progress;
     /// List of fields being communicated
     FieldGroup var_list;
+    /// Are the requests persistent, owned by a CommPlan?
+    bool persistent{false};
   };
   void free_handle(CommHandle* h);
   CommHandle* get_handle(int xlen, int ylen);
   void clear_handles();
   std::list<CommHandle*> comm_list; // List of allocated communication handles
 
+  /// A pre-built communication for groups of fields with the same
+  /// shape. The buffers, message lengths and neighbours are fixed, so
+  /// the receives and sends are created once with MPI_Recv_init and
+  /// MPI_Send_init, and each communication only needs to pack the
+  /// data and start the requests
+  struct CommPlan {
+    /// Buffers and persistent requests
+    CommHandle handle;
+    /// Region packed into each send buffer, as {xge, xlt, yge, ylt}
+    std::array<std::array<int, 4>, 6> send_range;
+    /// Start of each send buffer
+    std::array<BoutReal*, 6> send_buffer;
+  };
+  /// Get the plan for communicating \p g, creating it if needed.
+  /// Returns nullptr if the matching plan is already in use
+  CommPlan* get_plan(const FieldGroup& g);
+  void clear_plans();
+  /// Communication plans, indexed by the number of BoutReals per
+  /// point in the 3D and 2D fields being communicated
+  std::map<std::pair<int, int>, CommPlan> comm_plans;
+
   //////////////////////////////////////////////////
   // X communicator
 
@@ -439,32 +439,40 @@ public:
       kfilter = ncz / 2;
     const int kmax = ncz / 2 - kfilter; // Up to and including this wavenumber index
 
+    const int nmodes = ncz / 2 + 1;
+
     BOUT_OMP(parallel) {
-      Array<dcomplex> cv(ncz / 2 + 1);
+      Array<dcomplex> cv(nmodes);
       const BoutReal kwaveFac = TWOPI / ncz;
 
       // Note we lookup a 2D region here even though we're operating on a Field3D
-      // as we only want to loop over {x, y} and then handle z differently. The
-      // Region<Ind2D> blocks are constructed for elements contiguous assuming nz=1,
-      // as that isn't the case for Field3D (in general) this shouldn't be expected
-      // to vectorise (not that it would anyway) but it should still OpenMP parallelise
-      // ok.
-      // With this in mind we could perhaps avoid the use of the BOUT_FOR_INNER macro
-      // here,
-      // but should be ok for now.
-      BOUT_FOR_INNER(i, theMesh->getRegion2D(region)) {
-        auto i3D = theMesh->ind2Dto3D(i, 0);
-        rfft(&var[i3D], ncz, cv.begin()); // Forward FFT
-
-        for (int jz = 0; jz <= kmax; jz++) {
-          const BoutReal kwave = jz * kwaveFac; // wave number is 1/[rad]
-          cv[jz] *= dcomplex(0, kwave);
+      // as we only want to loop over {x, y} and then handle z differently. Each
+      // block of the Region<Ind2D> is a run of consecutive {x, y} indices, and so
+      // a contiguous set of z-lines in the Field3D, which can be transformed
+      // together in one batched FFT.
+      const auto& blocks = theMesh->getRegion2D(region).getBlocks();
+      BOUT_OMP(for schedule(OPENMP_SCHEDULE) nowait)
+      for (auto block = blocks.cbegin(); block < blocks.cend(); ++block) {
+        const int nlines = block->second.ind - block->first.ind;
+        const auto i3D = theMesh->ind2Dto3D(block->first, 0);
+
+        if (cv.size() != nlines * nmodes) {
+          cv.reallocate(nlines * nmodes);
         }
-        for (int jz = kmax + 1; jz <= ncz / 2; jz++) {
-          cv[jz] = 0.0;
+        rfft_many(&var[i3D], nlines, ncz, cv.begin()); // Forward FFT
+
+        for (int line = 0; line < nlines; line++) {
+          dcomplex* lineModes = cv.begin() + line * nmodes;
+          for (int jz = 0; jz <= kmax; jz++) {
+            const BoutReal kwave = jz * kwaveFac; // wave number is 1/[rad]
+            lineModes[jz] *= dcomplex(0, kwave);
+          }
+          for (int jz = kmax + 1; jz < nmodes; jz++) {
+            lineModes[jz] = 0.0;
+          }
         }
 
-        irfft(cv.begin(), ncz, &result[i3D]); // Reverse FFT
+        irfft_many(cv.begin(), nlines, ncz, &result[i3D]); // Reverse FFT
       }
     }
   }
@@ -499,32 +507,40 @@ public:
     const int ncz = theMesh->getNpoints(direction);
     const int kmax = ncz / 2;
 
+    const int nmodes = ncz / 2 + 1;
+
     BOUT_OMP(parallel) {
-      Array<dcomplex> cv(ncz / 2 + 1);
+      Array<dcomplex> cv(nmodes);
       const BoutReal kwaveFac = TWOPI / ncz;
 
       // Note we lookup a 2D region here even though we're operating on a Field3D
-      // as we only want to loop over {x, y} and then handle z differently. The
-      // Region<Ind2D> blocks are constructed for elements contiguous assuming nz=1,
-      // as that isn't the case for Field3D (in general) this shouldn't be expected
-      // to vectorise (not that it would anyway) but it should still OpenMP parallelise
-      // ok.
-      // With this in mind we could perhaps avoid the use of the BOUT_FOR_INNER macro
-      // here,
-      // but should be ok for now.
-      BOUT_FOR_INNER(i, theMesh->getRegion2D(region)) {
-        auto i3D = theMesh->ind2Dto3D(i, 0);
-        rfft(&var[i3D], ncz, cv.begin()); // Forward FFT
-
-        for (int jz = 0; jz <= kmax; jz++) {
-          const BoutReal kwave = jz * kwaveFac; // wave number is 1/[rad]
-          cv[jz] *= -kwave * kwave;
+      // as we only want to loop over {x, y} and then handle z differently. Each
+      // block of the Region<Ind2D> is a run of consecutive {x, y} indices, and so
+      // a contiguous set of z-lines in the Field3D, which can be transformed
+      // together in one batched FFT.
+      const auto& blocks = theMesh->getRegion2D(region).getBlocks();
+      BOUT_OMP(for schedule(OPENMP_SCHEDULE) nowait)
+      for (auto block = blocks.cbegin(); block < blocks.cend(); ++block) {
+        const int nlines = block->second.ind - block->first.ind;
+        const auto i3D = theMesh->ind2Dto3D(block->first, 0);
+
+        if (cv.size() != nlines * nmodes) {
+          cv.reallocate(nlines * nmodes);
         }
-        for (int jz = kmax + 1; jz <= ncz / 2; jz++) {
-          cv[jz] = 0.0;
+        rfft_many(&var[i3D], nlines, ncz, cv.begin()); // Forward FFT
+
+        for (int line = 0; line < nlines; line++) {
+          dcomplex* lineModes = cv.begin() + line * nmodes;
+          for (int jz = 0; jz <= kmax; jz++) {
+            const BoutReal kwave = jz * kwaveFac; // wave number is 1/[rad]
+            lineModes[jz] *= -kwave * kwave;
+          }
+          for (int jz = kmax + 1; jz < nmodes; jz++) {
+            lineModes[jz] = 0.0;
+          }
         }
 
-        irfft(cv.begin(), ncz, &result[i3D]); // Reverse FFT
+        irfft_many(cv.begin(), nlines, ncz, &result[i3D]); // Reverse FFT
       }
     }
   }
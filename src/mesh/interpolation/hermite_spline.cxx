@@ -24,7 +24,9 @@
 #include "interpolation.hxx"
 #include "bout/index_derivs_interface.hxx"
 #include "bout/mesh.hxx"
+#include "bout/openmpwrap.hxx"
 
+#include <algorithm>
 #include <vector>
 
 HermiteSpline::HermiteSpline(int y_offset, Mesh *mesh)
@@ -51,6 +53,8 @@ void HermiteSpline::calcWeights(const Field3D &delta_x, const Field3D &delta_z)
 
   BoutReal t_x, t_z;
 
+  stencil_compiled = false;
+
   for (int x = localmesh->xstart; x <= localmesh->xend; x++) {
     for (int y = localmesh->ystart; y <= localmesh->yend; y++) {
       for (int z = 0; z < localmesh->LocalNz; z++) {
@@ -112,68 +116,167 @@ void HermiteSpline::calcWeights(const Field3D &delta_x, const Field3D &delta_z,
   calcWeights(delta_x, delta_z);
 }
 
-Field3D HermiteSpline::interpolate(const Field3D &f) const {
+void HermiteSpline::compileStencil() const {
+  const int ny = localmesh->LocalNy;
+  const int nz = localmesh->LocalNz;
 
-  ASSERT1(f.getMesh() == localmesh);
-  Field3D f_interp{emptyFrom(f)};
+  // Count the points to be interpolated
+  int npoints = 0;
+  for (int x = localmesh->xstart; x <= localmesh->xend; x++) {
+    for (int y = localmesh->ystart; y <= localmesh->yend; y++) {
+      for (int z = 0; z < nz; z++) {
+        if (!skip_mask(x, y, z)) {
+          npoints++;
+        }
+      }
+    }
+  }
 
-  // Derivatives are used for tension and need to be on dimensionless
-  // coordinates
-  Field3D fx = bout::derivatives::index::DDX(f, CELL_DEFAULT, "DEFAULT");
-  localmesh->communicateXZ(fx);
-  Field3D fz = bout::derivatives::index::DDZ(f, CELL_DEFAULT, "DEFAULT", "RGN_ALL");
-  localmesh->communicateXZ(fz);
-  Field3D fxz = bout::derivatives::index::DDX(fz, CELL_DEFAULT, "DEFAULT");
-  localmesh->communicateXZ(fxz);
+  stencil_target.reallocate(npoints);
+  stencil_source.reallocate(npoints);
+  stencil_source_zp.reallocate(npoints);
+  stencil_weights.reallocate(16 * npoints);
 
+  int p = 0;
   for (int x = localmesh->xstart; x <= localmesh->xend; x++) {
     for (int y = localmesh->ystart; y <= localmesh->yend; y++) {
-      for (int z = 0; z < localmesh->LocalNz; z++) {
+      for (int z = 0; z < nz; z++) {
 
         if (skip_mask(x, y, z))
           continue;
 
         // Due to lack of guard cells in z-direction, we need to ensure z-index
         // wraps around
-        int ncz = localmesh->LocalNz;
-        int z_mod = ((k_corner(x, y, z) % ncz) + ncz) % ncz;
-        int z_mod_p1 = (z_mod + 1) % ncz;
-
-        int y_next = y + y_offset;
-
-        // Interpolate f in X at Z
-        BoutReal f_z = f(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z) +
-                       f(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z) +
-                       fx(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z) +
-                       fx(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
-
-        // Interpolate f in X at Z+1
-        BoutReal f_zp1 = f(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z) +
-                         f(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z) +
-                         fx(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z) +
-                         fx(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
-
-        // Interpolate fz in X at Z
-        BoutReal fz_z = fz(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z) +
-                        fz(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z) +
-                        fxz(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z) +
-                        fxz(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
-
-        // Interpolate fz in X at Z+1
-        BoutReal fz_zp1 = fz(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z) +
-                          fz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z) +
-                          fxz(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z) +
-                          fxz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
-
-        // Interpolate in Z
-        f_interp(x, y_next, z) = +f_z * h00_z(x, y, z) + f_zp1 * h01_z(x, y, z) +
-                                 fz_z * h10_z(x, y, z) + fz_zp1 * h11_z(x, y, z);
-
-        ASSERT2(finite(f_interp(x, y_next, z)));
+        const int z_mod = ((k_corner(x, y, z) % nz) + nz) % nz;
+        const int z_mod_p1 = (z_mod + 1) % nz;
+
+        const int y_next = y + y_offset;
+
+        stencil_target[p] = (x * ny + y_next) * nz + z;
+        stencil_source[p] = (i_corner(x, y, z) * ny + y_next) * nz + z_mod;
+        stencil_source_zp[p] = (i_corner(x, y, z) * ny + y_next) * nz + z_mod_p1;
+
+        // Basis functions in x for the value and the derivative in x
+        const BoutReal hx[4] = {h00_x(x, y, z), h01_x(x, y, z), h10_x(x, y, z),
+                                h11_x(x, y, z)};
+        // Basis functions in z for the values at the two z points, and the
+        // derivatives in z
+        const BoutReal hz[4] = {h00_z(x, y, z), h01_z(x, y, z), h10_z(x, y, z),
+                                h11_z(x, y, z)};
+
+        // f, df/dx, df/dz, d2f/dxdz: which x and z basis functions weight each
+        const int x_basis[4] = {0, 2, 0, 2};
+        const int z_basis[4] = {0, 0, 2, 2};
+
+        for (int d = 0; d < 4; d++) {
+          BoutReal* w = &stencil_weights[4 * d * npoints + p];
+          w[0] = hx[x_basis[d]] * hz[z_basis[d]];
+          w[npoints] = hx[x_basis[d] + 1] * hz[z_basis[d]];
+          w[2 * npoints] = hx[x_basis[d]] * hz[z_basis[d] + 1];
+          w[3 * npoints] = hx[x_basis[d] + 1] * hz[z_basis[d] + 1];
+        }
+        p++;
       }
     }
   }
-  return f_interp;
+
+  stencil_compiled = true;
+}
+
+Field3D HermiteSpline::interpolate(const Field3D &f) const {
+  return interpolateMany({&f}).front();
+}
+
+std::vector<Field3D>
+HermiteSpline::interpolateMany(const std::vector<const Field3D*>& fields) const {
+
+  if (!stencil_compiled) {
+    compileStencil();
+  }
+
+  const std::size_t nfields = fields.size();
+
+  // Derivatives are used for tension and need to be on dimensionless
+  // coordinates. The derivatives of all the fields are communicated together
+  std::vector<Field3D> fx, fz, fxz;
+  fx.reserve(nfields);
+  fz.reserve(nfields);
+  fxz.reserve(nfields);
+
+  for (const auto* f : fields) {
+    ASSERT1(f->getMesh() == localmesh);
+    fx.push_back(bout::derivatives::index::DDX(*f, CELL_DEFAULT, "DEFAULT"));
+    fz.push_back(bout::derivatives::index::DDZ(*f, CELL_DEFAULT, "DEFAULT", "RGN_ALL"));
+  }
+  FieldGroup first_derivs;
+  for (std::size_t n = 0; n < nfields; n++) {
+    first_derivs.add(fx[n], fz[n]);
+  }
+  localmesh->communicateXZ(first_derivs);
+
+  for (std::size_t n = 0; n < nfields; n++) {
+    fxz.push_back(bout::derivatives::index::DDX(fz[n], CELL_DEFAULT, "DEFAULT"));
+  }
+  FieldGroup cross_derivs;
+  for (auto& d : fxz) {
+    cross_derivs.add(d);
+  }
+  localmesh->communicateXZ(cross_derivs);
+
+  std::vector<Field3D> result;
+  result.reserve(nfields);
+  for (const auto* f : fields) {
+    result.emplace_back(emptyFrom(*f));
+  }
+
+  const int npoints = stencil_target.size();
+  // Offset of the next point in x
+  const int x_stride = localmesh->LocalNy * localmesh->LocalNz;
+
+  const int* target = stencil_target.begin();
+  const int* source = stencil_source.begin();
+  const int* source_zp = stencil_source_zp.begin();
+  const BoutReal* weights = stencil_weights.begin();
+
+  // Points are done in blocks, so that each block of stencils is
+  // still in cache when it is applied to the next field
+  constexpr int block_size = 256;
+
+  BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+  for (int start = 0; start < npoints; start += block_size) {
+    const int end = std::min(start + block_size, npoints);
+
+    for (std::size_t n = 0; n < nfields; n++) {
+      const BoutReal* values[4] = {&(*fields[n])(0, 0, 0), &fx[n](0, 0, 0),
+                                   &fz[n](0, 0, 0), &fxz[n](0, 0, 0)};
+      BoutReal* out = &result[n](0, 0, 0);
+
+      for (int p = start; p < end; p++) {
+        BoutReal value = 0.0;
+        for (int d = 0; d < 4; d++) {
+          const BoutReal* v = values[d];
+          const BoutReal* w = weights + 4 * d * npoints;
+          value += w[p] * v[source[p]] + w[npoints + p] * v[source[p] + x_stride]
+                   + w[2 * npoints + p] * v[source_zp[p]]
+                   + w[3 * npoints + p] * v[source_zp[p] + x_stride];
+        }
+        out[target[p]] = value;
+      }
+    }
+  }
+
+#if CHECK > 1
+  for (std::size_t n = 0; n < nfields; n++) {
+    const BoutReal* out = &result[n](0, 0, 0);
+    for (int p = 0; p < npoints; p++) {
+      if (!finite(out[target[p]])) {
+        throw BoutException("Non-finite value in HermiteSpline interpolation");
+      }
+    }
+  }
+#endif
+
+  return result;
 }
 
 Field3D HermiteSpline::interpolate(const Field3D& f, const Field3D &delta_x, const Field3D &delta_z) {
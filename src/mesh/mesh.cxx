@@ -6,6 +6,7 @@
 #include <derivs.hxx>
 #include <msg_stack.hxx>
 
+#include <algorithm>
 #include <cmath>
 
 #include "meshfactory.hxx"
@@ -29,6 +30,7 @@ Mesh::Mesh(GridDataSource *s, Options* opt) : source(s), options(opt) {
   /// Get mesh options
   OPTION(options, StaggerGrids,   false); // Stagger grids
   OPTION(options, maxregionblocksize, MAXREGIONBLOCKSIZE);
+  OPTION(options, regiontiley, 8);
   OPTION(options, calcParallelSlices_on_communicate, true);
   // Initialise derivatives
   derivs_init(options);  // in index_derivs.cxx for now
@@ -247,16 +249,41 @@ void Mesh::communicateXZ(FieldGroup &g) {
 void Mesh::communicate(FieldGroup &g) {
   TRACE("Mesh::communicate(FieldGroup&)");
 
+  finishCommunicate(g, startCommunicate(g));
+}
+
+comm_handle Mesh::startCommunicate(FieldGroup &g) {
+  TRACE("Mesh::startCommunicate(FieldGroup&)");
+
   // Send data
-  comm_handle h = send(g);
+  return send(g);
+}
+
+void Mesh::finishCommunicate(FieldGroup &g, comm_handle handle) {
+  TRACE("Mesh::finishCommunicate(FieldGroup&, comm_handle)");
 
   // Wait for data from other processors
-  wait(h);
+  wait(handle);
 
-  // Calculate yup and ydown fields for 3D fields
+  // Calculate yup and ydown fields for 3D fields. Fields sharing a
+  // parallel transform are passed together, so the transform can
+  // share work between them
   if (calcParallelSlices_on_communicate) {
-    for(const auto& fptr : g.field3d()) {
-      fptr->calcParallelSlices();
+    std::vector<std::pair<ParallelTransform*, std::vector<Field3D*>>> by_transform;
+    for (const auto& fptr : g.field3d()) {
+      auto* transform = &(fptr->getCoordinates()->getParallelTransform());
+      auto group = std::find_if(by_transform.begin(), by_transform.end(),
+                                [transform](const decltype(by_transform)::value_type& t) {
+                                  return t.first == transform;
+                                });
+      if (group == by_transform.end()) {
+        by_transform.emplace_back(transform, std::vector<Field3D*>{fptr});
+      } else {
+        group->second.push_back(fptr);
+      }
+    }
+    for (const auto& group : by_transform) {
+      group.first->calcParallelSlicesMany(group.second);
     }
   }
 }
@@ -464,6 +491,14 @@ void Mesh::createDefaultRegions(){
   addRegion3D("RGN_NOCORNERS",
       (getRegion3D("RGN_NOBNDRY") + getRegion3D("RGN_XGUARDS") +
         getRegion3D("RGN_YGUARDS") + getRegion3D("RGN_ZGUARDS")).unique());
+  // Points whose stencils (up to the guard cell width) don't use the
+  // guard cells, and the remainder of RGN_NOBNDRY which does
+  addRegion3D("RGN_INTERIOR", Region<Ind3D>(2 * xstart, xend - xstart, 2 * ystart,
+                                            yend - ystart, zstart, zend, LocalNy, LocalNz,
+                                            maxregionblocksize));
+  addRegion3D("RGN_SHELL", mask(getRegion3D("RGN_NOBNDRY"), getRegion3D("RGN_INTERIOR")));
+  // RGN_NOBNDRY in tiles of y, for loops with stencils in x
+  addRegion3D("RGN_NOBNDRY_TILED", getRegion3D("RGN_NOBNDRY").asTiled(regiontiley));
 
   //2D regions
   addRegion2D("RGN_ALL", Region<Ind2D>(0, LocalNx - 1, 0, LocalNy - 1, 0, 0, LocalNy, 1,
@@ -492,6 +527,10 @@ void Mesh::createDefaultRegions(){
   addRegion2D("RGN_NOCORNERS",
       (getRegion2D("RGN_NOBNDRY") + getRegion2D("RGN_XGUARDS") +
         getRegion2D("RGN_YGUARDS") + getRegion2D("RGN_ZGUARDS")).unique());
+  addRegion2D("RGN_INTERIOR", Region<Ind2D>(2 * xstart, xend - xstart, 2 * ystart,
+                                            yend - ystart, 0, 0, LocalNy, 1,
+                                            maxregionblocksize));
+  addRegion2D("RGN_SHELL", mask(getRegion2D("RGN_NOBNDRY"), getRegion2D("RGN_INTERIOR")));
 
   // Perp regions
   addRegionPerp("RGN_ALL", Region<IndPerp>(0, LocalNx - 1, 0, 0, 0, LocalNz - 1, 1,
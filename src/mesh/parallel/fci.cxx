@@ -353,6 +353,30 @@ void FCITransform::calcParallelSlices(Field3D& f) {
   }
 }
 
+void FCITransform::calcParallelSlicesMany(const std::vector<Field3D*>& fields) {
+  TRACE("FCITransform::calcParallelSlicesMany");
+
+  std::vector<const Field3D*> inputs;
+  inputs.reserve(fields.size());
+  for (auto* f : fields) {
+    ASSERT1(f->getDirectionY() == YDirectionType::Standard);
+    ASSERT1(f->getLocation() == CELL_CENTRE);
+
+    // Ensure that yup and ydown are different fields
+    f->splitParallelSlices();
+    inputs.push_back(f);
+  }
+
+  // Interpolate all the fields onto each of the yup and ydown fields
+  // together, so they can share the interpolation weights
+  for (const auto& map : field_line_maps) {
+    auto slices = map.interpolateMany(inputs);
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+      fields[i]->ynext(map.offset) = std::move(slices[i]);
+    }
+  }
+}
+
 void FCITransform::integrateParallelSlices(Field3D& f) {
   TRACE("FCITransform::integrateParallelSlices");
 
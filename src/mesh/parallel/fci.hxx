@@ -62,6 +62,10 @@ public:
     return interp->interpolate(f);
   }
 
+  std::vector<Field3D> interpolateMany(const std::vector<const Field3D*>& fields) const {
+    return interp->interpolateMany(fields);
+  }
+
   Field3D integrate(Field3D &f) const;
 };
 
@@ -90,6 +94,8 @@ public:
   }
 
   void calcParallelSlices(Field3D &f) override;
+
+  void calcParallelSlicesMany(const std::vector<Field3D*>& fields) override;
   
   void integrateParallelSlices(Field3D &f) override;
   
@@ -16,9 +16,9 @@
 #include <output.hxx>
 
 ShiftedMetric::ShiftedMetric(Mesh& m, CELL_LOC location_in, Field2D zShift_,
-    BoutReal zlength_in)
+    BoutReal zlength_in, bool compact_phases_in)
     : ParallelTransform(m), location(location_in), zShift(std::move(zShift_)),
-      zlength(zlength_in) {
+      zlength(zlength_in), compact_phases(compact_phases_in) {
   ASSERT1(zShift.getLocation() == location);
   // check the coordinate system used for the grid data source
   ShiftedMetric::checkInputGrid();
@@ -85,19 +85,19 @@ void ShiftedMetric::cachePhases() {
   // stores its phase and offset, so we don't need to faff about after
   // this
   for (int i = 0; i < mesh.ystart; ++i) {
-    // NOTE: std::vector constructor here takes a **copy** of the
-    // Array! We *must* call `Array::ensureUnique` on each element
-    // before using it!
-    parallel_slice_phases[i].phase_shift =
-        Tensor<dcomplex>(mesh.LocalNx, mesh.LocalNy, nmodes);
     parallel_slice_phases[i].y_offset = i + 1;
 
     // Backwards parallel slices
-    parallel_slice_phases[mesh.ystart + i].phase_shift =
-        Tensor<dcomplex>(mesh.LocalNx, mesh.LocalNy, nmodes);
     parallel_slice_phases[mesh.ystart + i].y_offset = -(i + 1);
   }
 
+  for (auto& slice : parallel_slice_phases) {
+    slice.shift_angle = Matrix<BoutReal>(mesh.LocalNx, mesh.LocalNy);
+    if (not compact_phases) {
+      slice.phase_shift = Tensor<dcomplex>(mesh.LocalNx, mesh.LocalNy, nmodes);
+    }
+  }
+
   // Parallel slice phases -- note we don't shift in the boundaries/guards
   for (auto& slice : parallel_slice_phases) {
     BOUT_FOR(i, mesh.getRegion2D("RGN_NOY")) {
@@ -106,6 +106,12 @@ void ShiftedMetric::cachePhases() {
       int iy = i.y();
       BoutReal slice_shift = zShift[i] - zShift[i.yp(slice.y_offset)];
 
+      slice.shift_angle(ix, iy) = slice_shift;
+
+      if (compact_phases) {
+        continue;
+      }
+
       for (int jz = 0; jz < nmodes; jz++) {
         // wave number is 1/[rad]
         BoutReal kwave = jz * 2.0 * PI / zlength;
@@ -212,24 +218,89 @@ void ShiftedMetric::shiftZ(const BoutReal* in, const dcomplex* phs, BoutReal* ou
   irfft(&cmplx[0], mesh.LocalNz, out); // Reverse FFT
 }
 
-void ShiftedMetric::calcParallelSlices(Field3D& f) {
-  if (f.getDirectionY() == YDirectionType::Aligned) {
-    // Cannot calculate parallel slices for field-aligned fields, so return without
-    // setting yup or ydown
+void ShiftedMetric::shiftSliceModes(const ParallelSlicePhase& phase, int ix, int iy,
+                                    const dcomplex* in, dcomplex* out) const {
+  out[0] = in[0];
+
+  if (not compact_phases) {
+    for (int jz = 1; jz < nmodes; jz++) {
+      out[jz] = in[jz] * phase.phase_shift(ix, iy, jz);
+    }
     return;
   }
 
-  f.splitParallelSlices();
+  // Phase of mode jz is the jz-th power of the phase of the first mode
+  const BoutReal kwave = 2.0 * PI / zlength;
+  const BoutReal angle = kwave * phase.shift_angle(ix, iy);
+  const dcomplex phase_one{cos(angle), -sin(angle)};
+  dcomplex phase_jz = phase_one;
+  for (int jz = 1; jz < nmodes; jz++) {
+    out[jz] = in[jz] * phase_jz;
+    phase_jz *= phase_one;
+  }
+}
 
-  for (const auto& phase : parallel_slice_phases) {
-    auto& f_slice = f.ynext(phase.y_offset);
-    f_slice.allocate();
-    BOUT_FOR(i, mesh.getRegion2D("RGN_NOY")) {
-      const int ix = i.x();
-      const int iy = i.y();
-      const int iy_offset = iy + phase.y_offset;
-      shiftZ(&(f(ix, iy_offset, 0)), &(phase.phase_shift(ix, iy, 0)),
-             &(f_slice(ix, iy_offset, 0)));
+void ShiftedMetric::calcParallelSlices(Field3D& f) {
+  calcParallelSlicesMany({&f});
+}
+
+void ShiftedMetric::calcParallelSlicesMany(const std::vector<Field3D*>& fields) {
+  std::vector<Field3D*> to_shift;
+  to_shift.reserve(fields.size());
+
+  for (auto* f : fields) {
+    ASSERT1(f->getMesh() == &mesh);
+    ASSERT1(f->getLocation() == location);
+
+    if (f->getDirectionY() == YDirectionType::Aligned) {
+      // Cannot calculate parallel slices for field-aligned fields, so skip without
+      // setting yup or ydown
+      continue;
+    }
+
+    f->splitParallelSlices();
+    for (const auto& phase : parallel_slice_phases) {
+      f->ynext(phase.y_offset).allocate();
+    }
+    to_shift.push_back(f);
+  }
+
+  if (to_shift.empty() or parallel_slice_phases.empty()) {
+    return;
+  }
+
+  const int nfields = static_cast<int>(to_shift.size());
+  const int nx = mesh.LocalNx;
+  const int ny = mesh.LocalNy;
+  const int nz = mesh.LocalNz;
+  // Number of y points shifted into each slice -- we don't shift in the
+  // boundaries/guards
+  const int nlines = mesh.yend - mesh.ystart + 1;
+
+  BOUT_OMP(parallel) {
+    // Modes of every Z line at one x, and of the lines shifted to one slice
+    Array<dcomplex> line_modes(ny * nmodes);
+    Array<dcomplex> slice_modes(nlines * nmodes);
+
+    // Z lines at fixed x are contiguous in memory, so each (field, x)
+    // pair is one batch of forward transforms, and one batch of inverse
+    // transforms per slice
+    BOUT_OMP(for schedule(OPENMP_SCHEDULE))
+    for (int ifx = 0; ifx < nfields * nx; ifx++) {
+      Field3D& f = *to_shift[ifx / nx];
+      const int ix = ifx % nx;
+
+      rfft_many(&f(ix, 0, 0), ny, nz, line_modes.begin());
+
+      for (const auto& phase : parallel_slice_phases) {
+        for (int iy = mesh.ystart; iy <= mesh.yend; iy++) {
+          shiftSliceModes(phase, ix, iy, &line_modes[(iy + phase.y_offset) * nmodes],
+                          &slice_modes[(iy - mesh.ystart) * nmodes]);
+        }
+
+        irfft_many(slice_modes.begin(), nlines, nz,
+                   &f.ynext(phase.y_offset)(ix, mesh.ystart + phase.y_offset, 0));
+      }
     }
   }
 }
@@ -269,12 +340,9 @@ ShiftedMetric::shiftZ(const Field3D& f,
       int ix = i.x();
       int iy = i.y();
 
-      Array<dcomplex> shifted_temp(f_fft(ix, iy + phase.y_offset));
-      shifted_temp.ensureUnique();
-
-      for (int jz = 1; jz < nmodes; ++jz) {
-        shifted_temp[jz] *= phase.phase_shift(ix, iy, jz);
-      }
+      Array<dcomplex> shifted_temp(nmodes);
+      shiftSliceModes(phase, ix, iy, f_fft(ix, iy + phase.y_offset).begin(),
+                      shifted_temp.begin());
 
       irfft(shifted_temp.begin(), mesh.LocalNz, &current_result(i.yp(phase.y_offset), 0));
     }
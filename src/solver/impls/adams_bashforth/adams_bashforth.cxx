@@ -258,6 +258,7 @@ BoutReal get_error(const Array<BoutReal>& stateApprox,
 AdamsBashforthSolver::AdamsBashforthSolver(Options* options) : Solver(options) {
   AUTO_TRACE();
   canReset = true;
+  canUseFieldMajor = true;
 }
 
 void AdamsBashforthSolver::setMaxTimestep(BoutReal dt) {
@@ -291,9 +292,10 @@ int AdamsBashforthSolver::init(int nout, BoutReal tstep) {
   // Calculate number of variables
   nlocal = getLocalN();
 
-  // Get total problem size
+  // Get total problem size, not counting zero_copy guard cells
+  int nevolving = getLocalNEvolving();
   int ntmp;
-  if (MPI_Allreduce(&nlocal, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get()) != 0) {
+  if (MPI_Allreduce(&nevolving, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get()) != 0) {
     throw BoutException("MPI_Allreduce failed!");
   }
   neq = ntmp;
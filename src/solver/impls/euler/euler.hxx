@@ -42,7 +42,7 @@ RegisterSolver<EulerSolver> registersolvereuler("euler");
 
 class EulerSolver : public Solver {
  public:
-  EulerSolver(Options *options) : Solver(options) {};
+  EulerSolver(Options *options) : Solver(options) { canUseFieldMajor = true; };
   ~EulerSolver(){};
   
   void setMaxTimestep(BoutReal dt) override;
@@ -44,7 +44,8 @@
 #include <bout/openmpwrap.hxx>
 
 KarniadakisSolver::KarniadakisSolver(Options *options) : Solver(options) {
-  canReset = true;  
+  canReset = true;
+  canUseFieldMajor = true;
 }
 
 int KarniadakisSolver::init(int nout, BoutReal tstep) {
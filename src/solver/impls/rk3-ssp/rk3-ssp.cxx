@@ -10,7 +10,7 @@
 
 #include <output.hxx>
 
-RK3SSP::RK3SSP(Options *opt) : Solver(opt) {}
+RK3SSP::RK3SSP(Options *opt) : Solver(opt) { canUseFieldMajor = true; }
 
 void RK3SSP::setMaxTimestep(BoutReal dt) {
   if(dt > timestep)
@@ -11,7 +11,10 @@
 
 #include <output.hxx>
 
-RK4Solver::RK4Solver(Options *options) : Solver(options) { canReset = true; }
+RK4Solver::RK4Solver(Options *options) : Solver(options) {
+  canReset = true;
+  canUseFieldMajor = true;
+}
 
 void RK4Solver::setMaxTimestep(BoutReal dt) {
   if (dt > timestep)
@@ -38,9 +41,11 @@ int RK4Solver::init(int nout, BoutReal tstep) {
   // Calculate number of variables
   nlocal = getLocalN();
   
-  // Get total problem size
+  // Get total problem size. With zero_copy, nlocal includes guard
+  // cells, which are not counted in the error norms
+  int nevolving = getLocalNEvolving();
   int ntmp;
-  if(MPI_Allreduce(&nlocal, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
+  if(MPI_Allreduce(&nevolving, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
     throw BoutException("MPI_Allreduce failed!");
   }
   neq = ntmp;
@@ -60,6 +65,9 @@ int RK4Solver::init(int nout, BoutReal tstep) {
   k4.reallocate(nlocal);
   k5.reallocate(nlocal);
 
+  // With zero_copy, guard cells differ between the half and full steps
+  error_weights = getErrorWeights();
+
   // Put starting values into f0
   save_vars(std::begin(f0));
 
@@ -105,7 +113,8 @@ int RK4Solver::run() {
           BoutReal local_err = 0.;
           BOUT_OMP(parallel for reduction(+: local_err)   )
           for(int i=0;i<nlocal;i++) {
-            local_err += fabs(f2[i] - f1[i]) / ( fabs(f1[i]) + fabs(f2[i]) + atol );
+            local_err += error_weights[i] * fabs(f2[i] - f1[i])
+                         / (fabs(f1[i]) + fabs(f2[i]) + atol);
           }
         
           // Average over all processors
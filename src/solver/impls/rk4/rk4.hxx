@@ -71,6 +71,8 @@ class RK4Solver : public Solver {
                  Array<BoutReal> &start, Array<BoutReal> &result); // Take a single step to calculate f1
   
   Array<BoutReal> k1, k2, k3, k4, k5; // Time-stepping arrays
+
+  Array<BoutReal> error_weights; // Weight of each variable in the error
   
 };
 
@@ -16,6 +16,7 @@ RKGenericSolver::RKGenericSolver(Options *options) : Solver(options) {
   //Create scheme
   scheme=RKSchemeFactory::getInstance()->createRKScheme(options);
   canReset = true;
+  canUseFieldMajor = true;
 }
 
 RKGenericSolver::~RKGenericSolver() {
@@ -47,9 +48,11 @@ int RKGenericSolver::init(int nout, BoutReal tstep) {
   // Calculate number of variables
   nlocal = getLocalN();
   
-  // Get total problem size
+  // Get total problem size, which the scheme averages the error over.
+  // With zero_copy, nlocal also includes guard cells
+  int nevolving = getLocalNEvolving();
   int ntmp;
-  if(MPI_Allreduce(&nlocal, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
+  if(MPI_Allreduce(&nevolving, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
     throw BoutException("MPI_Allreduce failed!");
   }
   neq = ntmp;
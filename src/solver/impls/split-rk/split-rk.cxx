@@ -15,8 +15,9 @@ int SplitRK::init(int nout, BoutReal tstep) {
   // Calculate number of variables
   nlocal = getLocalN();
   
-  // Get total problem size
-  if(MPI_Allreduce(&nlocal, &neq, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
+  // Get total problem size, without the guard cells stored with zero_copy
+  int nevolving = getLocalNEvolving();
+  if(MPI_Allreduce(&nevolving, &neq, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
     throw BoutException("MPI_Allreduce failed!");
   }
   
@@ -28,6 +29,9 @@ int SplitRK::init(int nout, BoutReal tstep) {
   u2.reallocate(nlocal);
   u3.reallocate(nlocal);
   dydt.reallocate(nlocal);
+
+  // Leaves out the guard cells, which change in each RHS call with zero_copy
+  error_weights = getErrorWeights();
   
   // Put starting values into f
   save_vars(std::begin(state));
@@ -118,7 +122,8 @@ int SplitRK::run() {
           BoutReal local_err = 0.;
           BOUT_OMP(parallel for reduction(+: local_err)   )
           for (int i = 0; i < nlocal; i++) {
-            local_err += fabs(state2[i] - state1[i]) / (fabs(state1[i]) + fabs(state2[i]) + atol);
+            local_err += error_weights[i] * fabs(state2[i] - state1[i])
+                         / (fabs(state1[i]) + fabs(state2[i]) + atol);
           }
           
           // Average over all processors
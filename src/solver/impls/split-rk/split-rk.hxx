@@ -42,7 +42,7 @@ RegisterSolver<SplitRK> registersolversplitrk("splitrk");
 
 class SplitRK : public Solver {
 public:
-  explicit SplitRK(Options *opt = nullptr) : Solver(opt) {}
+  explicit SplitRK(Options *opt = nullptr) : Solver(opt) { canUseFieldMajor = true; }
   ~SplitRK() = default;
 
   int init(int nout, BoutReal tstep) override;
@@ -77,6 +77,8 @@ private:
 
   /// Arrays used for adaptive timestepping
   Array<BoutReal> state1, state2;
+  /// Weight of each variable in the error. See Solver::getErrorWeights
+  Array<BoutReal> error_weights;
   
   /// Take a combined step
   /// Uses 2nd order Strang splitting
@@ -30,6 +30,7 @@
 #include "output.hxx"
 #include "bout/array.hxx"
 #include "bout/assert.hxx"
+#include "bout/check_data.hxx"
 #include "bout/region.hxx"
 #include "bout/solverfactory.hxx"
 #include "bout/sys/timer.hxx"
@@ -509,6 +510,7 @@ int Solver::solve(int NOUT, BoutReal TIMESTEP) {
   int status;
   try {
     status = run();
+    detachVars();
 
     time_t end_time = time(nullptr);
     output_progress.write(_("\nRun finished at  : %s\n"), toString(end_time).c_str());
@@ -529,6 +531,7 @@ int Solver::solve(int NOUT, BoutReal TIMESTEP) {
   } catch (BoutException& e) {
     output_error << "Error encountered in solver run\n";
     output_error << e.what() << endl;
+    detachVars();
     throw;
   }
 
@@ -593,6 +596,21 @@ int Solver::init(int UNUSED(nout), BoutReal UNUSED(tstep)) {
 
   NPES = BoutComm::size();
   MYPE = BoutComm::rank();
+
+  zero_copy = (*options)["zero_copy"]
+                  .doc("Evolving fields use the solver's state vector directly, rather "
+                       "than copies of it? Needs field_major")
+                  .withDefault(false);
+  field_major = (*options)["field_major"]
+                    .doc("Store each variable contiguously in the state vector, rather "
+                         "than interleaving variables at each point?")
+                    .withDefault(zero_copy);
+  if (field_major and not canUseFieldMajor) {
+    throw BoutException(_("This solver can't use a field_major state vector"));
+  }
+  if (zero_copy and not field_major) {
+    throw BoutException(_("The solver option zero_copy needs field_major"));
+  }
   
   /// Mark as initialised. No more variables can be added
   initialised = true;
@@ -862,7 +880,6 @@ int Solver::getLocalN() {
 
   // Cache the value, so this is not repeatedly called.
   // This value should not change after initialisation
-  static int cacheLocalN{-1};
   if (cacheLocalN != -1) {
     return cacheLocalN;
   }
@@ -870,13 +887,23 @@ int Solver::getLocalN() {
   // Must be initialised
   ASSERT0(initialised);
 
-  const auto local_N_2D = std::accumulate(begin(f2d), end(f2d), 0, local_N_sum<Field2D>);
-  const auto local_N_3D = std::accumulate(begin(f3d), end(f3d), 0, local_N_sum<Field3D>);
-  const auto local_N = local_N_2D + local_N_3D;
+  if (zero_copy) {
+    // Whole fields are stored. Use global mesh: FIX THIS!
+    Mesh* mesh = bout::globals::mesh;
+    const int n2D = mesh->LocalNx * mesh->LocalNy;
+    cacheLocalN = n2D * n2Dvars() + n2D * mesh->LocalNz * n3Dvars();
+    return cacheLocalN;
+  }
 
-  cacheLocalN = local_N;
+  cacheLocalN = getLocalNEvolving();
+
+  return cacheLocalN;
+}
 
-  return local_N;
+int Solver::getLocalNEvolving() {
+  const auto local_N_2D = std::accumulate(begin(f2d), end(f2d), 0, local_N_sum<Field2D>);
+  const auto local_N_3D = std::accumulate(begin(f3d), end(f3d), 0, local_N_sum<Field3D>);
+  return local_N_2D + local_N_3D;
 }
 
 Solver* Solver::create(Options* opts) {
@@ -890,162 +917,372 @@ Solver* Solver::create(const SolverType& type, Options* opts) {
 /**************************************************************************
  * Looping over variables
  *
- * NOTE: This part is very inefficient, and should be replaced ASAP
- * Is the interleaving of variables needed or helpful to the solver?
+ * By default the variables are interleaved: at each (x,y) point the
+ * 2D variables are followed by the 3D variables at each z in turn.
+ * Boundary points are first, and only include variables with
+ * evolve_bndry set. The offsets of each variable are calculated once,
+ * so that copying data to and from the solver can be done in parallel
  **************************************************************************/
 
-/// Perform an operation at a given Ind2D (jx,jy) location, moving data between BOUT++ and CVODE
-void Solver::loop_vars_op(Ind2D i2d, BoutReal *udata, int &p, SOLVER_VAR_OP op, bool bndry) {
+void Solver::buildStateLayout() {
   // Use global mesh: FIX THIS!
   Mesh* mesh = bout::globals::mesh;
 
-  int nz = mesh->LocalNz;
-  
-  switch(op) {
-    case SOLVER_VAR_OP::LOAD_VARS: {
-    /// Load variables from IDA into BOUT++
-    
-    // Loop over 2D variables
-    for(const auto& f : f2d) {
-      if(bndry && !f.evolve_bndry)
-        continue;
-      (*f.var)[i2d] = udata[p];
-      p++;
-    }
-    
-    for (int jz=0; jz < nz; jz++) {
-      
-      // Loop over 3D variables
-      for(const auto& f : f3d) {
-        if(bndry && !f.evolve_bndry)
-          continue;
-        (*f.var)[f.var->getMesh()->ind2Dto3D(i2d, jz)] = udata[p];
-        p++;
-      }  
+  // The layout and the copies use the sizes of the global mesh
+  for (const auto& f : f2d) {
+    if (f.var->getMesh() != mesh) {
+      throw BoutException("Variable '%s' is not on the global mesh", f.name.c_str());
     }
-    break;
   }
-  case SOLVER_VAR_OP::LOAD_DERIVS: {
-    /// Load derivatives from IDA into BOUT++
-    /// Used for preconditioner
-    
-    // Loop over 2D variables
-    for(const auto& f : f2d) {
-      if(bndry && !f.evolve_bndry)
-        continue;
-      (*f.F_var)[i2d] = udata[p];
-      p++;
+  for (const auto& f : f3d) {
+    if (f.var->getMesh() != mesh) {
+      throw BoutException("Variable '%s' is not on the global mesh", f.name.c_str());
     }
-    
-    for (int jz=0; jz < nz; jz++) {
-      
-      // Loop over 3D variables
-      for(const auto& f : f3d) {
-        if(bndry && !f.evolve_bndry)
-          continue;
-        (*f.F_var)[f.F_var->getMesh()->ind2Dto3D(i2d, jz)] = udata[p];
-        p++;
-      }  
+  }
+
+  const int nz = mesh->LocalNz;
+  const int n2d = static_cast<int>(f2d.size());
+  const int n3d = static_cast<int>(f3d.size());
+
+  auto& layout = state_layout;
+
+  layout.points.clear();
+  for (const auto& i2d : mesh->getRegion2D("RGN_BNDRY")) {
+    layout.points.push_back(i2d.ind);
+  }
+  const int nbndry = static_cast<int>(layout.points.size());
+  for (const auto& i2d : mesh->getRegion2D("RGN_NOBNDRY")) {
+    layout.points.push_back(i2d.ind);
+  }
+  const int npoints = static_cast<int>(layout.points.size());
+  layout.nbndry = nbndry;
+
+  // Points which are never evolved, such as guard cells
+  std::vector<bool> evolving(mesh->LocalNx * mesh->LocalNy, false);
+  for (const auto i2d : layout.points) {
+    evolving[i2d] = true;
+  }
+  layout.guards.clear();
+  for (int i2d = 0; i2d < static_cast<int>(evolving.size()); ++i2d) {
+    if (!evolving[i2d]) {
+      layout.guards.push_back(i2d);
     }
-    
-    break;
   }
-  case SOLVER_VAR_OP::SET_ID: {
-    /// Set the type of equation (Differential or Algebraic)
-    
-    // Loop over 2D variables
-    for(const auto& f : f2d) {
-      if(bndry && !f.evolve_bndry)
-	continue;
-      if(f.constraint) {
-	udata[p] = 0;
-      }else {
-	udata[p] = 1;
+
+  layout.offset2d.assign(npoints * n2d, -1);
+  layout.offset3d.assign(npoints * n3d, -1);
+  layout.zstride.assign(npoints, 1);
+
+  int p = 0; // Counter for location in the state vector
+
+  if (field_major) {
+    for (int v = 0; v < n2d; ++v) {
+      for (int i = f2d[v].evolve_bndry ? 0 : nbndry; i < npoints; ++i) {
+        layout.offset2d[i * n2d + v] = p++;
       }
-      p++;
     }
-    
-    for (int jz=0; jz < nz; jz++) {
-      
-      // Loop over 3D variables
-      for(const auto& f : f3d) {
-        if(bndry && !f.evolve_bndry)
-	  continue;
-	if(f.constraint) {
-	  udata[p] = 0;
-	}else {
-	  udata[p] = 1;
-	}
-	p++;
+    for (int v = 0; v < n3d; ++v) {
+      for (int i = f3d[v].evolve_bndry ? 0 : nbndry; i < npoints; ++i) {
+        layout.offset3d[i * n3d + v] = p;
+        p += nz;
       }
     }
-    
-    break;
+  } else {
+    for (int i = 0; i < npoints; ++i) {
+      const bool bndry = i < nbndry;
+
+      for (int v = 0; v < n2d; ++v) {
+        if (bndry and !f2d[v].evolve_bndry) {
+          continue;
+        }
+        layout.offset2d[i * n2d + v] = p++;
+      }
+
+      int n3dpoint = 0; // Number of 3D variables evolving at this point
+      for (int v = 0; v < n3d; ++v) {
+        if (bndry and !f3d[v].evolve_bndry) {
+          continue;
+        }
+        layout.offset3d[i * n3d + v] = p + n3dpoint;
+        ++n3dpoint;
+      }
+      layout.zstride[i] = n3dpoint;
+      p += n3dpoint * nz;
+    }
   }
-  case SOLVER_VAR_OP::SAVE_VARS: {
-    /// Save variables from BOUT++ into IDA (only used at start of simulation)
-    
-    // Loop over 2D variables
-    for(const auto& f : f2d) {
-      if(bndry && !f.evolve_bndry)
-        continue;
-      udata[p] = (*f.var)[i2d];
-      p++;
+
+  layout.built = true;
+}
+
+/// Loop over variables and domain. Used for all data operations for consistency
+void Solver::loop_vars(BoutReal *udata, SOLVER_VAR_OP op) {
+  if (!state_layout.built) {
+    buildStateLayout();
+  }
+  if (zero_copy) {
+    loop_fields(udata, op);
+    return;
+  }
+  const auto& layout = state_layout;
+
+  // Use global mesh: FIX THIS!
+  const int nz = bout::globals::mesh->LocalNz;
+  const int n2d = static_cast<int>(f2d.size());
+  const int n3d = static_cast<int>(f3d.size());
+  const int npoints = static_cast<int>(layout.points.size());
+
+  // Data of the variables or time derivatives, or the type of
+  // equation (differential or algebraic) for SET_ID
+  const bool derivs = (op == SOLVER_VAR_OP::LOAD_DERIVS) or (op == SOLVER_VAR_OP::SAVE_DERIVS);
+  std::vector<BoutReal*> data2d(n2d, nullptr);
+  std::vector<BoutReal*> data3d(n3d, nullptr);
+  std::vector<BoutReal> id2d(n2d), id3d(n3d);
+  for (int v = 0; v < n2d; ++v) {
+    if (op != SOLVER_VAR_OP::SET_ID) {
+      data2d[v] = &(*(derivs ? f2d[v].F_var : f2d[v].var))(0, 0);
     }
-    
-    for (int jz=0; jz < nz; jz++) {
-      
-      // Loop over 3D variables
-      for(const auto& f : f3d) {
-        if(bndry && !f.evolve_bndry)
-          continue;
-        udata[p] = (*f.var)[f.var->getMesh()->ind2Dto3D(i2d, jz)];
-        p++;
-      }  
+    id2d[v] = f2d[v].constraint ? 0 : 1;
+  }
+  for (int v = 0; v < n3d; ++v) {
+    if (op != SOLVER_VAR_OP::SET_ID) {
+      data3d[v] = &(*(derivs ? f3d[v].F_var : f3d[v].var))(0, 0, 0);
     }
-    break;
+    id3d[v] = f3d[v].constraint ? 0 : 1;
   }
-    /// Save time-derivatives from BOUT++ into CVODE (returning RHS result)
-  case SOLVER_VAR_OP::SAVE_DERIVS: {
-    
-    // Loop over 2D variables
-    for(const auto& f : f2d) {
-      if(bndry && !f.evolve_bndry)
+
+  BOUT_OMP(parallel for)
+  for (int i = 0; i < npoints; ++i) {
+    const int i2d = layout.points[i];
+
+    for (int v = 0; v < n2d; ++v) {
+      const int offset = layout.offset2d[i * n2d + v];
+      if (offset < 0) {
         continue;
-      udata[p] = (*f.F_var)[i2d];
-      p++;
+      }
+      switch (op) {
+      case SOLVER_VAR_OP::LOAD_VARS:
+      case SOLVER_VAR_OP::LOAD_DERIVS:
+        data2d[v][i2d] = udata[offset];
+        break;
+      case SOLVER_VAR_OP::SAVE_VARS:
+      case SOLVER_VAR_OP::SAVE_DERIVS:
+        udata[offset] = data2d[v][i2d];
+        break;
+      case SOLVER_VAR_OP::SET_ID:
+        udata[offset] = id2d[v];
+        break;
+      }
     }
-    
-    for (int jz=0; jz < nz; jz++) {
-      
-      // Loop over 3D variables
-      for(const auto& f : f3d) {
-        if(bndry && !f.evolve_bndry)
-          continue;
-        udata[p] = (*f.F_var)[f.F_var->getMesh()->ind2Dto3D(i2d, jz)];
-        p++;
+
+    const int stride = layout.zstride[i];
+    for (int v = 0; v < n3d; ++v) {
+      const int offset = layout.offset3d[i * n3d + v];
+      if (offset < 0) {
+        continue;
+      }
+      BoutReal* state = udata + offset;
+      switch (op) {
+      case SOLVER_VAR_OP::LOAD_VARS:
+      case SOLVER_VAR_OP::LOAD_DERIVS: {
+        BoutReal* field = data3d[v] + i2d * nz;
+        for (int jz = 0; jz < nz; ++jz) {
+          field[jz] = state[jz * stride];
+        }
+        break;
+      }
+      case SOLVER_VAR_OP::SAVE_VARS:
+      case SOLVER_VAR_OP::SAVE_DERIVS: {
+        const BoutReal* field = data3d[v] + i2d * nz;
+        for (int jz = 0; jz < nz; ++jz) {
+          state[jz * stride] = field[jz];
+        }
+        break;
+      }
+      case SOLVER_VAR_OP::SET_ID:
+        for (int jz = 0; jz < nz; ++jz) {
+          state[jz * stride] = id3d[v];
+        }
+        break;
       }
     }
-    break;
   }
+}
+
+namespace {
+/// Pointer to the first value of \p f
+BoutReal* dataStart(Field2D& f) { return &f(0, 0); }
+BoutReal* dataStart(Field3D& f) { return &f(0, 0, 0); }
+
+/// Make \p f use the \p len values at \p state as its data, if it
+/// doesn't already
+template <typename T>
+void bindToState(T& f, BoutReal* state, int len, CELL_LOC location) {
+  if (f.isAllocated() and dataStart(f) == state) {
+    return;
   }
+  // Assignment copies the name too, but the field should keep its own
+  const std::string name = f.name;
+  f = T(Array<BoutReal>::view(state, len), f.getMesh(), location, f.getDirections());
+  f.name = name;
 }
 
-/// Loop over variables and domain. Used for all data operations for consistency
-void Solver::loop_vars(BoutReal *udata, SOLVER_VAR_OP op) {
+/// Copy \p len values from \p from to \p to, unless they are the same
+void copyState(const BoutReal* from, BoutReal* to, int len) {
+  if (from == to) {
+    return;
+  }
+  BOUT_OMP(parallel for)
+  for (int i = 0; i < len; ++i) {
+    to[i] = from[i];
+  }
+}
+
+/// Set the \p nz values of \p data at each 2D index in [\p first, \p last) to zero
+void zeroPoints(BoutReal* data, const int* first, const int* last, int nz) {
+  for (; first != last; ++first) {
+    std::fill(data + *first * nz, data + (*first + 1) * nz, 0.0);
+  }
+}
+} // namespace
+
+void Solver::loop_fields(BoutReal* udata, SOLVER_VAR_OP op) {
   // Use global mesh: FIX THIS!
   Mesh* mesh = bout::globals::mesh;
 
-  int p = 0; // Counter for location in udata array
-  
-  // All boundaries
-  for(const auto &i2d : mesh->getRegion2D("RGN_BNDRY")) {
-    loop_vars_op(i2d, udata, p, op, true);
+  const auto& layout = state_layout;
+  const int nz = mesh->LocalNz;
+  const int n2D = mesh->LocalNx * mesh->LocalNy;
+  const int n3D = n2D * nz;
+  // Boundary points, which are only evolved for some variables
+  const int* bndry_begin = layout.points.data();
+  const int* bndry_end = bndry_begin + layout.nbndry;
+  const int* guards_begin = layout.guards.data();
+  const int* guards_end = guards_begin + layout.guards.size();
+
+  BoutReal* state = udata;
+
+  for (auto& f : f2d) {
+    switch (op) {
+    case SOLVER_VAR_OP::LOAD_VARS:
+      bindToState(*f.var, state, n2D, f.var->getLocation());
+      break;
+    case SOLVER_VAR_OP::LOAD_DERIVS:
+      copyState(state, dataStart(*f.F_var), n2D);
+      break;
+    case SOLVER_VAR_OP::SAVE_VARS:
+      copyState(dataStart(*f.var), state, n2D);
+      break;
+    case SOLVER_VAR_OP::SAVE_DERIVS:
+      copyState(dataStart(*f.F_var), state, n2D);
+      // Points which aren't evolved don't change
+      zeroPoints(state, guards_begin, guards_end, 1);
+      if (!f.evolve_bndry) {
+        zeroPoints(state, bndry_begin, bndry_end, 1);
+      }
+      break;
+    case SOLVER_VAR_OP::SET_ID:
+      std::fill(state, state + n2D, f.constraint ? 0 : 1);
+      break;
+    }
+    state += n2D;
+  }
+
+  for (auto& f : f3d) {
+    switch (op) {
+    case SOLVER_VAR_OP::LOAD_VARS:
+      bindToState(*f.var, state, n3D, f.location);
+      break;
+    case SOLVER_VAR_OP::LOAD_DERIVS:
+      copyState(state, dataStart(*f.F_var), n3D);
+      break;
+    case SOLVER_VAR_OP::SAVE_VARS:
+      copyState(dataStart(*f.var), state, n3D);
+      break;
+    case SOLVER_VAR_OP::SAVE_DERIVS:
+      copyState(dataStart(*f.F_var), state, n3D);
+      zeroPoints(state, guards_begin, guards_end, nz);
+      if (!f.evolve_bndry) {
+        zeroPoints(state, bndry_begin, bndry_end, nz);
+      }
+      break;
+    case SOLVER_VAR_OP::SET_ID:
+      std::fill(state, state + n3D, f.constraint ? 0 : 1);
+      break;
+    }
+    state += n3D;
   }
-  
-  // Bulk of points
-  for(const auto &i2d : mesh->getRegion2D("RGN_NOBNDRY")) {
-    loop_vars_op(i2d, udata, p, op, false);
+}
+
+Array<BoutReal> Solver::getErrorWeights() {
+  Array<BoutReal> weights(getLocalN());
+  std::fill(std::begin(weights), std::end(weights), 1.0);
+  if (!zero_copy) {
+    return weights;
+  }
+
+  if (!state_layout.built) {
+    buildStateLayout();
+  }
+
+  // Use global mesh: FIX THIS!
+  Mesh* mesh = bout::globals::mesh;
+
+  const auto& layout = state_layout;
+  const int n2D = mesh->LocalNx * mesh->LocalNy;
+  const int* bndry_begin = layout.points.data();
+  const int* bndry_end = bndry_begin + layout.nbndry;
+  const int* guards_begin = layout.guards.data();
+  const int* guards_end = guards_begin + layout.guards.size();
+
+  // The same points as have zero time derivative in save_derivs
+  BoutReal* state = std::begin(weights);
+  for (const auto& f : f2d) {
+    zeroPoints(state, guards_begin, guards_end, 1);
+    if (!f.evolve_bndry) {
+      zeroPoints(state, bndry_begin, bndry_end, 1);
+    }
+    state += n2D;
+  }
+  for (const auto& f : f3d) {
+    zeroPoints(state, guards_begin, guards_end, mesh->LocalNz);
+    if (!f.evolve_bndry) {
+      zeroPoints(state, bndry_begin, bndry_end, mesh->LocalNz);
+    }
+    state += n2D * mesh->LocalNz;
+  }
+  return weights;
+}
+
+namespace {
+/// Give \p f its own copy of its data
+template <typename T>
+void detachFromState(T& f, int len) {
+  if (!f.isAllocated()) {
+    return;
+  }
+  Array<BoutReal> data(len);
+  const BoutReal* start = dataStart(f);
+  std::copy(start, start + len, std::begin(data));
+  const std::string name = f.name;
+  f = T(data, f.getMesh(), f.getLocation(), f.getDirections());
+  f.name = name;
+}
+} // namespace
+
+void Solver::detachVars() {
+  if (!zero_copy) {
+    return;
+  }
+
+  // Use global mesh: FIX THIS!
+  Mesh* mesh = bout::globals::mesh;
+  const int n2D = mesh->LocalNx * mesh->LocalNy;
+
+  for (auto& f : f2d) {
+    detachFromState(*f.var, n2D);
+  }
+  for (auto& f : f3d) {
+    detachFromState(*f.var, n2D * mesh->LocalNz);
   }
 }
 
@@ -1147,6 +1384,10 @@ void Solver::set_id(BoutReal *udata) {
 }
 
 Field3D Solver::globalIndex(int localStart) {
+  if (field_major) {
+    throw BoutException(_("Solver::globalIndex needs an interleaved state vector"));
+  }
+
   // Use global mesh: FIX THIS!
   Mesh* mesh = bout::globals::mesh;
 
@@ -1221,6 +1462,8 @@ int Solver::run_rhs(BoutReal t) {
   int status;
   
   Timer timer("rhs");
+  // Recycle the memory of temporary fields between evaluations
+  Array<BoutReal>::Scope array_scope;
   
   if(split_operator) {
     // Run both parts
@@ -1273,6 +1516,7 @@ int Solver::run_convective(BoutReal t) {
   int status;
 
   Timer timer("rhs");
+  Array<BoutReal>::Scope array_scope;
   pre_rhs(t);
   if (split_operator) {
     if (model) {
@@ -1308,6 +1552,7 @@ int Solver::run_diffusive(BoutReal t, bool linear) {
   int status = 0;
 
   Timer timer("rhs");
+  Array<BoutReal>::Scope array_scope;
   pre_rhs(t);
   if (split_operator) {
 
@@ -1347,16 +1592,31 @@ void Solver::pre_rhs(BoutReal t) {
     if(!f.constraint)
       f.var->applyBoundary(t);
   }
-  
+
+  if (bout::checks::checkRHSFinite()) {
+    TRACE("Solver checking evolving variables");
+    for (const auto& f : f2d) {
+      bout::checks::checkFinite(*f.var, f.name);
+    }
+    for (const auto& f : f3d) {
+      bout::checks::checkFinite(*f.var, f.name);
+    }
+  }
 }
 
 void Solver::post_rhs(BoutReal UNUSED(t)) {
-#if CHECK > 0
-  for(const auto& f : f3d) {
-    if(!f.F_var->isAllocated())
-      throw BoutException(_("Time derivative for variable '%s' not set"), f.name.c_str());
+  const bool check_finite = bout::checks::checkRHSFinite()
+                            || bout::checks::getFiniteMode() == CHECK_FINITE::all;
+
+  // The finite checks below also need the time derivatives to be set
+  if (CHECK > 0 || check_finite) {
+    for (const auto& f : f3d) {
+      if (!f.F_var->isAllocated()) {
+        throw BoutException(_("Time derivative for variable '%s' not set"),
+                            f.name.c_str());
+      }
+    }
   }
-#endif
   // Make sure vectors in correct basis
   for(const auto& v : v2d) {
     if(v.covariant) {
@@ -1386,15 +1646,20 @@ void Solver::post_rhs(BoutReal UNUSED(t)) {
     if(!f.constraint && f.evolve_bndry)
       f.var->applyTDerivBoundary();
   }
-#if CHECK > 2
-  {
+
+  if (check_finite) {
     TRACE("Solver checking time derivatives");
-    for(const auto& f : f3d) {
-      TRACE("Variable: %s", f.name.c_str());
-      checkData(*f.F_var);
+    for (const auto& f : f2d) {
+      if (f.F_var->isAllocated()) {
+        bout::checks::checkFinite(*f.F_var, "ddt(" + f.name + ")");
+      }
+    }
+    for (const auto& f : f3d) {
+      if (f.F_var->isAllocated()) {
+        bout::checks::checkFinite(*f.F_var, "ddt(" + f.name + ")");
+      }
     }
   }
-#endif
 }
 
 bool Solver::varAdded(const std::string& name) {
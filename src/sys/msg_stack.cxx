@@ -31,7 +31,17 @@
 #include <string>
 
 #if CHECK > 1
+namespace {
+/// Set on threads which should not touch the stack
+thread_local bool thread_disabled = false;
+} // namespace
+
+void MsgStack::disableThisThread() { thread_disabled = true; }
+
 int MsgStack::push(const char *s, ...) {
+  if (thread_disabled) {
+    return 0;
+  }
   va_list ap; // List of arguments
   BOUT_OMP(critical(MsgStack_push)) {
     if (s != nullptr) {
@@ -59,13 +69,15 @@ int MsgStack::setPoint() {
 }
 
 void MsgStack::pop() {
-  if (position <= 0)
+  if (thread_disabled or position <= 0)
     return;
   BOUT_OMP(atomic)
   --position;
 }
 
 void MsgStack::pop(int id) {
+  if (thread_disabled)
+    return;
   if (id < 0)
     id = 0;
 
@@ -76,6 +88,8 @@ void MsgStack::pop(int id) {
 }
 
 void MsgStack::clear() {
+  if (thread_disabled)
+    return;
   BOUT_OMP(single) {
     stack.clear();
     position = 0;
@@ -83,11 +97,16 @@ void MsgStack::clear() {
 }
 
 void MsgStack::dump() {
+  if (thread_disabled)
+    return;
   BOUT_OMP(single) { output << this->getDump(); }
 }
 
 std::string MsgStack::getDump() {
   std::string res = "====== Back trace ======\n";
+  if (thread_disabled) {
+    return res;
+  }
   for (int i = position - 1; i >= 0; i--) {
     if (stack[i] != "") {
       res += " -> ";
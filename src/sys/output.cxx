@@ -26,8 +26,43 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <output.hxx>
+#include <string>
 #include <utils.hxx>
+#include <vector>
+
+namespace {
+/// Set on threads whose messages are stored, rather than written
+thread_local bool thread_collecting = false;
+
+/// A message written on a collecting thread
+struct CollectedMessage {
+  Output* out;
+  bool screen_only; ///< From print rather than write?
+  std::string text;
+};
+
+std::mutex collected_mutex;
+std::vector<CollectedMessage> collected;
+
+/// Store a message. Doesn't use the buffer of \p out, which may be in
+/// use by the main thread
+void collect(Output* out, bool screen_only, const char* string, va_list va) {
+  va_list copy;
+  va_copy(copy, va);
+  const int len = vsnprintf(nullptr, 0, string, copy);
+  va_end(copy);
+  if (len < 0) {
+    return;
+  }
+  std::vector<char> text(len + 1);
+  vsnprintf(text.data(), text.size(), string, va);
+
+  std::lock_guard<std::mutex> lock(collected_mutex);
+  collected.push_back({out, screen_only, std::string(text.data(), len)});
+}
+} // namespace
 
 void Output::enable() {
   add(std::cout);
@@ -93,6 +128,11 @@ void Output::vwrite(const char *string, va_list va) {
     return;
   }
 
+  if (thread_collecting) {
+    collect(this, false, string, va);
+    return;
+  }
+
   bout_vsnprintf_(buffer, buffer_len, string, va);
 
   multioutbuf_init::buf()->sputn(buffer, strlen(buffer));
@@ -113,6 +153,12 @@ void Output::vprint(const char *string, va_list ap) {
   if (string == (const char *)nullptr) {
     return;
   }
+
+  if (thread_collecting) {
+    collect(this, true, string, ap);
+    return;
+  }
+
   bout_vsnprintf_(buffer, buffer_len, string, ap);
   std::cout << std::string(buffer);
   std::cout.flush();
@@ -123,6 +169,23 @@ Output *Output::getInstance() {
   return &instance;
 }
 
+void Output::collectThisThread() { thread_collecting = true; }
+
+void Output::writeCollected() {
+  std::vector<CollectedMessage> messages;
+  {
+    std::lock_guard<std::mutex> lock(collected_mutex);
+    messages.swap(collected);
+  }
+  for (const auto& message : messages) {
+    if (message.screen_only) {
+      message.out->print("%s", message.text.c_str());
+    } else {
+      message.out->write("%s", message.text.c_str());
+    }
+  }
+}
+
 void ConditionalOutput::write(const char *str, ...) {
   if (enabled) {
     va_list va;
@@ -0,0 +1,141 @@
+/*
+ * Aggregated output test
+ *
+ * Write a field from blocks of processors into shared files, then
+ * read the files back and check that each block is laid out as if
+ * it were one processor, with the processor layout of the blocks
+ */
+
+#include <bout.hxx>
+#include <dataformat.hxx>
+
+#include <vector>
+
+using bout::globals::mesh;
+
+namespace {
+/// Value at global indices \p x, \p y, \p z, including guard cells
+BoutReal globalValue(int x, int y, int z) { return 10000. * x + 100. * y + z; }
+
+/// Report a failure on this processor
+bool check(bool ok, const std::string& what) {
+  if (!ok) {
+    output_error.write("FAILED: %s\n", what.c_str());
+  }
+  return ok;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  BoutInitialise(argc, argv);
+
+  auto& options = Options::root()["aggregated"];
+  const int aggregate_x = options["aggregate_x"].withDefault(1);
+  const int aggregate_y = options["aggregate_y"].withDefault(1);
+
+  Field3D f3d{mesh};
+  f3d.allocate();
+  for (int x = 0; x < mesh->LocalNx; ++x) {
+    for (int y = 0; y < mesh->LocalNy; ++y) {
+      for (int z = 0; z < mesh->LocalNz; ++z) {
+        f3d(x, y, z) =
+            globalValue(mesh->getGlobalXIndex(x), mesh->getGlobalYIndex(y), z);
+      }
+    }
+  }
+
+  // The mesh variables are written for the blocks of processors
+  Datafile file{&options};
+  file.add(f3d, "f3d");
+  mesh->outputVars(file);
+  file.openw("data/aggregate.hdf5");
+  file.write();
+  file.close();
+
+  // A variable of the user with one of the names of the mesh variables
+  // is written unchanged
+  int user_mxsub = 7;
+  Datafile user_file{&options};
+  user_file.add(user_mxsub, "MXSUB");
+  user_file.openw("data/user.hdf5");
+  user_file.write();
+  user_file.close();
+
+  MPI_Barrier(BoutComm::get());
+
+  const int nxpe = mesh->getNXPE();
+  const int mxsub = mesh->xend - mesh->xstart + 1;
+  const int mysub = mesh->yend - mesh->ystart + 1;
+  const int pe_xind = mesh->getXProcIndex();
+  const int pe_yind = mesh->getYProcIndex();
+
+  bool ok = true;
+  if (pe_xind % aggregate_x == 0 and pe_yind % aggregate_y == 0) {
+    // The first processor in each block wrote the file
+    const int block_x = pe_xind / aggregate_x;
+    const int block_y = pe_yind / aggregate_y;
+    const int file_index = block_x + (nxpe / aggregate_x) * block_y;
+
+    auto reader = data_format("data/aggregate.hdf5");
+    ok = check(reader->openr("data/aggregate.hdf5", file_index), "opening file");
+
+    const int block_nx = mxsub * aggregate_x + 2 * mesh->xstart;
+    const int block_ny = mysub * aggregate_y + 2 * mesh->ystart;
+    const int nz = mesh->LocalNz;
+    ok = ok
+         and check(reader->getSize("f3d") == std::vector<int>{block_nx, block_ny, nz},
+                   "size of f3d");
+
+    if (ok) {
+      std::vector<BoutReal> data(block_nx * block_ny * nz);
+      reader->read(data.data(), "f3d", block_nx, block_ny, nz);
+      for (int x = 0; x < block_nx; ++x) {
+        for (int y = 0; y < block_ny; ++y) {
+          for (int z = 0; z < nz; ++z) {
+            const BoutReal expected = globalValue(block_x * aggregate_x * mxsub + x,
+                                                  block_y * aggregate_y * mysub + y, z);
+            ok = check(data[(x * block_ny + y) * nz + z] == expected,
+                       "f3d at (" + toString(x) + ", " + toString(y) + ", "
+                           + toString(z) + ")")
+                 and ok;
+          }
+        }
+      }
+
+      const std::vector<std::pair<std::string, int>> expected_ints{
+          {"NXPE", nxpe / aggregate_x},
+          {"NYPE", mesh->getNYPE() / aggregate_y},
+          {"PE_XIND", block_x},
+          {"PE_YIND", block_y},
+          {"MXSUB", mxsub * aggregate_x},
+          {"MYSUB", mysub * aggregate_y},
+          {"MYPE", file_index}};
+      for (const auto& expected : expected_ints) {
+        int value;
+        reader->read(&value, expected.first);
+        ok = check(value == expected.second,
+                   expected.first + " is " + toString(value) + ", expected "
+                       + toString(expected.second))
+             and ok;
+      }
+    }
+    reader->close();
+
+    auto user_reader = data_format("data/user.hdf5");
+    if (check(user_reader->openr("data/user.hdf5", file_index), "opening user file")) {
+      int value;
+      user_reader->read(&value, "MXSUB");
+      ok = check(value == user_mxsub, "user variable MXSUB is " + toString(value)) and ok;
+      user_reader->close();
+    } else {
+      ok = false;
+    }
+  }
+
+  int all_ok;
+  int local_ok = ok ? 1 : 0;
+  MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_MIN, BoutComm::get());
+
+  BoutFinalise();
+  return all_ok == 1 ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 
 #include "gtest/gtest.h"
 
+#include "bout/check_data.hxx"
 #include "bout/constants.hxx"
 #include "bout/mesh.hxx"
 #include "boutexception.hxx"
@@ -14,6 +15,7 @@
 #include "utils.hxx"
 
 #include <cmath>
+#include <limits>
 #include <set>
 #include <vector>
 
@@ -1235,6 +1237,59 @@ TEST_F(Field3DTest, InvalidateGuards) {
 
 #endif // CHECK > 2
 
+#if CHECK > 0
+TEST_F(Field3DTest, CheckDataFiniteModes) {
+  const auto original_mode = bout::checks::getFiniteMode();
+
+  Field3D field = 1.0;
+  field.name = "bad_field";
+  field(1, 1, 1) = std::nan("");
+
+  bout::checks::setFiniteMode(CHECK_FINITE::none);
+  EXPECT_NO_THROW(checkData(field));
+
+  bout::checks::setFiniteMode(CHECK_FINITE::all);
+  EXPECT_THROW(checkData(field), BoutException);
+
+  // Only every third call scans the data
+  bout::checks::setFiniteMode(CHECK_FINITE::sample, 3);
+  EXPECT_NO_THROW(checkData(field));
+  EXPECT_NO_THROW(checkData(field));
+  EXPECT_THROW(checkData(field), BoutException);
+  EXPECT_NO_THROW(checkData(field));
+
+  // Operators don't scan, only the solver around the RHS
+  bout::checks::setFiniteMode(CHECK_FINITE::rhs);
+  EXPECT_NO_THROW(checkData(field));
+  EXPECT_TRUE(bout::checks::checkRHSFinite());
+
+  EXPECT_THROW(bout::checks::setFiniteMode(CHECK_FINITE::sample, 0), BoutException);
+
+  bout::checks::setFiniteMode(original_mode);
+}
+#endif
+
+TEST_F(Field3DTest, CheckFinite) {
+  Field3D field = 1.0;
+  EXPECT_NO_THROW(bout::checks::checkFinite(field, "field"));
+
+  field(0, 0, 0) = std::nan("");
+  EXPECT_NO_THROW(bout::checks::checkFinite(field, "field"));
+  EXPECT_THROW(bout::checks::checkFinite(field, "field", "RGN_ALL"), BoutException);
+
+  field(1, 2, 3) = -std::numeric_limits<BoutReal>::infinity();
+  field(2, 1, 0) = std::nan("");
+  try {
+    bout::checks::checkFinite(field, "field");
+    FAIL() << "checkFinite did not throw";
+  } catch (const BoutException& e) {
+    // Reports the first bad point in the region
+    const std::string message = e.what();
+    EXPECT_NE(message.find("'field'"), std::string::npos);
+    EXPECT_NE(message.find("[1][2][3]"), std::string::npos);
+  }
+}
+
 //-------------------- Assignment tests --------------------
 
 TEST_F(Field3DTest, CreateFromBoutReal) {
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include "bout/field_expr.hxx"
+#include "bout/mesh.hxx"
+#include "field2d.hxx"
+#include "field3d.hxx"
+#include "fieldperp.hxx"
+#include "test_extras.hxx"
+
+#include <cmath>
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+
+using bout::expr::lazy;
+
+class FieldExprTest : public FakeMeshFixture {
+public:
+  FieldExprTest() {
+    a = makeField<Field3D>([](Ind3D& i) { return 1.0 + i.x() + 0.1 * i.z(); },
+                           bout::globals::mesh);
+    b = makeField<Field3D>([](Ind3D& i) { return 2.0 - i.y() + 0.3 * i.z(); },
+                           bout::globals::mesh);
+    c = makeField<Field3D>([](Ind3D& i) { return 0.5 * i.ind; }, bout::globals::mesh);
+    d = makeField<Field3D>([](Ind3D& i) { return 3.0 + std::sin(i.ind); },
+                           bout::globals::mesh);
+    e = makeField<Field2D>([](Ind2D& i) { return 4.0 + i.x() - 0.5 * i.y(); },
+                           bout::globals::mesh);
+  }
+
+  Field3D a, b, c, d;
+  Field2D e;
+};
+
+TEST_F(FieldExprTest, Field3D) {
+  const Field3D expected = a * b + c / d - a;
+  const Field3D result = lazy(a) * b + lazy(c) / d - a;
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+}
+
+TEST_F(FieldExprTest, AssignToExisting) {
+  const Field3D expected = (a - b) * (c + d);
+
+  Field3D result = c;
+  result = (lazy(a) - b) * (lazy(c) + d);
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+  // c should not have been modified
+  EXPECT_TRUE(IsFieldEqual(c, makeField<Field3D>([](Ind3D& i) { return 0.5 * i.ind; },
+                                                 bout::globals::mesh)));
+}
+
+TEST_F(FieldExprTest, Scalars) {
+  const Field3D expected = 2.0 * a - b / 4.0 + 1;
+  const Field3D result = 2.0 * lazy(a) - lazy(b) / 4.0 + 1;
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+}
+
+TEST_F(FieldExprTest, Negate) {
+  const Field3D expected = -(a * b) + c;
+  const Field3D result = -(lazy(a) * b) + c;
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+}
+
+TEST_F(FieldExprTest, Field3DField2D) {
+  const Field3D expected = a * e + e / d - e;
+  const Field3D result = lazy(a) * e + lazy(e) / d - e;
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+}
+
+TEST_F(FieldExprTest, Field2D) {
+  const Field2D f = e * e;
+  const Field2D expected = f * e - 3.0 / e;
+  const Field2D result = lazy(f) * e - 3.0 / lazy(e);
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+}
+
+TEST_F(FieldExprTest, FieldPerp) {
+  const int yindex = 1;
+  const FieldPerp p = sliceXZ(c, yindex);
+
+  const FieldPerp expected = p * a + e / p - 2.0;
+  const FieldPerp result = lazy(p) * a + lazy(e) / p - 2.0;
+
+  EXPECT_EQ(result.getIndex(), yindex);
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+}
+
+TEST_F(FieldExprTest, Location) {
+  Field3D f = makeField<Field3D>([](Ind3D& i) { return i.ind; }, mesh_staggered);
+  Field3D g = makeField<Field3D>([](Ind3D& i) { return 2.0 * i.ind; }, mesh_staggered);
+  f.setLocation(CELL_XLOW);
+  g.setLocation(CELL_XLOW);
+
+  const Field3D result = lazy(f) * g;
+
+  EXPECT_EQ(result.getLocation(), CELL_XLOW);
+  EXPECT_EQ(result.getMesh(), mesh_staggered);
+}
+
+#if CHECK > 0
+TEST_F(FieldExprTest, Unallocated) {
+  Field3D empty{bout::globals::mesh};
+
+  EXPECT_THROW(Field3D result = lazy(a) * empty, BoutException);
+}
+
+TEST_F(FieldExprTest, Incompatible) {
+  Field3D f = makeField<Field3D>([](Ind3D& i) { return i.ind; }, mesh_staggered);
+
+  EXPECT_THROW(Field3D result = lazy(a) * f, BoutException);
+}
+#endif
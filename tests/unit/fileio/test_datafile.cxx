@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+
+#include "datafile.hxx"
+#include "test_extras.hxx"
+#include "bout/constants.hxx"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+/// The bit pattern of \p value
+std::uint64_t bits(BoutReal value) {
+  std::uint64_t result;
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+} // namespace
+
+TEST(RoundSignificantBitsTest, AllBitsUnchanged) {
+  const std::vector<BoutReal> original{1.0 + std::ldexp(1.0, -30), -M_PI, 1.e-300};
+
+  for (int nbits : {52, 53, 64, 0, -1}) {
+    auto data = original;
+    bout::roundSignificantBits(data.data(), data.size(), nbits);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      EXPECT_EQ(bits(data[i]), bits(original[i])) << "with " << nbits << " bits";
+    }
+  }
+}
+
+TEST(RoundSignificantBitsTest, RoundToNearest) {
+  std::vector<BoutReal> data{1.0 + std::ldexp(1.0, -10) + std::ldexp(1.0, -12),
+                             1.0 + std::ldexp(1.0, -12),
+                             1.0 + std::ldexp(1.0, -11), 0.0};
+
+  bout::roundSignificantBits(data.data(), data.size(), 10);
+
+  EXPECT_EQ(data[0], 1.0 + std::ldexp(1.0, -10));
+  EXPECT_EQ(data[1], 1.0);
+  // Halfway rounds away from zero
+  EXPECT_EQ(data[2], 1.0 + std::ldexp(1.0, -10));
+  EXPECT_EQ(data[3], 0.0);
+}
+
+TEST(RoundSignificantBitsTest, Negative) {
+  std::vector<BoutReal> data{-(1.0 + std::ldexp(1.0, -10) + std::ldexp(1.0, -12)),
+                             -(1.0 + std::ldexp(1.0, -12)), -0.0};
+
+  bout::roundSignificantBits(data.data(), data.size(), 10);
+
+  EXPECT_EQ(data[0], -(1.0 + std::ldexp(1.0, -10)));
+  EXPECT_EQ(data[1], -1.0);
+  EXPECT_EQ(bits(data[2]), bits(-0.0));
+}
+
+TEST(RoundSignificantBitsTest, CarryIntoExponent) {
+  std::vector<BoutReal> data{2.0 - std::ldexp(1.0, -20), -(4.0 - std::ldexp(1.0, -20))};
+
+  bout::roundSignificantBits(data.data(), data.size(), 10);
+
+  EXPECT_EQ(data[0], 2.0);
+  EXPECT_EQ(data[1], -4.0);
+}
+
+TEST(RoundSignificantBitsTest, NonFiniteUnchanged) {
+  const std::vector<BoutReal> original{std::numeric_limits<BoutReal>::quiet_NaN(),
+                                       -std::numeric_limits<BoutReal>::quiet_NaN(),
+                                       std::numeric_limits<BoutReal>::infinity(),
+                                       -std::numeric_limits<BoutReal>::infinity()};
+  auto data = original;
+
+  bout::roundSignificantBits(data.data(), data.size(), 10);
+
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(bits(data[i]), bits(original[i]));
+  }
+}
+
+TEST(RoundSignificantBitsTest, RelativeError) {
+  constexpr int nbits = 12;
+  std::vector<BoutReal> original(100);
+  for (std::size_t i = 0; i < original.size(); ++i) {
+    original[i] = std::sin(0.1 * i) * std::exp(0.5 * i);
+  }
+  auto data = original;
+
+  bout::roundSignificantBits(data.data(), data.size(), nbits);
+
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    EXPECT_LE(std::abs(data[i] - original[i]),
+              std::ldexp(std::abs(original[i]), -(nbits + 1)));
+    // The dropped bits are zero
+    const std::uint64_t dropped = (std::uint64_t{1} << (52 - nbits)) - 1;
+    EXPECT_EQ(bits(data[i]) & dropped, std::uint64_t{0});
+  }
+}
+
+#ifdef BOUT_HAS_FFTW
+namespace {
+/// Modes 0 to 2 are kept with zmax = 2, the rest are removed
+BoutReal lowModes(BoutReal z, int i) { return i + std::sin(z) + 0.5 * std::cos(2 * z); }
+BoutReal allModes(BoutReal z, int i) {
+  return lowModes(z, i) + std::cos(3 * z) - 0.25 * std::sin(5 * z);
+}
+} // namespace
+
+TEST(ReduceZTest, KeepLowModes) {
+  constexpr int nxy = 3;
+  constexpr int ncz = 16;
+  constexpr int zmax = 2;
+  constexpr int nz = 2 * (zmax + 1);
+
+  std::vector<BoutReal> data(nxy * ncz);
+  for (int i = 0; i < nxy; ++i) {
+    for (int k = 0; k < ncz; ++k) {
+      data[i * ncz + k] = allModes(TWOPI * k / ncz, i);
+    }
+  }
+  std::vector<BoutReal> result(nxy * nz);
+
+  bout::reduceZ(data.data(), nxy, ncz, zmax, nz, result.data());
+
+  for (int i = 0; i < nxy; ++i) {
+    for (int k = 0; k < nz; ++k) {
+      EXPECT_NEAR(result[i * nz + k], lowModes(TWOPI * k / nz, i), FFTTolerance);
+    }
+  }
+}
+
+TEST(ReduceZTest, AllModes) {
+  constexpr int nxy = 2;
+  constexpr int ncz = 16;
+
+  std::vector<BoutReal> data(nxy * ncz);
+  for (int i = 0; i < nxy; ++i) {
+    for (int k = 0; k < ncz; ++k) {
+      data[i * ncz + k] = allModes(TWOPI * k / ncz, i);
+    }
+  }
+  std::vector<BoutReal> result(nxy * ncz);
+
+  // Only the Nyquist mode is removed, which allModes doesn't have
+  bout::reduceZ(data.data(), nxy, ncz, ncz / 2 - 1, ncz, result.data());
+
+  for (int i = 0; i < nxy * ncz; ++i) {
+    EXPECT_NEAR(result[i], data[i], FFTTolerance);
+  }
+}
+#endif
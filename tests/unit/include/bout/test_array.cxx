@@ -237,6 +237,102 @@ TEST_F(ArrayTest, Assignment) {
   EXPECT_FALSE(b.unique());
 }
 
+TEST_F(ArrayTest, Stats) {
+  const auto before = Array<double>::getStats();
+
+  // Use an unusual size, so the store doesn't already have one
+  Array<double> a(1031);
+  a.clear();
+  // Retrieved from the store, so no new allocation
+  Array<double> b(1031);
+
+  const auto after = Array<double>::getStats();
+
+  EXPECT_EQ(after.requests - before.requests, 2);
+  EXPECT_EQ(after.allocations - before.allocations, 1);
+  EXPECT_EQ(after.bytes - before.bytes, 1031 * sizeof(double));
+}
+
+namespace {
+/// Element type with its own store, as the store can't be re-enabled
+struct StoreDisabled {
+  double value;
+};
+} // namespace
+
+TEST_F(ArrayTest, StatsWithoutStore) {
+  Array<StoreDisabled>::useStore(false);
+  const auto before = Array<StoreDisabled>::getStats();
+
+  {
+    Array<StoreDisabled> a(1049);
+    EXPECT_EQ(Array<StoreDisabled>::getStats().bytes - before.bytes,
+              1049 * sizeof(StoreDisabled));
+  }
+
+  // Freed rather than kept in the store
+  const auto after = Array<StoreDisabled>::getStats();
+  EXPECT_EQ(after.allocations - before.allocations, 1);
+  EXPECT_EQ(after.bytes, before.bytes);
+}
+
+TEST_F(ArrayTest, Scope) {
+  const auto before = Array<double>::getStats();
+
+  {
+    Array<double>::Scope scope;
+    Array<double> a(1033);
+    {
+      // Nested scopes are not counted separately
+      Array<double>::Scope inner;
+      Array<double> b(1033);
+    }
+  }
+
+  const auto after = Array<double>::getStats();
+
+  EXPECT_EQ(after.scopes - before.scopes, 1);
+  EXPECT_EQ(after.scope_requests - before.scope_requests, 2);
+  EXPECT_EQ(after.scope_allocations - before.scope_allocations, 2);
+}
+
+TEST_F(ArrayTest, ManySizes) {
+  // Use more sizes than are remembered as recently used
+  const std::vector<int> sizes{50, 51, 52, 53, 54, 55, 56};
+
+  for (const auto size : sizes) {
+    Array<double> a(size);
+    std::fill(a.begin(), a.end(), size);
+  }
+
+  const auto before = Array<double>::getStats();
+
+  for (auto size = sizes.rbegin(); size != sizes.rend(); ++size) {
+    Array<double> a(*size);
+    EXPECT_EQ(a.size(), *size);
+    EXPECT_DOUBLE_EQ(a[0], *size); // Test if reused data from store
+  }
+
+  EXPECT_EQ(Array<double>::getStats().allocations, before.allocations);
+}
+
+TEST_F(ArrayTest, View) {
+  std::vector<double> data(1039, 1.0);
+  {
+    Array<double> a = Array<double>::view(data.data(), 1039);
+
+    EXPECT_EQ(a.size(), 1039);
+    EXPECT_EQ(&a[0], data.data());
+
+    a[2] = 3.0;
+    EXPECT_DOUBLE_EQ(data[2], 3.0);
+  }
+
+  // Views are not put into the store, so the memory isn't reused
+  Array<double> b(1039);
+  EXPECT_NE(&b[0], data.data());
+}
+
 #if CHECK > 2
 TEST_F(ArrayTest, OutOfBoundsThrow) {
   Array<double> a(34);
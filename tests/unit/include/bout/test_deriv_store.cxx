@@ -12,6 +12,7 @@ using FieldType = std::vector<BoutReal>;
 
 using standardType = DerivativeStore<FieldType>::standardFunc;
 using flowType = DerivativeStore<FieldType>::upwindFunc;
+using kernelType = DerivativeStore<FieldType>::stencilKernel;
 
 void standardReturnTenSetToOne(const FieldType& UNUSED(inp), FieldType& out,
                                const std::string& = "RGN_ALL") {
@@ -23,6 +24,10 @@ void flowReturnSixSetToTwo(const FieldType& UNUSED(vel), const FieldType& UNUSED
   out.resize(6, 2.0);
 }
 
+BoutReal kernelReturnCentre(const stencil& f) { return f.c; }
+
+BoutReal kernelReturnVelocity(BoutReal vc, const stencil& UNUSED(f)) { return vc; }
+
 class DerivativeStoreTest : public ::testing::Test {
 public:
   DerivativeStoreTest() : store(DerivativeStore<FieldType>::getInstance()) {}
@@ -332,3 +337,119 @@ TEST_F(DerivativeStoreTest, GetStandardFromFlowDerivative) {
       store.getFlowDerivative("bad type", DIRECTION::X, STAGGER::None, DERIV::Standard),
       BoutException);
 }
+
+void standardReturnFiveSetToThree(const FieldType& UNUSED(inp), FieldType& out,
+                                  const std::string& = "RGN_ALL") {
+  out.resize(5, 3.0);
+}
+
+TEST_F(DerivativeStoreTest, GetDefaultStandardDerivative) {
+  const DERIV type = DERIV::StandardSecond;
+  const DIRECTION dir = DIRECTION::Z;
+
+  store.forceDefaultMethod("FIRST", type, dir, STAGGER::None);
+  store.registerDerivative(standardReturnTenSetToOne, type, dir, STAGGER::None, "FIRST");
+  store.registerDerivative(standardReturnFiveSetToThree, type, dir, STAGGER::None,
+                           "SECOND");
+
+  FieldType inp, out;
+  store.getStandard2ndDerivative("DEFAULT", dir)(inp, out, "RGN_ALL");
+  EXPECT_EQ(out.size(), 10);
+
+  // Changing the default method should change the method returned
+  store.forceDefaultMethod("SECOND", type, dir, STAGGER::None);
+  out.clear();
+  store.getStandard2ndDerivative("DEFAULT", dir)(inp, out, "RGN_ALL");
+  EXPECT_EQ(out.size(), 5);
+}
+
+TEST_F(DerivativeStoreTest, GetDefaultFlowDerivative) {
+  const DERIV type = DERIV::Flux;
+  const DIRECTION dir = DIRECTION::Y;
+
+  // Default method registered after it is chosen
+  store.forceDefaultMethod("FIRST", type, dir, STAGGER::C2L);
+  store.registerDerivative(flowReturnSixSetToTwo, type, dir, STAGGER::C2L, "FIRST");
+
+  FieldType inp, out;
+  store.getFluxDerivative("DEFAULT", dir, STAGGER::C2L)(inp, inp, out, "RGN_ALL");
+  EXPECT_EQ(out.size(), 6);
+}
+
+TEST_F(DerivativeStoreTest, GetDefaultAfterReset) {
+  const DERIV type = DERIV::Standard;
+  const DIRECTION dir = DIRECTION::X;
+
+  store.forceDefaultMethod("FIRST", type, dir, STAGGER::None);
+  store.registerDerivative(standardReturnTenSetToOne, type, dir, STAGGER::None, "FIRST");
+  store.reset();
+
+  EXPECT_THROW(store.getStandardDerivative("DEFAULT", dir), BoutException);
+}
+
+TEST_F(DerivativeStoreTest, RegisterAndGetKernel) {
+  const DIRECTION dir = DIRECTION::Z;
+
+  store.registerKernel(kernelType{kernelReturnCentre, nullptr, 1},
+                       DERIV::StandardSecond, dir, STAGGER::None, "FIRST");
+  store.registerKernel(kernelType{nullptr, kernelReturnVelocity, 2}, DERIV::Upwind,
+                       dir, STAGGER::None, "FIRST");
+
+  stencil s;
+  s.c = 3.0;
+
+  const auto* kernel = store.getKernel("FIRST", dir, STAGGER::None, DERIV::StandardSecond);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(kernel->nGuards, 1);
+  EXPECT_EQ(kernel->upwind, nullptr);
+  EXPECT_EQ(kernel->standard(s), 3.0);
+
+  kernel = store.getKernel("FIRST", dir, STAGGER::None, DERIV::Upwind);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(kernel->nGuards, 2);
+  EXPECT_EQ(kernel->standard, nullptr);
+  EXPECT_EQ(kernel->upwind(4.0, s), 4.0);
+}
+
+TEST_F(DerivativeStoreTest, GetDefaultKernel) {
+  const DERIV type = DERIV::Standard;
+  const DIRECTION dir = DIRECTION::X;
+
+  store.forceDefaultMethod("FIRST", type, dir, STAGGER::None);
+  store.registerKernel(kernelType{kernelReturnCentre, nullptr, 1}, type, dir,
+                       STAGGER::None, "FIRST");
+
+  EXPECT_NE(store.getKernel("DEFAULT", dir), nullptr);
+}
+
+TEST_F(DerivativeStoreTest, GetMissingKernel) {
+  const DERIV type = DERIV::Standard;
+  const DIRECTION dir = DIRECTION::X;
+
+  // Registered method but no kernel
+  store.registerDerivative(standardReturnTenSetToOne, type, dir, STAGGER::None, "FIRST");
+  EXPECT_EQ(store.getKernel("FIRST", dir), nullptr);
+
+  store.registerKernel(kernelType{kernelReturnCentre, nullptr, 1}, type, dir,
+                       STAGGER::None, "FIRST");
+  EXPECT_EQ(store.getKernel("FIRST", dir, STAGGER::C2L), nullptr);
+  EXPECT_EQ(store.getKernel("FIRST", dir, STAGGER::None, DERIV::StandardFourth), nullptr);
+
+  store.reset();
+  EXPECT_EQ(store.getKernel("FIRST", dir), nullptr);
+}
+
+TEST_F(DerivativeStoreTest, RegisterKernelTwice) {
+  store.registerKernel(kernelType{kernelReturnCentre, nullptr, 1}, DERIV::Standard,
+                       DIRECTION::X, STAGGER::None, "FIRST");
+  EXPECT_THROW(store.registerKernel(kernelType{kernelReturnCentre, nullptr, 1},
+                                    DERIV::Standard, DIRECTION::X, STAGGER::None,
+                                    "FIRST"),
+               BoutException);
+}
+
+TEST_F(DerivativeStoreTest, RegisterFluxKernel) {
+  EXPECT_THROW(store.registerKernel(kernelType{nullptr, kernelReturnVelocity, 1},
+                                    DERIV::Flux, DIRECTION::X, STAGGER::None, "FIRST"),
+               BoutException);
+}
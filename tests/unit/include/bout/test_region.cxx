@@ -170,6 +170,68 @@ TEST_F(RegionTest, contiguousBlockSize) {
   }
 }
 
+TEST_F(RegionTest, blocksFromRangeMatchIndices) {
+  // Boxes which are contiguous or not in y and z
+  const std::vector<std::vector<int>> ranges = {{0, nx - 1, 0, ny - 1, 0, nz - 1},
+                                                {1, nx - 2, 0, ny - 1, 0, nz - 1},
+                                                {0, nx - 1, 1, ny - 2, 0, nz - 1},
+                                                {0, nx - 1, 0, ny - 1, 1, nz - 2},
+                                                {1, nx - 2, 1, ny - 2, 1, nz - 2}};
+
+  for (const auto& r : ranges) {
+    for (int blocksize : {1, 3, 8, 64}) {
+      Region<Ind3D>::RegionIndices indices;
+      for (int x = r[0]; x <= r[1]; ++x) {
+        for (int y = r[2]; y <= r[3]; ++y) {
+          for (int z = r[4]; z <= r[5]; ++z) {
+            indices.push_back({(x * ny + y) * nz + z, ny, nz});
+          }
+        }
+      }
+
+      Region<Ind3D> fromRange(r[0], r[1], r[2], r[3], r[4], r[5], ny, nz, blocksize);
+      Region<Ind3D> fromIndices(indices, blocksize);
+
+      EXPECT_EQ(fromRange.size(), indices.size());
+
+      const auto& rangeBlocks = fromRange.getBlocks();
+      const auto& indicesBlocks = fromIndices.getBlocks();
+      ASSERT_EQ(rangeBlocks.size(), indicesBlocks.size());
+      for (unsigned int i = 0; i < rangeBlocks.size(); ++i) {
+        EXPECT_EQ(rangeBlocks[i].first, indicesBlocks[i].first);
+        EXPECT_EQ(rangeBlocks[i].second, indicesBlocks[i].second);
+      }
+
+      EXPECT_EQ(fromRange.getIndices(), indices);
+    }
+  }
+}
+
+TEST_F(RegionTest, regionAsTiled) {
+  Region<Ind3D> region(1, nx - 2, 0, ny - 1, 0, nz - 1, ny, nz, 4);
+  const int tile_y = 2;
+
+  auto tiled = region.asTiled(tile_y);
+
+  EXPECT_EQ(tiled.size(), region.size());
+
+  // The same points, ordered by tile, then x, then y and z
+  auto expected = region.getIndices();
+  std::stable_sort(std::begin(expected), std::end(expected),
+                   [tile_y](const Ind3D& a, const Ind3D& b) {
+                     return std::make_pair(a.y() / tile_y, a.x())
+                            < std::make_pair(b.y() / tile_y, b.x());
+                   });
+  EXPECT_EQ(tiled.getIndices(), expected);
+
+  // No block crosses into another tile or x
+  for (const auto& block : tiled.getBlocks()) {
+    const auto last = block.second - 1;
+    EXPECT_EQ(block.first.x(), last.x());
+    EXPECT_EQ(block.first.y() / tile_y, last.y() / tile_y);
+  }
+}
+
 TEST_F(RegionTest, defaultRegions) {
   const int nmesh = RegionTest::nx * RegionTest::ny * RegionTest::nz;
   EXPECT_EQ(mesh->getRegion("RGN_ALL").getIndices().size(), nmesh);
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+
+#include "bout/zpadded.hxx"
+
+#include <vector>
+
+TEST(ZPaddedLineTest, Load) {
+  const std::vector<BoutReal> line{0., 1., 2., 3., 4.};
+  bout::ZPaddedLine padded(5, 2);
+
+  const BoutReal* z = padded.load(line.data());
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_DOUBLE_EQ(z[i], line[i]);
+  }
+  EXPECT_DOUBLE_EQ(z[-2], 3.);
+  EXPECT_DOUBLE_EQ(z[-1], 4.);
+  EXPECT_DOUBLE_EQ(z[5], 0.);
+  EXPECT_DOUBLE_EQ(z[6], 1.);
+}
+
+TEST(ZPaddedLineTest, Reload) {
+  const std::vector<BoutReal> first{0., 1., 2., 3.};
+  const std::vector<BoutReal> second{10., 11., 12., 13.};
+  bout::ZPaddedLine padded(4, 1);
+
+  padded.load(first.data());
+  const BoutReal* z = padded.load(second.data());
+
+  EXPECT_DOUBLE_EQ(z[-1], 13.);
+  EXPECT_DOUBLE_EQ(z[0], 10.);
+  EXPECT_DOUBLE_EQ(z[3], 13.);
+  EXPECT_DOUBLE_EQ(z[4], 10.);
+}
+
+TEST(ZPaddedLineTest, FewerPointsThanGuards) {
+  const std::vector<BoutReal> line{5.};
+  bout::ZPaddedLine padded(1, 2);
+
+  const BoutReal* z = padded.load(line.data());
+
+  for (int i = -2; i <= 2; ++i) {
+    EXPECT_DOUBLE_EQ(z[i], 5.);
+  }
+}
@@ -107,3 +107,37 @@ TEST(CyclicReduction, SerialSolveDoubleMatrix) {
   EXPECT_NEAR(x(1, 3), 0.8, CyclicReduceTolerance);
   EXPECT_NEAR(x(1, 4), 6.6, CyclicReduceTolerance);
 }
+
+TEST(CyclicReduction, SerialSolveRepeated) {
+  using namespace bout::testing;
+  CyclicReduce<BoutReal> reduce{BoutComm::get(), reduction_size};
+
+  auto a = makeArrayFromVector({0., 1., 1., 1., 1.});
+  auto b = makeArrayFromVector({5., 4., 3., 2., 1.});
+  auto c = makeArrayFromVector({2., 2., 2., 2., 0.});
+
+  reduce.setCoefs(a, b, c);
+
+  Array<BoutReal> x{reduction_size};
+
+  // Second solve reuses the factorisation from the first
+  reduce.solve(makeArrayFromVector({5., 1., 0., 0., 0.}), x);
+  reduce.solve(makeArrayFromVector({0., 1., 2., 2., 3.}), x);
+
+  EXPECT_NEAR(x[0], -1., CyclicReduceTolerance);
+  EXPECT_NEAR(x[1], 2.5, CyclicReduceTolerance);
+  EXPECT_NEAR(x[2], -4., CyclicReduceTolerance);
+  EXPECT_NEAR(x[3], 5.75, CyclicReduceTolerance);
+  EXPECT_NEAR(x[4], -2.75, CyclicReduceTolerance);
+
+  // Changing the coefficients must not use the old factorisation
+  b[0] = 1.;
+  reduce.setCoefs(a, b, c);
+  reduce.solve(makeArrayFromVector({1., 1., 0., 0., 0.}), x);
+
+  EXPECT_NEAR(x[0], 1., CyclicReduceTolerance);
+  EXPECT_NEAR(x[1], 0., CyclicReduceTolerance);
+  EXPECT_NEAR(x[2], 0., CyclicReduceTolerance);
+  EXPECT_NEAR(x[3], 0., CyclicReduceTolerance);
+  EXPECT_NEAR(x[4], 0., CyclicReduceTolerance);
+}
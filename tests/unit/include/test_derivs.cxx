@@ -4,6 +4,7 @@
 #include "fft.hxx"
 #include "field3d.hxx"
 #include "test_extras.hxx"
+#include "bout/check_data.hxx"
 #include "bout/constants.hxx"
 #include "bout/deriv_store.hxx"
 #include "bout/index_derivs_interface.hxx"
@@ -340,6 +341,25 @@ TEST_P(FirstDerivativesInterfaceTest, Sanity) {
   EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOBNDRY", derivatives_tolerance));
 }
 
+TEST_P(FirstDerivativesInterfaceTest, InteriorThenShell) {
+  Field3D result{mesh};
+  switch (std::get<0>(GetParam())) {
+    case DIRECTION::X:
+      bout::derivatives::index::DDX(input, result, "DEFAULT", "RGN_INTERIOR");
+      bout::derivatives::index::DDX(input, result, "DEFAULT", "RGN_SHELL");
+      break;
+    case DIRECTION::Z:
+      bout::derivatives::index::DDZ(input, result, "DEFAULT", "RGN_INTERIOR");
+      bout::derivatives::index::DDZ(input, result, "DEFAULT", "RGN_SHELL");
+      break;
+  default:
+    // No versions of Y derivatives which calculate on part of the domain
+    return;
+  }
+
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOBNDRY", derivatives_tolerance));
+}
+
 using SecondDerivativesInterfaceTest = DerivativesTest;
 
 INSTANTIATE_TEST_SUITE_P(X, SecondDerivativesInterfaceTest,
@@ -451,6 +471,26 @@ TEST_P(UpwindDerivativesInterfaceTest, Sanity) {
   EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOBNDRY", derivatives_tolerance));
 }
 
+TEST_P(UpwindDerivativesInterfaceTest, InteriorThenShell) {
+  Field3D result{mesh};
+
+  switch (std::get<0>(GetParam())) {
+  case DIRECTION::X:
+    bout::derivatives::index::VDDX(velocity, input, result, "DEFAULT", "RGN_INTERIOR");
+    bout::derivatives::index::VDDX(velocity, input, result, "DEFAULT", "RGN_SHELL");
+    break;
+  case DIRECTION::Z:
+    bout::derivatives::index::VDDZ(velocity, input, result, "DEFAULT", "RGN_INTERIOR");
+    bout::derivatives::index::VDDZ(velocity, input, result, "DEFAULT", "RGN_SHELL");
+    break;
+  default:
+    // No versions of Y derivatives which calculate on part of the domain
+    return;
+  }
+
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOBNDRY", derivatives_tolerance));
+}
+
 using FluxDerivativesInterfaceTest = DerivativesTest;
 
 // Instantiate the test for X, Y, Z for flux derivatives
@@ -488,3 +528,136 @@ TEST_P(FluxDerivativesInterfaceTest, Sanity) {
 
   EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOBNDRY", derivatives_tolerance));
 }
+
+/////////////////////////////////////////////////////////////////////
+// Calculating several derivatives in one pass should give the same
+// answers as calculating them separately
+
+using MultipleDerivativesTest = DerivativesTest;
+
+INSTANTIATE_TEST_SUITE_P(X, MultipleDerivativesTest,
+                        ::testing::Values(std::make_tuple(DIRECTION::X, DERIV::Standard,
+                                                          std::string{"DEFAULT"})),
+                        methodDirectionTupleToString);
+
+INSTANTIATE_TEST_SUITE_P(Y, MultipleDerivativesTest,
+                        ::testing::Values(std::make_tuple(DIRECTION::Y, DERIV::Standard,
+                                                          std::string{"DEFAULT"})),
+                        methodDirectionTupleToString);
+
+INSTANTIATE_TEST_SUITE_P(Z, MultipleDerivativesTest,
+                        ::testing::Values(std::make_tuple(DIRECTION::Z, DERIV::Standard,
+                                                          std::string{"DEFAULT"})),
+                        methodDirectionTupleToString);
+
+TEST_P(MultipleDerivativesTest, SameAsSeparate) {
+  using namespace bout::derivatives::index;
+
+  const std::vector<DERIV> types{DERIV::Standard, DERIV::StandardSecond,
+                                 DERIV::StandardFourth, DERIV::Upwind};
+
+  std::vector<Field3D> result;
+  std::vector<Field3D> separate;
+
+  switch (std::get<0>(GetParam())) {
+  case DIRECTION::X:
+    result = multiple<Field3D, DIRECTION::X>(velocity, input, types);
+    separate = {DDX(input), D2DX2(input), D4DX4(input), VDDX(velocity, input)};
+    break;
+  case DIRECTION::Y:
+    // input has parallel slices, so DDY etc. use YOrthogonal
+    result = multiple<Field3D, DIRECTION::YOrthogonal>(velocity, input, types);
+    separate = {DDY(input), D2DY2(input), D4DY4(input), VDDY(velocity, input)};
+    break;
+  case DIRECTION::Z:
+    result = multiple<Field3D, DIRECTION::Z>(velocity, input, types);
+    separate = {DDZ(input), D2DZ2(input), D4DZ4(input), VDDZ(velocity, input)};
+    break;
+  default:
+    break;
+  }
+
+  ASSERT_EQ(result.size(), types.size());
+  for (std::size_t k = 0; k < types.size(); ++k) {
+    EXPECT_TRUE(IsFieldEqual(result[k], separate[k], "RGN_NOBNDRY"));
+  }
+  EXPECT_TRUE(IsFieldEqual(result[0], expected, "RGN_NOBNDRY", derivatives_tolerance));
+}
+
+TEST_P(MultipleDerivativesTest, MultipleFields) {
+  using namespace bout::derivatives::index;
+
+  // Something other than velocity, which is constant
+  const Field3D input_squared = input * input;
+
+  std::vector<Field3D> result;
+  std::vector<Field3D> separate;
+
+  switch (std::get<0>(GetParam())) {
+  case DIRECTION::X:
+    result = multipleFields<Field3D, DIRECTION::X, DERIV::StandardSecond>(
+        {&input, &input_squared});
+    separate = {D2DX2(input), D2DX2(input_squared)};
+    break;
+  case DIRECTION::Z:
+    result = multipleFields<Field3D, DIRECTION::Z, DERIV::StandardSecond>(
+        {&input, &input_squared});
+    separate = {D2DZ2(input), D2DZ2(input_squared)};
+    break;
+  default:
+    // Y would need parallel slices of input_squared
+    return;
+  }
+
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_TRUE(IsFieldEqual(result[0], separate[0], "RGN_NOBNDRY"));
+  EXPECT_TRUE(IsFieldEqual(result[1], separate[1], "RGN_NOBNDRY"));
+}
+
+TEST_P(MultipleDerivativesTest, NotStencilBased) {
+  using namespace bout::derivatives::index;
+
+  if (std::get<0>(GetParam()) != DIRECTION::Z) {
+    return;
+  }
+
+  // FFT methods have no stencil kernel, so are calculated separately
+  const auto result = multiple<Field3D, DIRECTION::Z>(
+      input, {DERIV::Standard, DERIV::StandardSecond}, "FFT");
+
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_TRUE(IsFieldEqual(result[0], DDZ(input, CELL_DEFAULT, "FFT"), "RGN_NOBNDRY"));
+  EXPECT_TRUE(
+      IsFieldEqual(result[1], D2DZ2(input, CELL_DEFAULT, "FFT"), "RGN_NOBNDRY"));
+}
+
+TEST_P(MultipleDerivativesTest, ChecksOnlyRegion) {
+  using namespace bout::derivatives::index;
+
+  if (std::get<0>(GetParam()) != DIRECTION::Z) {
+    return;
+  }
+
+  // Away from the region, and from the stencils of its points
+  Field3D bad_input = input;
+  bad_input(0, 0, mesh->LocalNz / 2) = std::nan("");
+  mesh->addRegion3D("RGN_LOW_Z", Region<Ind3D>(0, mesh->LocalNx - 1, 0,
+                                               mesh->LocalNy - 1, 0, 9, mesh->LocalNy,
+                                               mesh->LocalNz));
+
+  const auto original_mode = bout::checks::getFiniteMode();
+  bout::checks::setFiniteMode(CHECK_FINITE::all);
+
+  EXPECT_NO_THROW((multiple<Field3D, DIRECTION::Z>(
+      bad_input, {DERIV::Standard, DERIV::StandardSecond}, "DEFAULT", "RGN_LOW_Z")));
+  EXPECT_NO_THROW((multipleFields<Field3D, DIRECTION::Z, DERIV::Standard>(
+      {&bad_input, &input}, "DEFAULT", "RGN_LOW_Z")));
+
+  bout::checks::setFiniteMode(original_mode);
+}
+
+TEST_P(MultipleDerivativesTest, UpwindNeedsVelocity) {
+  EXPECT_THROW((bout::derivatives::index::multiple<Field3D, DIRECTION::X>(
+                   input, {DERIV::Standard, DERIV::Upwind})),
+               BoutException);
+}
@@ -109,4 +109,77 @@ TEST_P(FFTTest, RoundTrip) {
     EXPECT_NEAR(output[i], real_signal[i], FFTTolerance);
   }
 }
+
+TEST_P(FFTTest, rfftMany) {
+
+  constexpr int howmany = 3;
+
+  // Stack scaled copies of the signal one after another
+  Array<BoutReal> input{howmany * size};
+  for (int n = 0; n < howmany; ++n) {
+    for (int i = 0; i < size; ++i) {
+      input[n * size + i] = (n + 1) * real_signal[i];
+    }
+  }
+
+  Array<dcomplex> output{howmany * nmodes};
+  rfft_many(input.begin(), howmany, size, output.begin());
+
+  for (int n = 0; n < howmany; ++n) {
+    for (int i = 0; i < nmodes; ++i) {
+      EXPECT_NEAR(real(output[n * nmodes + i]), (n + 1) * real(fft_signal[i]),
+                  FFTTolerance);
+      EXPECT_NEAR(imag(output[n * nmodes + i]), (n + 1) * imag(fft_signal[i]),
+                  FFTTolerance);
+    }
+  }
+}
+
+TEST_P(FFTTest, irfftMany) {
+
+  constexpr int howmany = 3;
+
+  Array<dcomplex> input{howmany * nmodes};
+  for (int n = 0; n < howmany; ++n) {
+    for (int i = 0; i < nmodes; ++i) {
+      input[n * nmodes + i] = static_cast<BoutReal>(n + 1) * fft_signal[i];
+    }
+  }
+
+  Array<BoutReal> output{howmany * size};
+  irfft_many(input.begin(), howmany, size, output.begin());
+
+  for (int n = 0; n < howmany; ++n) {
+    for (int i = 0; i < size; ++i) {
+      EXPECT_NEAR(output[n * size + i], (n + 1) * real_signal[i], FFTTolerance);
+    }
+  }
+
+  // Input should not have been modified
+  for (int i = 0; i < nmodes; ++i) {
+    EXPECT_NEAR(real(input[i]), real(fft_signal[i]), FFTTolerance);
+    EXPECT_NEAR(imag(input[i]), imag(fft_signal[i]), FFTTolerance);
+  }
+}
+
+TEST_P(FFTTest, RoundTripManyUnaligned) {
+
+  constexpr int howmany = 2;
+
+  // Offset by one element, so arrays aren't aligned as FFTW expects
+  Array<BoutReal> input{howmany * size + 1};
+  for (int n = 0; n < howmany; ++n) {
+    std::copy(real_signal.begin(), real_signal.end(), input.begin() + 1 + n * size);
+  }
+
+  Array<dcomplex> spectrum{howmany * nmodes + 1};
+  Array<BoutReal> output{howmany * size + 1};
+
+  rfft_many(input.begin() + 1, howmany, size, spectrum.begin() + 1);
+  irfft_many(spectrum.begin() + 1, howmany, size, output.begin() + 1);
+
+  for (int i = 0; i < howmany * size; ++i) {
+    EXPECT_NEAR(output[i + 1], input[i + 1], FFTTolerance);
+  }
+}
 #endif
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+
+#include "../src/invert/laplace/impls/cyclic/cyclic_laplace.hxx"
+#include "bout/constants.hxx"
+#include "bout/mesh.hxx"
+#include "field2d.hxx"
+#include "field3d.hxx"
+#include "options.hxx"
+#include "test_extras.hxx"
+
+#include <cmath>
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+
+#ifdef BOUT_HAS_FFTW
+class LaplaceCyclicTest : public FakeMeshFixture {
+public:
+  LaplaceCyclicTest() {
+    // Not set by FakeMesh, but used in the tridiagonal coefficients
+    mesh->getCoordinates()->G1 = 0.0;
+    mesh->getCoordinates()->G3 = 0.0;
+
+    options["cache_coefs"] = true;
+    uncached_options["cache_coefs"] = false;
+
+    acoef = makeField<Field2D>([](Ind2D& i) { return 1.0 + 0.1 * i.x() + 0.2 * i.y(); },
+                               mesh);
+    rhs1 = makeField<Field3D>(
+        [](Ind3D& i) { return std::sin(i.x() + 2. * i.y()) + std::cos(TWOPI * i.z() / nz); },
+        mesh);
+    rhs2 = makeField<Field3D>([](Ind3D& i) { return i.x() - 0.5 * i.y() + 0.1 * i.z(); },
+                              mesh);
+  }
+
+  Options options, uncached_options;
+  Field2D acoef;
+  Field3D rhs1, rhs2;
+};
+
+TEST_F(LaplaceCyclicTest, CachedSolveMatchesUncached) {
+  WithQuietOutput quiet_info{output_info};
+  LaplaceCyclic cached{&options};
+  LaplaceCyclic uncached{&uncached_options};
+
+  cached.setCoefA(acoef);
+  uncached.setCoefA(acoef);
+
+  const Field3D first = cached.solve(rhs1);
+  EXPECT_TRUE(IsFieldEqual(first, uncached.solve(rhs1), "RGN_NOY", 1e-10));
+
+  // Same coefficients, so the second solve reuses the matrix
+  cached.setCoefA(acoef);
+  EXPECT_TRUE(IsFieldEqual(cached.solve(rhs2), uncached.solve(rhs2), "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(cached.solve(rhs1), first, "RGN_NOY", 1e-10));
+}
+
+TEST_F(LaplaceCyclicTest, ChangedCoefficients) {
+  WithQuietOutput quiet_info{output_info};
+  LaplaceCyclic cached{&options};
+  LaplaceCyclic uncached{&uncached_options};
+
+  cached.setCoefA(acoef);
+  const Field3D first = cached.solve(rhs1);
+
+  cached.setCoefA(2. * acoef);
+  uncached.setCoefA(2. * acoef);
+  const Field3D second = cached.solve(rhs1);
+
+  EXPECT_FALSE(IsFieldEqual(second, first, "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(second, uncached.solve(rhs1), "RGN_NOY", 1e-10));
+}
+
+TEST_F(LaplaceCyclicTest, ChangedFlags) {
+  WithQuietOutput quiet_info{output_info};
+  LaplaceCyclic cached{&options};
+  LaplaceCyclic uncached{&uncached_options};
+
+  cached.setCoefA(acoef);
+  uncached.setCoefA(acoef);
+  cached.solve(rhs1);
+
+  cached.setInnerBoundaryFlags(INVERT_AC_GRAD);
+  uncached.setInnerBoundaryFlags(INVERT_AC_GRAD);
+
+  EXPECT_TRUE(IsFieldEqual(cached.solve(rhs1), uncached.solve(rhs1), "RGN_NOY", 1e-10));
+}
+
+TEST_F(LaplaceCyclicTest, ChangedMetric) {
+  WithQuietOutput quiet_info{output_info};
+  WithQuietOutput quiet_progress{output_progress};
+  LaplaceCyclic cached{&options};
+
+  cached.setCoefA(acoef);
+  const Field3D first = cached.solve(rhs1);
+
+  auto* coords = mesh->getCoordinates();
+  coords->g11 = 2.0;
+  coords->geometry(false);
+  coords->G1 = 0.0;
+  coords->G3 = 0.0;
+
+  LaplaceCyclic uncached{&uncached_options};
+  uncached.setCoefA(acoef);
+  const Field3D second = cached.solve(rhs1);
+
+  EXPECT_FALSE(IsFieldEqual(second, first, "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(second, uncached.solve(rhs1), "RGN_NOY", 1e-10));
+}
+
+TEST_F(LaplaceCyclicTest, SeveralRightHandSides) {
+  WithQuietOutput quiet_info{output_info};
+  LaplaceCyclic solver{&options};
+  LaplaceCyclic single{&uncached_options};
+
+  solver.setCoefA(acoef);
+  single.setCoefA(acoef);
+
+  const auto result = solver.solve(std::vector<Field3D>{rhs1, rhs2, rhs1});
+
+  ASSERT_EQ(result.size(), 3);
+  EXPECT_TRUE(IsFieldEqual(result[0], single.solve(rhs1), "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(result[1], single.solve(rhs2), "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(result[2], result[0], "RGN_NOY", 1e-10));
+
+  // Reuses the matrix for all three
+  const auto second = solver.solve(std::vector<Field3D>{rhs2, rhs1, rhs2});
+  EXPECT_TRUE(IsFieldEqual(second[0], result[1], "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(second[1], result[0], "RGN_NOY", 1e-10));
+
+  EXPECT_THROW(solver.solve(std::vector<Field3D>{rhs1}, std::vector<Field3D>{}),
+               BoutException);
+}
+
+TEST_F(LaplaceCyclicTest, AlternateSingleAndSeveral) {
+  WithQuietOutput quiet_info{output_info};
+  LaplaceCyclic solver{&options};
+  LaplaceCyclic single{&uncached_options};
+
+  solver.setCoefA(acoef);
+  single.setCoefA(acoef);
+  const Field3D expected1 = single.solve(rhs1);
+  const Field3D expected2 = single.solve(rhs2);
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(IsFieldEqual(solver.solve(rhs1), expected1, "RGN_NOY", 1e-10));
+    const auto result = solver.solve(std::vector<Field3D>{rhs2, rhs1});
+    EXPECT_TRUE(IsFieldEqual(result[0], expected2, "RGN_NOY", 1e-10));
+    EXPECT_TRUE(IsFieldEqual(result[1], expected1, "RGN_NOY", 1e-10));
+  }
+
+  // A new matrix replaces the solvers for both numbers of right hand sides
+  solver.setCoefA(2. * acoef);
+  single.setCoefA(2. * acoef);
+  const auto result = solver.solve(std::vector<Field3D>{rhs2, rhs1});
+  EXPECT_TRUE(IsFieldEqual(result[1], single.solve(rhs1), "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(solver.solve(rhs2), single.solve(rhs2), "RGN_NOY", 1e-10));
+}
+#endif
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+
+#include "../src/invert/laplace/impls/serial_tri/serial_tri.hxx"
+#include "bout/constants.hxx"
+#include "bout/mesh.hxx"
+#include "field2d.hxx"
+#include "field3d.hxx"
+#include "options.hxx"
+#include "test_extras.hxx"
+
+#include <cmath>
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+
+#if defined(BOUT_HAS_FFTW) && defined(BOUT_HAS_LAPACK)
+class LaplaceSerialTriTest : public FakeMeshFixture {
+public:
+  LaplaceSerialTriTest() {
+    // Not set by FakeMesh, but used in the tridiagonal coefficients
+    mesh->getCoordinates()->G1 = 0.0;
+    mesh->getCoordinates()->G3 = 0.0;
+
+    acoef = makeField<Field2D>([](Ind2D& i) { return 1.0 + 0.1 * i.x() + 0.2 * i.y(); },
+                               mesh);
+    rhs1 = makeField<Field3D>(
+        [](Ind3D& i) { return std::sin(i.x() + 2. * i.y()) + std::cos(TWOPI * i.z() / nz); },
+        mesh);
+    rhs2 = makeField<Field3D>([](Ind3D& i) { return i.x() - 0.5 * i.y() + 0.1 * i.z(); },
+                              mesh);
+  }
+
+  Options options;
+  Field2D acoef;
+  Field3D rhs1, rhs2;
+};
+
+TEST_F(LaplaceSerialTriTest, SeveralRightHandSides) {
+  WithQuietOutput quiet_info{output_info};
+  LaplaceSerialTri solver{&options};
+  solver.setCoefA(acoef);
+
+  const auto result = solver.solve(std::vector<Field3D>{rhs1, rhs2});
+
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_TRUE(IsFieldEqual(result[0], solver.solve(rhs1), "RGN_NOY", 1e-10));
+  EXPECT_TRUE(IsFieldEqual(result[1], solver.solve(rhs2), "RGN_NOY", 1e-10));
+}
+#endif
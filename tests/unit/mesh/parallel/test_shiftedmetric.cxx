@@ -84,6 +84,149 @@ public:
     mesh = nullptr;
   }
 
+  // We don't shift in the guard cells, and the parallel slices are
+  // stored offset in y, therefore we need to make new regions that we
+  // can compare the expected and actual outputs over
+  void addSliceRegions() {
+    WithQuietOutput quiet_info{output_info};
+    mesh->addRegion3D("RGN_YUP",
+                      Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart + 1,
+                                    mesh->yend + 1, 0, mesh->LocalNz - 1, mesh->LocalNy,
+                                    mesh->LocalNz));
+    mesh->addRegion3D("RGN_YUP2",
+                      Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart + 2,
+                                    mesh->yend + 2, 0, mesh->LocalNz - 1, mesh->LocalNy,
+                                    mesh->LocalNz));
+
+    mesh->addRegion3D("RGN_YDOWN",
+                      Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart - 1,
+                                    mesh->yend - 1, 0, mesh->LocalNz - 1, mesh->LocalNy,
+                                    mesh->LocalNz));
+    mesh->addRegion3D("RGN_YDOWN2",
+                      Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart - 2,
+                                    mesh->yend - 2, 0, mesh->LocalNz - 1, mesh->LocalNy,
+                                    mesh->LocalNz));
+  }
+
+  /// Check the parallel slices of \p actual are those of the input
+  /// field, multiplied by \p scale
+  void expectInputSlices(const Field3D& actual, BoutReal scale = 1.0) {
+    // Expected output values
+    Field3D expected_up_1{mesh};
+
+    // Note: here zeroes are for values we don't expect to read
+    fillField(expected_up_1, {{{0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {2., 4., 3., 5., 1.},
+                               {2., 3., 5., 4., 1.},
+                               {2., 3., 4., 5., 1.},
+                               {0., 0., 0., 0., 0.}},
+
+                              {{0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {3., 5., 4., 1., 2.},
+                               {3., 4., 5., 1., 2.},
+                               {3., 4., 5., 2., 1.},
+                               {0., 0., 0., 0., 0.}},
+
+                              {{0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {4., 5., 1., 2., 3.},
+                               {4., 5., 2., 1., 3.},
+                               {4., 5., 1., 3., 2.},
+                               {0., 0., 0., 0., 0.}}});
+
+    Field3D expected_up_2{mesh};
+
+    fillField(expected_up_2, {{{0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {3., 5., 4., 1., 2.},
+                               {3., 4., 5., 1., 2.},
+                               {3., 4., 5., 2., 1.}},
+
+                              {{0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {5., 1., 2., 3., 4.},
+                               {5., 2., 1., 3., 4.},
+                               {5., 1., 3., 2., 4.}},
+
+                              {{0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {0., 0., 0., 0., 0.},
+                               {1., 3., 4., 5., 2.},
+                               {3., 2., 4., 5., 1.},
+                               {2., 4., 3., 5., 1.}}});
+
+    Field3D expected_down_1{mesh};
+
+    fillField(expected_down_1, {{{0., 0., 0., 0., 0.},
+                                 {5., 2., 1., 3., 4.},
+                                 {5., 1., 3., 2., 4.},
+                                 {5., 1., 2., 4., 3.},
+                                 {0., 0., 0., 0., 0.},
+                                 {0., 0., 0., 0., 0.},
+                                 {0., 0., 0., 0., 0.}},
+
+                                {{0., 0., 0., 0., 0.},
+                                 {4., 5., 1., 3., 2.},
+                                 {3., 5., 1., 2., 4.},
+                                 {5., 4., 1., 2., 3.},
+                                 {0., 0., 0., 0., 0.},
+                                 {0., 0., 0., 0., 0.},
+                                 {0., 0., 0., 0., 0.}},
+
+                                {{0., 0., 0., 0., 0.},
+                                 {4., 3., 5., 1., 2.},
+                                 {3., 5., 4., 1., 2.},
+                                 {3., 4., 5., 1., 2.},
+                                 {0., 0., 0., 0., 0.},
+                                 {0., 0., 0., 0., 0.},
+                                 {0., 0., 0., 0., 0.}}});
+
+    Field3D expected_down2{mesh};
+
+    fillField(expected_down2, {{{4., 5., 1., 2., 3.},
+                                {4., 5., 2., 1., 3.},
+                                {4., 5., 1., 3., 2.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.}},
+
+                               {{1., 3., 4., 5., 2.},
+                                {3., 2., 4., 5., 1.},
+                                {2., 4., 3., 5., 1.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.}},
+
+                               {{5., 1., 3., 2., 4.},
+                                {5., 1., 2., 4., 3.},
+                                {4., 1., 2., 3., 5.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.},
+                                {0., 0., 0., 0., 0.}}});
+
+    EXPECT_TRUE(
+        IsFieldEqual(actual.ynext(1), scale * expected_up_1, "RGN_YUP", FFTTolerance));
+    EXPECT_TRUE(
+        IsFieldEqual(actual.ynext(2), scale * expected_up_2, "RGN_YUP2", FFTTolerance));
+    EXPECT_TRUE(IsFieldEqual(actual.ynext(-1), scale * expected_down_1, "RGN_YDOWN",
+                             FFTTolerance));
+    EXPECT_TRUE(IsFieldEqual(actual.ynext(-2), scale * expected_down2, "RGN_YDOWN2",
+                             FFTTolerance));
+  }
+
   static constexpr int nx = 3;
   static constexpr int ny = 7;
   static constexpr int nz = 5;
@@ -289,137 +432,35 @@ TEST_F(ShiftedMetricTest, ToFromFieldAlignedFieldPerp) {
 }
 
 TEST_F(ShiftedMetricTest, CalcParallelSlices) {
-  // We don't shift in the guard cells, and the parallel slices are
-  // stored offset in y, therefore we need to make new regions that we
-  // can compare the expected and actual outputs over
-  output_info.disable();
-  mesh->addRegion3D("RGN_YUP",
-                    Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart + 1, mesh->yend + 1,
-                                  0, mesh->LocalNz - 1, mesh->LocalNy, mesh->LocalNz));
-  mesh->addRegion3D("RGN_YUP2",
-                    Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart + 2, mesh->yend + 2,
-                                  0, mesh->LocalNz - 1, mesh->LocalNy, mesh->LocalNz));
-
-  mesh->addRegion3D("RGN_YDOWN",
-                    Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart - 1, mesh->yend - 1,
-                                  0, mesh->LocalNz - 1, mesh->LocalNy, mesh->LocalNz));
-  mesh->addRegion3D("RGN_YDOWN2",
-                    Region<Ind3D>(0, mesh->LocalNx - 1, mesh->ystart - 2, mesh->yend - 2,
-                                  0, mesh->LocalNz - 1, mesh->LocalNy, mesh->LocalNz));
-  output_info.enable();
+  addSliceRegions();
 
   // Actual interesting bit here!
   input.getCoordinates()->getParallelTransform().calcParallelSlices(input);
-  // Expected output values
-
-  Field3D expected_up_1{mesh};
-
-  // Note: here zeroes are for values we don't expect to read
-  fillField(expected_up_1, {{{0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {2., 4., 3., 5., 1.},
-                             {2., 3., 5., 4., 1.},
-                             {2., 3., 4., 5., 1.},
-                             {0., 0., 0., 0., 0.}},
-
-                            {{0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {3., 5., 4., 1., 2.},
-                             {3., 4., 5., 1., 2.},
-                             {3., 4., 5., 2., 1.},
-                             {0., 0., 0., 0., 0.}},
-
-                            {{0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {4., 5., 1., 2., 3.},
-                             {4., 5., 2., 1., 3.},
-                             {4., 5., 1., 3., 2.},
-                             {0., 0., 0., 0., 0.}}});
-
-  Field3D expected_up_2{mesh};
-
-  fillField(expected_up_2, {{{0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {3., 5., 4., 1., 2.},
-                             {3., 4., 5., 1., 2.},
-                             {3., 4., 5., 2., 1.}},
-
-                            {{0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {5., 1., 2., 3., 4.},
-                             {5., 2., 1., 3., 4.},
-                             {5., 1., 3., 2., 4.}},
-
-                            {{0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {0., 0., 0., 0., 0.},
-                             {1., 3., 4., 5., 2.},
-                             {3., 2., 4., 5., 1.},
-                             {2., 4., 3., 5., 1.}}});
-
-  Field3D expected_down_1{mesh};
-
-  fillField(expected_down_1, {{{0., 0., 0., 0., 0.},
-                               {5., 2., 1., 3., 4.},
-                               {5., 1., 3., 2., 4.},
-                               {5., 1., 2., 4., 3.},
-                               {0., 0., 0., 0., 0.},
-                               {0., 0., 0., 0., 0.},
-                               {0., 0., 0., 0., 0.}},
 
-                              {{0., 0., 0., 0., 0.},
-                               {4., 5., 1., 3., 2.},
-                               {3., 5., 1., 2., 4.},
-                               {5., 4., 1., 2., 3.},
-                               {0., 0., 0., 0., 0.},
-                               {0., 0., 0., 0., 0.},
-                               {0., 0., 0., 0., 0.}},
+  expectInputSlices(input);
+}
 
-                              {{0., 0., 0., 0., 0.},
-                               {4., 3., 5., 1., 2.},
-                               {3., 5., 4., 1., 2.},
-                               {3., 4., 5., 1., 2.},
-                               {0., 0., 0., 0., 0.},
-                               {0., 0., 0., 0., 0.},
-                               {0., 0., 0., 0., 0.}}});
+TEST_F(ShiftedMetricTest, CalcParallelSlicesMany) {
+  addSliceRegions();
+
+  Field3D actual_1{copy(input)};
+  Field3D actual_2{2. * input};
+  input.getCoordinates()->getParallelTransform().calcParallelSlicesMany(
+      {&actual_1, &actual_2});
+
+  expectInputSlices(actual_1);
+  expectInputSlices(actual_2, 2.);
+}
+
+TEST_F(ShiftedMetricTest, CalcParallelSlicesCompactPhases) {
+  addSliceRegions();
+
+  ShiftedMetric compact{*mesh, CELL_CENTRE, zShift,
+                        mesh->getCoordinates()->zlength(), true};
+
+  Field3D actual{copy(input)};
+  compact.calcParallelSlices(actual);
 
-  Field3D expected_down2{mesh};
-
-  fillField(expected_down2, {{{4., 5., 1., 2., 3.},
-                              {4., 5., 2., 1., 3.},
-                              {4., 5., 1., 3., 2.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.}},
-
-                             {{1., 3., 4., 5., 2.},
-                              {3., 2., 4., 5., 1.},
-                              {2., 4., 3., 5., 1.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.}},
-
-                             {{5., 1., 3., 2., 4.},
-                              {5., 1., 2., 4., 3.},
-                              {4., 1., 2., 3., 5.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.},
-                              {0., 0., 0., 0., 0.}}});
-
-  EXPECT_TRUE(IsFieldEqual(input.ynext(1), expected_up_1, "RGN_YUP", FFTTolerance));
-  EXPECT_TRUE(IsFieldEqual(input.ynext(2), expected_up_2, "RGN_YUP2", FFTTolerance));
-  EXPECT_TRUE(IsFieldEqual(input.ynext(-1), expected_down_1, "RGN_YDOWN", FFTTolerance));
-  EXPECT_TRUE(IsFieldEqual(input.ynext(-2), expected_down2, "RGN_YDOWN2", FFTTolerance));
+  expectInputSlices(actual);
 }
 #endif
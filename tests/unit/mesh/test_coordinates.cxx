@@ -1,7 +1,9 @@
 #include "gtest/gtest.h"
 
+#include "bout/constants.hxx"
 #include "bout/coordinates.hxx"
 #include "bout/mesh.hxx"
+#include "invert_laplace.hxx"
 #include "output.hxx"
 
 #include "test_extras.hxx"
@@ -77,3 +79,31 @@ TEST_F(CoordinatesTest, CalcCovariant) {
   EXPECT_TRUE(IsFieldEqual(coords.g13, 0.0));
   EXPECT_TRUE(IsFieldEqual(coords.g23, 0.0));
 }
+
+#ifdef BOUT_HAS_FFTW
+TEST_F(CoordinatesTest, Delp2FFT) {
+  WithQuietOutput quiet_info{output_info};
+  auto* coords = mesh->getCoordinates();
+  coords->G1 = 0.0;
+  coords->G3 = 0.0;
+
+  // Single z mode, so the FFT Delp2 is exact
+  const BoutReal kwave = TWOPI / coords->zlength();
+  const Field3D f = makeField<Field3D>(
+      [&](Ind3D& i) { return std::cos(kwave * i.z() * coords->dz) + 2.0; }, mesh);
+  const Field3D expected = makeField<Field3D>(
+      [&](Ind3D& i) { return -SQ(kwave) * std::cos(kwave * i.z() * coords->dz); }, mesh);
+
+  const Field3D result = coords->Delp2(f);
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOBNDRY", 1e-12));
+
+  // Second call uses the cached coefficients
+  EXPECT_TRUE(IsFieldEqual(coords->Delp2(f), result, "RGN_NOBNDRY"));
+
+  const FieldPerp result_perp = coords->Delp2(sliceXZ(f, mesh->ystart));
+  EXPECT_TRUE(IsFieldEqual(result_perp, sliceXZ(expected, mesh->ystart), "RGN_NOX",
+                           1e-12));
+
+  Laplacian::cleanup();
+}
+#endif
@@ -6,6 +6,8 @@
 #include "output.hxx"
 #include "test_extras.hxx"
 
+#include <algorithm>
+
 ////// delete these
 #include "bout/constants.hxx"
 #include "bout/mesh.hxx"
@@ -426,3 +428,103 @@ TEST_F(Field2DInterpToTest, CellYlowToCentreNoBndry) {
   EXPECT_TRUE(output.getLocation() == CELL_CENTRE);
   EXPECT_NEAR(output(2, 2), 2.525, 1.e-15);
 }
+
+/// Test fixture for the HermiteSpline field line interpolation
+class HermiteSplineTest : public ::testing::Test {
+public:
+  HermiteSplineTest() {
+    WithQuietOutput quiet_info{output_info};
+    WithQuietOutput quiet_warn{output_warn};
+
+    delete mesh;
+    mesh = new FakeMesh(nx, ny, nz);
+    static_cast<FakeMesh*>(mesh)->setCoordinates(nullptr);
+    mesh->createDefaultRegions();
+
+    auto coords = std::make_shared<Coordinates>(
+        mesh, Field2D{1.0}, Field2D{1.0}, BoutReal{1.0}, Field2D{1.0}, Field2D{0.0},
+        Field2D{1.0}, Field2D{1.0}, Field2D{1.0}, Field2D{0.0}, Field2D{0.0},
+        Field2D{0.0}, Field2D{1.0}, Field2D{1.0}, Field2D{1.0}, Field2D{0.0},
+        Field2D{0.0}, Field2D{0.0}, Field2D{0.0}, Field2D{0.0}, false);
+    static_cast<FakeMesh*>(mesh)->setCoordinates(coords);
+    coords->setParallelTransform(
+        bout::utils::make_unique<ParallelTransformIdentity>(*mesh));
+
+    // Field line end points, offset from each grid point in x and z
+    delta_x = Field3D{mesh};
+    delta_z = Field3D{mesh};
+    delta_x.allocate();
+    delta_z.allocate();
+    BOUT_FOR(i, delta_x.getRegion("RGN_ALL")) {
+      delta_x[i] = i.x() + 0.5;
+      delta_z[i] = i.z() + 0.25;
+    }
+  }
+
+  ~HermiteSplineTest() override {
+    delete mesh;
+    mesh = nullptr;
+  }
+
+  static constexpr int nx = 6;
+  static constexpr int ny = 3;
+  static constexpr int nz = 4;
+
+  Field3D delta_x;
+  Field3D delta_z;
+};
+
+TEST_F(HermiteSplineTest, LinearInX) {
+  Field3D input{mesh};
+  input.allocate();
+  BOUT_FOR(i, input.getRegion("RGN_ALL")) { input[i] = 2.0 * i.x() + 1.0; }
+
+  HermiteSpline interp{0, mesh};
+  interp.calcWeights(delta_x, delta_z);
+  Field3D output = interp.interpolate(input);
+
+  BOUT_FOR(i, output.getRegion("RGN_NOBNDRY")) {
+    // End points beyond xend are moved back to xend
+    const BoutReal x = std::min(i.x() + 0.5, static_cast<BoutReal>(mesh->xend));
+    EXPECT_NEAR(output[i], 2.0 * x + 1.0, 1e-12);
+  }
+}
+
+TEST_F(HermiteSplineTest, InterpolateMany) {
+  Field3D first{mesh};
+  Field3D second{mesh};
+  first.allocate();
+  second.allocate();
+  BOUT_FOR(i, first.getRegion("RGN_ALL")) {
+    first[i] = i.x() + std::sin(TWOPI * i.z() / nz);
+    second[i] = i.x() * i.y() * std::cos(TWOPI * i.z() / nz);
+  }
+
+  HermiteSpline interp{0, mesh};
+  interp.calcWeights(delta_x, delta_z);
+
+  const auto outputs = interp.interpolateMany({&first, &second});
+  ASSERT_EQ(outputs.size(), 2u);
+
+  EXPECT_TRUE(IsFieldEqual(outputs[0], interp.interpolate(first), "RGN_NOBNDRY"));
+  EXPECT_TRUE(IsFieldEqual(outputs[1], interp.interpolate(second), "RGN_NOBNDRY"));
+}
+
+TEST_F(HermiteSplineTest, RecalculateWeights) {
+  Field3D input{mesh};
+  input.allocate();
+  BOUT_FOR(i, input.getRegion("RGN_ALL")) { input[i] = 2.0 * i.x() + 1.0; }
+
+  HermiteSpline interp{0, mesh};
+  interp.calcWeights(delta_x, delta_z);
+  interp.interpolate(input);
+
+  // New weights should be used in the next interpolation
+  interp.calcWeights(delta_x - 0.25, delta_z);
+  Field3D output = interp.interpolate(input);
+
+  BOUT_FOR(i, output.getRegion("RGN_NOBNDRY")) {
+    const BoutReal x = std::min(i.x() + 0.25, static_cast<BoutReal>(mesh->xend));
+    EXPECT_NEAR(output[i], 2.0 * x + 1.0, 1e-12);
+  }
+}
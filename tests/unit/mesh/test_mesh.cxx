@@ -55,6 +55,31 @@ TEST_F(MeshTest, GetRegionPerpFromMesh) {
   EXPECT_THROW(localmesh.getRegionPerp("SOME_MADE_UP_REGION_NAME"), BoutException);
 }
 
+TEST_F(MeshTest, InteriorAndShellRegions) {
+  FakeMesh mesh{8, 9, 3};
+  mesh.createDefaultRegions();
+
+  const auto& nobndry = mesh.getRegion3D("RGN_NOBNDRY");
+  const auto& interior = mesh.getRegion3D("RGN_INTERIOR");
+  const auto& shell = mesh.getRegion3D("RGN_SHELL");
+
+  EXPECT_EQ(interior.size(), 4u * 5u * 3u);
+  EXPECT_EQ(interior.size() + shell.size(), nobndry.size());
+  EXPECT_EQ((interior + shell).unique().size(), nobndry.size());
+
+  // Stencils of the guard cell width from interior points stay in RGN_NOBNDRY
+  for (const auto& i : interior) {
+    EXPECT_GE(i.x() - mesh.xstart, mesh.xstart);
+    EXPECT_LE(i.x() + mesh.xstart, mesh.xend);
+    EXPECT_GE(i.y() - mesh.ystart, mesh.ystart);
+    EXPECT_LE(i.y() + mesh.ystart, mesh.yend);
+  }
+
+  EXPECT_EQ(mesh.getRegion2D("RGN_INTERIOR").size()
+                + mesh.getRegion2D("RGN_SHELL").size(),
+            mesh.getRegion2D("RGN_NOBNDRY").size());
+}
+
 TEST_F(MeshTest, GetRegionTemplatedFromMesh) {
   using namespace ::testing;
   localmesh.createDefaultRegions();
@@ -34,6 +34,7 @@ public:
   bool init_called{false};
 
   void changeHasConstraints(bool new_value) { has_constraints = new_value; }
+  void changeCanUseFieldMajor(bool new_value) { canUseFieldMajor = new_value; }
 
   auto listField2DNames() -> std::vector<std::string> {
     std::vector<std::string> result{};
@@ -66,6 +67,12 @@ public:
   // Shims for protected functions
   auto getMaxTimestepShim() const -> BoutReal { return max_dt; }
   using Solver::getLocalN;
+  using Solver::getLocalNEvolving;
+  using Solver::getErrorWeights;
+  using Solver::load_vars;
+  using Solver::detachVars;
+  using Solver::save_derivs;
+  using Solver::save_vars;
   using Solver::hasPreconditioner;
   using Solver::runPreconditioner;
   using Solver::globalIndex;
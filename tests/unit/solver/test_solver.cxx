@@ -10,6 +10,7 @@
 #include "bout/sys/uuid.h"
 
 #include <algorithm>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -575,6 +576,199 @@ TEST_F(SolverTest, GetLocalN) {
   EXPECT_EQ(solver.getLocalN(), expected_total);
 }
 
+TEST_F(SolverTest, SaveLoadVars) {
+  static_cast<FakeMesh*>(bout::globals::mesh)->createBoundaryRegions();
+
+  Options options;
+  FakeSolver solver{&options};
+
+  Field2D field2d{}, loaded2d{};
+  Field3D field3d{}, loaded3d{};
+  solver.add(loaded2d, "field");
+  solver.add(loaded3d, "another_field");
+  solver.init(0, 0);
+
+  field2d = makeField<Field2D>([](Ind2D& i) { return 1.0 + i.ind; });
+  field3d = makeField<Field3D>([](Ind3D& i) { return 2.0 + i.ind; });
+  loaded2d = field2d;
+  loaded3d = field3d;
+
+  // Boundaries aren't evolved, so each point has one 2D and nz 3D values
+  const auto& region = bout::globals::mesh->getRegion2D("RGN_NOBNDRY");
+  std::vector<BoutReal> state(region.size() * (1 + nz));
+  solver.save_vars(state.data());
+
+  // Variables are interleaved, with the 2D variable first at each point
+  const auto first = *std::begin(region);
+  EXPECT_DOUBLE_EQ(state[0], field2d[first]);
+  for (int jz = 0; jz < nz; ++jz) {
+    EXPECT_DOUBLE_EQ(state[1 + jz], field3d(first.x(), first.y(), jz));
+  }
+
+  loaded2d = 0.0;
+  loaded3d = 0.0;
+  solver.load_vars(state.data());
+
+  EXPECT_TRUE(IsFieldEqual(loaded2d, field2d, "RGN_NOBNDRY"));
+  EXPECT_TRUE(IsFieldEqual(loaded3d, field3d, "RGN_NOBNDRY"));
+}
+
+TEST_F(SolverTest, SaveLoadVarsFieldMajor) {
+  static_cast<FakeMesh*>(bout::globals::mesh)->createBoundaryRegions();
+
+  Options options;
+  options["field_major"] = true;
+  FakeSolver solver{&options};
+  solver.changeCanUseFieldMajor(true);
+
+  Field2D field2d{}, loaded2d{};
+  Field3D field3d{}, loaded3d{};
+  solver.add(loaded2d, "field");
+  solver.add(loaded3d, "another_field");
+  solver.init(0, 0);
+
+  field2d = makeField<Field2D>([](Ind2D& i) { return 1.0 + i.ind; });
+  field3d = makeField<Field3D>([](Ind3D& i) { return 2.0 + i.ind; });
+  loaded2d = field2d;
+  loaded3d = field3d;
+
+  const auto& region = bout::globals::mesh->getRegion2D("RGN_NOBNDRY");
+  std::vector<BoutReal> state(region.size() * (1 + nz));
+  solver.save_vars(state.data());
+
+  // All of the 2D variable comes first, then the 3D variable
+  const auto first = *std::begin(region);
+  const auto n2d = static_cast<int>(region.size());
+  EXPECT_DOUBLE_EQ(state[0], field2d[first]);
+  for (int jz = 0; jz < nz; ++jz) {
+    EXPECT_DOUBLE_EQ(state[n2d + jz], field3d(first.x(), first.y(), jz));
+  }
+
+  loaded2d = 0.0;
+  loaded3d = 0.0;
+  solver.load_vars(state.data());
+
+  EXPECT_TRUE(IsFieldEqual(loaded2d, field2d, "RGN_NOBNDRY"));
+  EXPECT_TRUE(IsFieldEqual(loaded3d, field3d, "RGN_NOBNDRY"));
+}
+
+TEST_F(SolverTest, ZeroCopy) {
+  static_cast<FakeMesh*>(bout::globals::mesh)->createBoundaryRegions();
+
+  Options options;
+  options["zero_copy"] = true;
+  FakeSolver solver{&options};
+  solver.changeCanUseFieldMajor(true);
+
+  Field2D field2d{};
+  Field3D field3d{};
+  solver.add(field2d, "field");
+  solver.add(field3d, "another_field");
+  solver.init(0, 0);
+
+  // The state contains whole fields, including guard cells
+  const int n2D = nx * ny;
+  ASSERT_EQ(solver.getLocalN(), n2D * (1 + nz));
+
+  std::vector<BoutReal> state(solver.getLocalN());
+  solver.save_vars(state.data());
+  EXPECT_DOUBLE_EQ(state[0], 1.0);
+  EXPECT_DOUBLE_EQ(state[n2D], 3.0);
+
+  // The fields now use the state directly
+  solver.load_vars(state.data());
+  EXPECT_EQ(&field2d(0, 0), &state[0]);
+  EXPECT_EQ(&field3d(0, 0, 0), &state[n2D]);
+
+  state[n2D + 1] = 5.0;
+  EXPECT_DOUBLE_EQ(field3d(0, 0, 1), 5.0);
+
+  // Points which aren't evolved have zero time derivative
+  ddt(field2d) = 2.0;
+  ddt(field3d) = 4.0;
+  std::vector<BoutReal> derivs(solver.getLocalN());
+  solver.save_derivs(derivs.data());
+
+  const auto bulk = *std::begin(bout::globals::mesh->getRegion2D("RGN_NOBNDRY"));
+  EXPECT_DOUBLE_EQ(derivs[bulk.ind], 2.0);
+  EXPECT_DOUBLE_EQ(derivs[n2D + bulk.ind * nz], 4.0);
+  EXPECT_DOUBLE_EQ(derivs[0], 0.0);
+
+  // Only the evolved points are counted in error norms
+  const auto evolved =
+      static_cast<int>(bout::globals::mesh->getRegion2D("RGN_NOBNDRY").size());
+  EXPECT_EQ(solver.getLocalNEvolving(), evolved * (1 + nz));
+  const auto weights = solver.getErrorWeights();
+  ASSERT_EQ(weights.size(), solver.getLocalN());
+  EXPECT_DOUBLE_EQ(std::accumulate(std::begin(weights), std::end(weights), 0.0),
+                   evolved * (1 + nz));
+  EXPECT_DOUBLE_EQ(weights[bulk.ind], 1.0);
+  EXPECT_DOUBLE_EQ(weights[n2D + bulk.ind * nz], 1.0);
+  EXPECT_DOUBLE_EQ(weights[0], 0.0);
+  EXPECT_DOUBLE_EQ(derivs[n2D], 0.0);
+}
+
+TEST_F(SolverTest, ZeroCopyKeepsNames) {
+  static_cast<FakeMesh*>(bout::globals::mesh)->createBoundaryRegions();
+
+  Options options;
+  options["zero_copy"] = true;
+  FakeSolver solver{&options};
+  solver.changeCanUseFieldMajor(true);
+
+  Field2D field2d{};
+  Field3D field3d{};
+  solver.add(field2d, "field");
+  solver.add(field3d, "another_field");
+  solver.init(0, 0);
+
+  // The names the fields were given by add
+  const auto name2d = field2d.name;
+  const auto name3d = field3d.name;
+
+  std::vector<BoutReal> state(solver.getLocalN());
+  solver.save_vars(state.data());
+
+  solver.load_vars(state.data());
+  ASSERT_EQ(&field3d(0, 0, 0), &state[nx * ny]);
+  EXPECT_EQ(field2d.name, name2d);
+  EXPECT_EQ(field3d.name, name3d);
+
+  solver.detachVars();
+  EXPECT_NE(&field3d(0, 0, 0), &state[nx * ny]);
+  EXPECT_EQ(field2d.name, name2d);
+  EXPECT_EQ(field3d.name, name3d);
+}
+
+TEST_F(SolverTest, SaveVarsOtherMesh) {
+  static_cast<FakeMesh*>(bout::globals::mesh)->createBoundaryRegions();
+
+  Options options;
+  FakeSolver solver{&options};
+
+  Options::root()["input"]["transform_from_field_aligned"] = false;
+
+  FakeMesh localmesh{nx + 1, ny, nz + 2};
+  localmesh.createDefaultRegions();
+  localmesh.createBoundaryRegions();
+  localmesh.setCoordinates(nullptr);
+
+  Field3D field3d{&localmesh};
+  solver.add(field3d, "field");
+  solver.init(0, 0);
+
+  std::vector<BoutReal> state(solver.getLocalN());
+  EXPECT_THROW(solver.save_vars(state.data()), BoutException);
+}
+
+TEST_F(SolverTest, FieldMajorNotSupported) {
+  Options options;
+  options["field_major"] = true;
+  FakeSolver solver{&options};
+
+  EXPECT_THROW(solver.init(0, 0), BoutException);
+}
+
 TEST_F(SolverTest, HavePreconditioner) {
   PhysicsPrecon preconditioner = [](BoutReal time, BoutReal gamma,
                                     BoutReal delta) -> int {
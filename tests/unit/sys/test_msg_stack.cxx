@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <string>
+#include <thread>
 
 TEST(MsgStackTest, BasicTest) {
   MsgStack msg_stack;
@@ -162,4 +163,27 @@ TEST(MsgStackTest, DumpTest) {
   std::cout.rdbuf(sbuf);
 }
 
+TEST(MsgStackTest, DisableThisThread) {
+  MsgStack msg_stack;
+
+  msg_stack.push("First");
+
+  std::thread other([&msg_stack]() {
+    MsgStack::disableThisThread();
+    msg_stack.push("Second");
+    msg_stack.pop(0);
+    msg_stack.clear();
+  });
+  other.join();
+
+  auto dump = msg_stack.getDump();
+  auto expected_dump = "====== Back trace ======\n -> First\n";
+
+  EXPECT_EQ(dump, expected_dump);
+
+  // Still enabled on this thread
+  msg_stack.push("Second");
+  EXPECT_EQ(msg_stack.getDump(), "====== Back trace ======\n -> Second\n -> First\n");
+}
+
 #endif
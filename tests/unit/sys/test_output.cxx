@@ -4,6 +4,7 @@
 
 #include <cstdio>
 #include <string>
+#include <thread>
 
 // stdout redirection code from https://stackoverflow.com/a/4043813/2043465
 class OutputTest : public ::testing::Test {
@@ -294,3 +295,26 @@ TEST_F(OutputTest, DummyJustPrint) {
   EXPECT_EQ("", test_buffer.str());
   EXPECT_EQ("", buffer.str());
 }
+
+TEST_F(OutputTest, CollectFromThread) {
+  Output local_output;
+  ConditionalOutput local_warn{&local_output};
+
+  std::thread writer{[&local_output, &local_warn]() {
+    Output::collectThisThread();
+    local_output.write("%s%d\n", "Hello, world!", 4);
+    local_warn.write("Warning %d\n", 5);
+    local_output.print("To stdout only\n");
+  }};
+  writer.join();
+
+  // Nothing is written until the main thread asks
+  EXPECT_EQ(buffer.str(), "");
+
+  Output::writeCollected();
+  EXPECT_EQ(buffer.str(), "Hello, world!4\nWarning 5\nTo stdout only\n");
+
+  // Only written once
+  Output::writeCollected();
+  EXPECT_EQ(buffer.str(), "Hello, world!4\nWarning 5\nTo stdout only\n");
+}